@@ -0,0 +1,252 @@
+#include "KernelBench.h"
+
+#include <torpedo/bootstrap/DeviceBuilder.h>
+#include <torpedo/bootstrap/PhysicalDeviceSelector.h>
+#include <torpedo/bootstrap/ShaderModuleBuilder.h>
+
+#include <torpedo/foundation/GpuRadixSort.h>
+#include <torpedo/foundation/TwoWayBuffer.h>
+#include <torpedo/foundation/RingBuffer.h>
+
+#include <torpedo_volumetric_spirv.h>
+
+#include <plog/Log.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    // Makes all earlier device writes visible to all later device accesses
+    constexpr auto FULL_BARRIER = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryWrite,
+        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite };
+
+    // Same as GaussianEngine's, see GaussianEngine::createDevice
+    vk::PhysicalDeviceFeatures getFeatures() {
+        auto features = vk::PhysicalDeviceFeatures{};
+        features.shaderInt64 = true;
+        return features;
+    }
+
+    vk::PhysicalDeviceVulkan12Features getVulkan12Features() {
+        auto features = vk::PhysicalDeviceVulkan12Features{};
+        features.runtimeDescriptorArray = true;
+        features.shaderBufferInt64Atomics = true;
+        features.bufferDeviceAddress = true;
+        features.timelineSemaphore = true;
+        return features;
+    }
+
+    vk::PhysicalDeviceVulkan13Features getVulkan13Features() {
+        auto features = vk::PhysicalDeviceVulkan13Features{};
+        features.synchronization2 = true;
+        features.maintenance4 = true;
+        features.computeFullSubgroups = true;
+        return features;
+    }
+} // namespace
+
+tpd::PhysicalDeviceSelection tpd::bench::KernelBench::pickPhysicalDevice(
+    const std::vector<const char*>& deviceExtensions,
+    const vk::Instance instance,
+    [[maybe_unused]] const vk::SurfaceKHR surface) const
+{
+    return PhysicalDeviceSelector()
+        .features(getFeatures())
+        .featuresVulkan12(getVulkan12Features())
+        .featuresVulkan13(getVulkan13Features())
+        .select(instance, deviceExtensions);
+}
+
+vk::Device tpd::bench::KernelBench::createDevice(
+    const std::vector<const char*>& deviceExtensions,
+    const std::initializer_list<uint32_t> queueFamilyIndices) const
+{
+    auto deviceFeatures = vk::PhysicalDeviceFeatures2{};
+    deviceFeatures.features = getFeatures();
+
+    auto featuresVulkan12 = getVulkan12Features();
+    deviceFeatures.pNext = &featuresVulkan12;
+
+    auto featuresVulkan13 = getVulkan13Features();
+    featuresVulkan12.pNext = &featuresVulkan13;
+
+    return DeviceBuilder()
+        .deviceFeatures(&deviceFeatures)
+        .queueFamilyIndices(queueFamilyIndices)
+        .build(_physicalDevice, deviceExtensions);
+}
+
+void tpd::bench::KernelBench::onInitialized() {
+    _properties = _physicalDevice.getProperties();
+    _subgroupKernels = GpuRadixSort::subgroupSupported(_physicalDevice);
+
+    if (!TimestampProfiler::supported(_physicalDevice, _computeFamilyIndex)) [[unlikely]] {
+        throw std::runtime_error("KernelBench - The compute queue does NOT support timestamps, kernels cannot be timed");
+    }
+
+    _computeQueue = _device.getQueue(_computeFamilyIndex, 0);
+
+    const auto poolInfo = vk::CommandPoolCreateInfo{}
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(_computeFamilyIndex);
+    _commandPool = _device.createCommandPool(poolInfo);
+
+    const auto allocInfo = vk::CommandBufferAllocateInfo{}
+        .setCommandPool(_commandPool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(1);
+    _commandBuffer = _device.allocateCommandBuffers(allocInfo)[0];
+    _fence = _device.createFence(vk::FenceCreateInfo{});
+
+    PLOGI << "KernelBench - Subgroup kernels: " << (_subgroupKernels ? "enabled" : "disabled");
+}
+
+void tpd::bench::KernelBench::execute(const std::function<void(vk::CommandBuffer)>& record) const {
+    _commandBuffer.reset();
+    _commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    // Waiting for the fence on the host does not make what the previous submission wrote visible to this one
+    _commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(FULL_BARRIER));
+    record(_commandBuffer);
+    _commandBuffer.end();
+
+    const auto cmdInfo = vk::CommandBufferSubmitInfo{ _commandBuffer };
+    submit(_computeQueue, vk::SubmitInfo2{}.setCommandBufferInfos(cmdInfo), _fence);
+
+    // Kernels at the largest problem sizes take a while on software implementations, never time out
+    using limits = std::numeric_limits<uint64_t>;
+    [[maybe_unused]] const auto result = _device.waitForFences(_fence, vk::True, limits::max());
+    _device.resetFences(_fence);
+}
+
+tpd::TimestampProfiler::Stats tpd::bench::KernelBench::measure(
+    const uint32_t iterations,
+    const std::function<void(vk::CommandBuffer)>& setup,
+    const std::function<void(vk::CommandBuffer)>& kernel) const
+{
+    auto profiler = TimestampProfiler::Builder()
+        .stage("kernel")
+        .historySize(iterations)
+        .build(_physicalDevice, _device);
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        execute([&](const vk::CommandBuffer cmd) {
+            profiler.recordReset(cmd, 0);
+            setup(cmd);
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(FULL_BARRIER));
+            profiler.recordBegin(cmd, 0, 0);
+            kernel(cmd);
+            profiler.recordEnd(cmd, 0, 0);
+        });
+        profiler.collect(_device, 0); // the submission has completed, so the results are available
+    }
+
+    const auto stats = profiler.getStats(0);
+    profiler.destroy(_device);
+    return stats;
+}
+
+tpd::StorageBuffer tpd::bench::KernelBench::createBuffer(const vk::DeviceSize size, const vk::BufferUsageFlags usage) const {
+    using enum vk::BufferUsageFlagBits;
+    return StorageBuffer::Builder()
+        .usage(usage | eShaderDeviceAddress | eTransferSrc | eTransferDst)
+        .strategy(vma::AllocationStrategy::Dedicated) // problem sizes come and go, one at a time
+        .alloc(size)
+        .build(_vmaAllocator);
+}
+
+tpd::StorageBuffer tpd::bench::KernelBench::upload(const void* data, const vk::DeviceSize size, const vk::BufferUsageFlags usage) const {
+    auto buffer = createBuffer(size, usage);
+    auto staging = RingBuffer::Builder()
+        .count(1)
+        .usage(vk::BufferUsageFlagBits::eTransferSrc)
+        .alloc(size)
+        .build(_vmaAllocator);
+
+    staging.update(data, size);
+    execute([&](const vk::CommandBuffer cmd) { buffer.recordStagingCopy(cmd, staging, size); });
+
+    staging.destroy(_vmaAllocator);
+    return buffer;
+}
+
+void tpd::bench::KernelBench::download(const vk::Buffer buffer, void* data, const vk::DeviceSize size) const {
+    auto readback = TwoWayBuffer::Builder()
+        .usage(vk::BufferUsageFlagBits::eTransferDst)
+        .alloc(size)
+        .build(_vmaAllocator);
+
+    // Submissions are waited for, so the copy only needs to be made visible to the host
+    execute([&](const vk::CommandBuffer cmd) {
+        cmd.copyBuffer(buffer, readback, vk::BufferCopy{ 0, 0, size });
+        const auto barrier = vk::MemoryBarrier2{
+            vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+            vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead };
+        cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(barrier));
+    });
+
+    std::memcpy(data, readback.data<std::byte>(), size);
+    readback.destroy(_vmaAllocator);
+}
+
+vk::DeviceAddress tpd::bench::KernelBench::getBufferAddress(const vk::Buffer buffer) const {
+    return _device.getBufferAddress(vk::BufferDeviceAddressInfo{ buffer });
+}
+
+vk::Pipeline tpd::bench::KernelBench::createPipeline(
+    const std::string& slangFile,
+    const vk::PipelineLayout layout,
+    const KernelTuning& tuning) const
+{
+    const auto shaderModule = ShaderModuleBuilder()
+        .spirvCode(spirv::volumetric(slangFile))
+        .build(_device);
+
+    // Must match GaussianEngine::createPipeline, frame statistics are never collected here
+    struct SpecializationData {
+        uint32_t projectThreads; // constant_id 0
+        vk::Bool32 collectStats; // constant_id 1
+        uint32_t workgroupSize;  // constant_id 2
+        uint32_t blockX;         // constant_id 3
+        uint32_t blockY;         // constant_id 4
+    };
+    const auto data = SpecializationData{
+        tuning.getProjectThreads(), vk::False, tuning.workgroupSize, tuning.blockX, tuning.blockY };
+    constexpr auto constantEntries = std::array{
+        vk::SpecializationMapEntry{ 0, offsetof(SpecializationData, projectThreads), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 1, offsetof(SpecializationData, collectStats), sizeof(vk::Bool32) },
+        vk::SpecializationMapEntry{ 2, offsetof(SpecializationData, workgroupSize), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 3, offsetof(SpecializationData, blockX), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 4, offsetof(SpecializationData, blockY), sizeof(uint32_t) },
+    };
+    const auto specializationInfo = vk::SpecializationInfo{}
+        .setMapEntries(constantEntries)
+        .setDataSize(sizeof(SpecializationData))
+        .setPData(&data);
+
+    const auto shaderStage = vk::PipelineShaderStageCreateInfo{}
+        .setModule(shaderModule)
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setPSpecializationInfo(&specializationInfo)
+        .setPName("main");
+
+    const auto pipelineInfo = vk::ComputePipelineCreateInfo{}
+        .setStage(shaderStage)
+        .setLayout(layout);
+    const auto pipeline = _device.createComputePipeline({}, pipelineInfo).value;
+
+    _device.destroyShaderModule(shaderModule);
+    return pipeline;
+}
+
+void tpd::bench::KernelBench::destroy() noexcept {
+    if (_initialized) {
+        _device.destroyFence(_fence);
+        _device.destroyCommandPool(_commandPool);
+    }
+    Engine::destroy();
+}
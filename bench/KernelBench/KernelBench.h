@@ -0,0 +1,112 @@
+#pragma once
+
+#include <torpedo/rendering/Engine.h>
+
+#include <torpedo/foundation/StorageBuffer.h>
+#include <torpedo/foundation/TimestampProfiler.h>
+
+#include <torpedo/volumetric/KernelTuning.h>
+
+#include <functional>
+#include <span>
+
+namespace tpd::bench {
+    // Runs compute kernels in isolation on a device created with the same features as GaussianEngine's, so that the
+    // kernels compile and dispatch the same way they do within a frame. Every submission is waited for before the
+    // next one starts, nothing here is meant to overlap.
+    class KernelBench final : public Engine {
+    public:
+        // Records commands into a one-time command buffer and waits for the compute queue to execute them
+        void execute(const std::function<void(vk::CommandBuffer)>& record) const;
+
+        // Submits the commands of kernel as many times as there are iterations, timing each submission with
+        // timestamps. The untimed setup commands restore whatever the previous iteration overwrote, a full memory
+        // barrier separates them from the kernel.
+        [[nodiscard]] TimestampProfiler::Stats measure(
+            uint32_t iterations,
+            const std::function<void(vk::CommandBuffer)>& setup,
+            const std::function<void(vk::CommandBuffer)>& kernel) const;
+
+        // Device-local buffers, with transfer usages added so that they can be filled and read back
+        [[nodiscard]] StorageBuffer createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage = {}) const;
+        [[nodiscard]] StorageBuffer upload(const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage = {}) const;
+        void download(vk::Buffer buffer, void* data, vk::DeviceSize size) const;
+
+        template<typename T>
+        [[nodiscard]] StorageBuffer upload(std::span<const T> data, vk::BufferUsageFlags usage = {}) const;
+
+        template<typename T>
+        [[nodiscard]] std::vector<T> download(vk::Buffer buffer, uint32_t count) const;
+
+        [[nodiscard]] vk::DeviceAddress getBufferAddress(vk::Buffer buffer) const;
+
+        // Compiles one of the volumetric shaders with the same specialization constants as GaussianEngine
+        [[nodiscard]] vk::Pipeline createPipeline(const std::string& slangFile, vk::PipelineLayout layout, const KernelTuning& tuning) const;
+
+        [[nodiscard]] vk::Device getDevice() const noexcept;
+        [[nodiscard]] VmaAllocator getAllocator() const noexcept;
+        [[nodiscard]] std::string_view getDeviceName() const noexcept;
+        [[nodiscard]] bool subgroupKernels() const noexcept;
+
+        ~KernelBench() noexcept override { destroy(); }
+
+    private:
+        [[nodiscard]] PhysicalDeviceSelection pickPhysicalDevice(
+            const std::vector<const char*>& deviceExtensions,
+            vk::Instance instance, vk::SurfaceKHR surface) const override;
+
+        [[nodiscard]] vk::Device createDevice(
+            const std::vector<const char*>& deviceExtensions,
+            std::initializer_list<uint32_t> queueFamilyIndices) const override;
+
+        [[nodiscard]] const char* getName() const noexcept override;
+        [[nodiscard]] VmaAllocatorCreateFlags getAllocatorFlags() const noexcept override;
+
+        void onInitialized() override;
+        void destroy() noexcept override;
+
+        vk::Queue _computeQueue{};
+        vk::CommandPool _commandPool{};
+        vk::CommandBuffer _commandBuffer{};
+        vk::Fence _fence{};
+
+        vk::PhysicalDeviceProperties _properties{};
+        bool _subgroupKernels{ false };
+    };
+} // namespace tpd::bench
+
+template<typename T>
+tpd::StorageBuffer tpd::bench::KernelBench::upload(const std::span<const T> data, const vk::BufferUsageFlags usage) const {
+    return upload(data.data(), data.size_bytes(), usage);
+}
+
+template<typename T>
+std::vector<T> tpd::bench::KernelBench::download(const vk::Buffer buffer, const uint32_t count) const {
+    auto data = std::vector<T>(count);
+    download(buffer, data.data(), sizeof(T) * count);
+    return data;
+}
+
+inline const char* tpd::bench::KernelBench::getName() const noexcept {
+    return "tpd::bench::KernelBench";
+}
+
+inline VmaAllocatorCreateFlags tpd::bench::KernelBench::getAllocatorFlags() const noexcept {
+    return Engine::getAllocatorFlags() | VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+}
+
+inline vk::Device tpd::bench::KernelBench::getDevice() const noexcept {
+    return _device;
+}
+
+inline VmaAllocator tpd::bench::KernelBench::getAllocator() const noexcept {
+    return _vmaAllocator;
+}
+
+inline std::string_view tpd::bench::KernelBench::getDeviceName() const noexcept {
+    return _properties.deviceName.data();
+}
+
+inline bool tpd::bench::KernelBench::subgroupKernels() const noexcept {
+    return _subgroupKernels;
+}
@@ -0,0 +1,647 @@
+#include <torpedo/rendering/Context.h>
+#include <torpedo/rendering/HeadlessRenderer.h>
+#include <torpedo/rendering/LogUtils.h>
+
+#include <torpedo/foundation/GpuPrefixScan.h>
+#include <torpedo/foundation/GpuRadixSort.h>
+#include <torpedo/foundation/ShaderLayout.h>
+#include <torpedo/foundation/Target.h>
+
+#include "BenchReport.h"
+#include "KernelBench.h"
+#include "SyntheticScene.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+
+namespace {
+    constexpr auto USAGE = R"(Usage: torpedo_kernel_bench [options]
+
+Runs the compute kernels of the Gaussian splatting pipeline in isolation on synthetic inputs, validates their output
+against a CPU reference, and reports their throughput across problem sizes. Set VK_DRIVER_FILES to the lavapipe ICD
+to run without a GPU.
+
+  --kernels <list>     comma-separated kernels to run among scan, radix, keygen and blend (default all of them)
+  --sizes <list>       powers of two of the items scanned and keys sorted (default 16,18,20,22,24)
+  --key-bits <n>       low bits of the random 64-bit keys that are sorted (default 64)
+  --splats <list>      powers of ten of the splats keygen runs on (default 4,5,6)
+  --radii <list>       radii in pixels of those splats, setting how many tiles each one touches (default 2,8,32)
+  --depths <list>      splats blended by every tile, the depth complexity of blend (default 16,64,256)
+  --size <w>x<h>       image keygen bins splats into and blend writes to (default 1280x720)
+  --iterations <n>     timed submissions per problem size (default 20)
+  --output <file>      where to write the results (default torpedo_kernel_bench.json)
+  --baseline <file>    results of an earlier run to compare against, exits with 1 on any regression
+  --tolerance <x>      relative change of timings and throughput considered a regression (default 0.10)
+  --noise-floor <ms>   timing differences ignored regardless of their relative change (default 0.01)
+)";
+
+    // Bad command lines get the usage printed along with what was wrong with them
+    struct UsageError : std::invalid_argument {
+        using std::invalid_argument::invalid_argument;
+    };
+
+    constexpr auto KERNELS = std::array<std::string_view, 4>{ "scan", "radix", "keygen", "blend" };
+
+    struct Options {
+        std::vector<std::string> kernels{ KERNELS.begin(), KERNELS.end() };
+        std::vector<uint32_t> sizes{ 16, 18, 20, 22, 24 };
+        uint32_t keyBits{ 64 };
+        std::vector<uint32_t> splats{ 4, 5, 6 };
+        std::vector<uint32_t> radii{ 2, 8, 32 };
+        std::vector<uint32_t> depths{ 16, 64, 256 };
+        uint32_t width{ 1280 };
+        uint32_t height{ 720 };
+        uint32_t iterations{ 20 };
+        std::filesystem::path output{ "torpedo_kernel_bench.json" };
+        std::filesystem::path baseline{};
+        float tolerance{ 0.10f };
+        float noiseFloorMs{ 0.01f };
+        bool help{ false };
+
+        [[nodiscard]] bool runs(const std::string_view kernel) const { return std::ranges::contains(kernels, kernel); }
+    };
+
+    template<typename T>
+    T parseNumber(const std::string_view text) {
+        auto value = T{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            throw UsageError(std::format("torpedo_kernel_bench - Not a valid number: '{}'", text));
+        }
+        return value;
+    }
+
+    std::vector<uint32_t> parseNumbers(const std::string_view list, const uint32_t max, const std::string_view what) {
+        auto numbers = std::vector<uint32_t>{};
+        for (const auto number : list | std::views::split(',')) {
+            numbers.push_back(parseNumber<uint32_t>(std::string_view{ number.begin(), number.end() }));
+            if (numbers.back() == 0 || numbers.back() > max) {
+                throw UsageError(std::format("torpedo_kernel_bench - {} must be within [1, {}]", what, max));
+            }
+        }
+        return numbers;
+    }
+
+    Options parseOptions(const int argc, char** argv) {
+        auto options = Options{};
+        for (auto i = 1; i < argc; ++i) {
+            const auto arg = std::string_view{ argv[i] };
+            const auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc) throw UsageError(std::format("torpedo_kernel_bench - Missing value for {}", arg));
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                options.help = true;
+            }
+            else if (arg == "--kernels") {
+                options.kernels.clear();
+                for (const auto kernel : value() | std::views::split(',')) {
+                    options.kernels.emplace_back(kernel.begin(), kernel.end());
+                    if (!std::ranges::contains(KERNELS, options.kernels.back())) {
+                        throw UsageError(std::format("torpedo_kernel_bench - Unknown kernel: {}", options.kernels.back()));
+                    }
+                }
+            }
+            else if (arg == "--sizes")       options.sizes = parseNumbers(value(), 28, "Sizes");
+            else if (arg == "--key-bits")    options.keyBits = parseNumbers(value(), 64, "Key bits").front();
+            else if (arg == "--splats")      options.splats = parseNumbers(value(), 7, "Splat counts");
+            else if (arg == "--radii")       options.radii = parseNumbers(value(), 1024, "Radii");
+            else if (arg == "--depths")      options.depths = parseNumbers(value(), 4096, "Depth complexities");
+            else if (arg == "--size") {
+                const auto size = value();
+                const auto x = size.find('x');
+                if (x == std::string_view::npos) throw UsageError("torpedo_kernel_bench - Expected a size such as 1280x720");
+                options.width = parseNumber<uint32_t>(size.substr(0, x));
+                options.height = parseNumber<uint32_t>(size.substr(x + 1));
+            }
+            else if (arg == "--iterations")  options.iterations = std::max(parseNumber<uint32_t>(value()), 1u);
+            else if (arg == "--output")      options.output = value();
+            else if (arg == "--baseline")    options.baseline = value();
+            else if (arg == "--tolerance")   options.tolerance = parseNumber<float>(value());
+            else if (arg == "--noise-floor") options.noiseFloorMs = parseNumber<float>(value());
+            else throw UsageError(std::format("torpedo_kernel_bench - Unknown option: {}", arg));
+        }
+        return options;
+    }
+
+    using tpd::bench::BenchReport;
+    using tpd::bench::KernelBench;
+    using tpd::bench::SplitMix64;
+
+    // Records the median timing of a problem size along with its validation, returns the median in seconds
+    double reportRun(
+        BenchReport& report, const std::string& name,
+        const tpd::TimestampProfiler::Stats& stats, const uint64_t mismatchCount)
+    {
+        report.set(name + ".p50Ms", stats.p50);
+        report.set(name + ".p95Ms", stats.p95);
+        report.set(name + ".mismatches", static_cast<double>(mismatchCount));
+        std::cout << std::format("  {:<24} p50 {:9.4f} ms, p95 {:9.4f} ms{}\n", name, stats.p50, stats.p95,
+            mismatchCount == 0 ? "" : std::format(", {} MISMATCHES", mismatchCount));
+        return std::max(static_cast<double>(stats.p50), 1e-6) / 1000.0;
+    }
+
+    template<typename T>
+    uint64_t countMismatches(const std::vector<T>& actual, const std::vector<T>& expected) {
+        auto count = uint64_t{ 0 };
+        for (auto i = 0uz; i < expected.size(); ++i) {
+            count += actual[i] != expected[i] ? 1 : 0;
+        }
+        return count;
+    }
+
+    /*------------------*/
+
+    uint64_t runScan(const KernelBench& bench, const Options& options, BenchReport& report) {
+        auto scan = tpd::GpuPrefixScan::Builder()
+            .subgroupKernels(bench.subgroupKernels())
+            .build(bench.getDevice());
+        std::cout << "scan: in-place exclusive prefix sum of tile counts\n";
+
+        auto failedCount = uint64_t{ 0 };
+        for (const auto exponent : options.sizes) {
+            const auto count = 1u << exponent;
+            const auto name = std::format("scan.2^{}", exponent);
+
+            // Tiles touched by each splat, kept small enough for their sum to fit in the 30 bits the scan supports
+            const auto itemLimit = std::clamp((1u << 30) / count, 1u, 256u);
+            auto rng = SplitMix64{ exponent };
+            auto items = std::vector<uint32_t>(count);
+            std::ranges::generate(items, [&rng, itemLimit] { return static_cast<uint32_t>(rng.next() % itemLimit); });
+
+            const auto bytes = sizeof(uint32_t) * count;
+            auto source = bench.upload(std::span<const uint32_t>{ items });
+            auto data = bench.createBuffer(bytes);
+            auto scratch = bench.createBuffer(tpd::GpuPrefixScan::getScratchSize(count));
+            auto total = bench.createBuffer(sizeof(uint32_t));
+            const auto input = tpd::GpuPrefixScan::Input{ data, 0, count, 1, scratch, total, 0 };
+
+            // Items are scanned in place, each iteration starts over from the same items
+            const auto stats = bench.measure(options.iterations,
+                [&](const vk::CommandBuffer cmd) { cmd.copyBuffer(source, data, vk::BufferCopy{ 0, 0, bytes }); },
+                [&](const vk::CommandBuffer cmd) { scan.record(cmd, input); });
+
+            auto expected = std::vector<uint32_t>(count);
+            std::exclusive_scan(items.begin(), items.end(), expected.begin(), 0u);
+            const auto expectedTotal = expected.back() + items.back();
+
+            const auto mismatchCount = countMismatches(bench.download<uint32_t>(data, count), expected)
+                + (bench.download<uint32_t>(total, 1).front() != expectedTotal ? 1 : 0);
+            failedCount += mismatchCount > 0 ? 1 : 0;
+
+            // Every item is read once and written once
+            const auto seconds = reportRun(report, name, stats, mismatchCount);
+            report.set(name + ".itemsPerSecond", count / seconds);
+            report.set(name + ".gbPerSecond", 2.0 * bytes / seconds * 1e-9);
+            std::cout << std::format("  {:<24} {:9.1f} M items/s, {:7.2f} GB/s\n", "", count / seconds * 1e-6, 2.0 * bytes / seconds * 1e-9);
+
+            for (auto* buffer : { &source, &data, &scratch, &total }) buffer->destroy(bench.getAllocator());
+        }
+
+        scan.destroy();
+        return failedCount;
+    }
+
+    uint64_t runRadixSort(const KernelBench& bench, const Options& options, BenchReport& report) {
+        auto sort = tpd::GpuRadixSort::Builder()
+            .keyType(tpd::GpuRadixSort::KeyType::Uint64)
+            .subgroupKernels(bench.subgroupKernels())
+            .build(bench.getDevice());
+        const auto passCount = tpd::GpuRadixSort::getPassCount(0, options.keyBits);
+        std::cout << std::format("radix: stable sort of random {}-bit keys with 32-bit values, {} passes\n", options.keyBits, passCount);
+
+        auto failedCount = uint64_t{ 0 };
+        for (const auto exponent : options.sizes) {
+            const auto count = 1u << exponent;
+            const auto name = std::format("radix.2^{}", exponent);
+
+            // Bits beyond those sorted are left out of the keys, so that the reference sorts them the same way
+            const auto mask = options.keyBits < 64 ? (uint64_t{ 1 } << options.keyBits) - 1 : ~uint64_t{ 0 };
+            auto rng = SplitMix64{ exponent };
+            auto keys = std::vector<uint64_t>(count);
+            std::ranges::generate(keys, [&rng, mask] { return rng.next() & mask; });
+            auto values = std::vector<uint32_t>(count);
+            std::iota(values.begin(), values.end(), 0u);
+
+            auto sourceKeys = bench.upload(std::span<const uint64_t>{ keys });
+            auto sourceValues = bench.upload(std::span<const uint32_t>{ values });
+            auto sortedKeys = bench.createBuffer(sizeof(uint64_t) * count);
+            auto sortedValues = bench.createBuffer(sizeof(uint32_t) * count);
+            auto scratch = bench.createBuffer(sort.getScratchSize(count));
+            const auto input = tpd::GpuRadixSort::Input{ sortedKeys, sortedValues, scratch, count, 0, options.keyBits };
+
+            const auto stats = bench.measure(options.iterations,
+                [&](const vk::CommandBuffer cmd) {
+                    cmd.copyBuffer(sourceKeys, sortedKeys, vk::BufferCopy{ 0, 0, sizeof(uint64_t) * count });
+                    cmd.copyBuffer(sourceValues, sortedValues, vk::BufferCopy{ 0, 0, sizeof(uint32_t) * count });
+                },
+                [&](const vk::CommandBuffer cmd) { sort.record(cmd, input, count); });
+
+            // Values are the original positions of the keys, which a stable sort orders the same way on both sides
+            std::ranges::stable_sort(values, {}, [&keys](const uint32_t i) { return keys[i]; });
+            auto expectedKeys = std::vector<uint64_t>(count);
+            std::ranges::transform(values, expectedKeys.begin(), [&keys](const uint32_t i) { return keys[i]; });
+
+            const auto mismatchCount = countMismatches(bench.download<uint64_t>(sortedKeys, count), expectedKeys)
+                + countMismatches(bench.download<uint32_t>(sortedValues, count), values);
+            failedCount += mismatchCount > 0 ? 1 : 0;
+
+            // Every pass reads and writes all keys and values at least once
+            const auto bytes = 2.0 * passCount * (sizeof(uint64_t) + sizeof(uint32_t)) * count;
+            const auto seconds = reportRun(report, name, stats, mismatchCount);
+            report.set(name + ".keysPerSecond", count / seconds);
+            report.set(name + ".gbPerSecond", bytes / seconds * 1e-9);
+            std::cout << std::format("  {:<24} {:9.1f} M keys/s, {:7.2f} GB/s\n", "", count / seconds * 1e-6, bytes / seconds * 1e-9);
+
+            for (auto* buffer : { &sourceKeys, &sourceValues, &sortedKeys, &sortedValues, &scratch }) {
+                buffer->destroy(bench.getAllocator());
+            }
+        }
+
+        sort.destroy();
+        return failedCount;
+    }
+
+    /*------------------*/
+
+    // Must match Splat in splat.slang
+    struct Splat {
+        float color[3];
+        uint32_t tiles;
+        float texel[4]; // image point + view depth + radius
+        float copac[4]; // conic + opacity
+    };
+    static_assert(sizeof(Splat) == 48);
+
+    // Must match RasterInfo in splat.slang
+    struct RasterInfo {
+        uint32_t pointCount;
+        uint32_t shDegree;
+        vk::DeviceAddress splatKeys;
+        vk::DeviceAddress splatIndices;
+        vk::DeviceAddress ranges;
+        vk::DeviceAddress tilesRendered;
+    };
+
+    // The part of GaussianEngine's descriptor layout that keygen and blend access, along with their output image
+    struct SplatKernels {
+        tpd::KernelTuning tuning{};
+        tpd::ShaderLayout<1> shaderLayout{};
+        tpd::ShaderInstance<1> instance{};
+        vk::PipelineLayout pipelineLayout{};
+        vk::Pipeline keygenPipeline{};
+        vk::Pipeline blendPipeline{};
+        tpd::Target image{};
+        vk::ImageView imageView{};
+        tpd::StorageBuffer statsBuffer{};
+        uint32_t gridX{ 0 };
+        uint32_t gridY{ 0 };
+
+        void create(const KernelBench& bench, const Options& options);
+        void bindSplats(const KernelBench& bench, vk::Buffer splats, vk::DeviceSize size) const;
+        void recordDispatch(vk::CommandBuffer cmd, vk::Pipeline pipeline, const RasterInfo& info, uint32_t x, uint32_t y) const;
+        void destroy(const KernelBench& bench) noexcept;
+    };
+
+    void SplatKernels::create(const KernelBench& bench, const Options& options) {
+        using enum vk::DescriptorType;
+        using enum vk::ShaderStageFlagBits;
+        const auto device = bench.getDevice();
+
+        // Frame statistics are never collected, but blend still declares their binding
+        shaderLayout = tpd::ShaderLayout<1>::Builder()
+            .pushConstantRange(eCompute, 0, sizeof(RasterInfo))
+            .descriptor(0, 0, eStorageImage,  1, eCompute) // output image
+            .descriptor(0, 3, eStorageBuffer, 1, eCompute) // splats
+            .descriptor(0,19, eStorageBuffer, 1, eCompute) // frame statistics
+            .build(device, &pipelineLayout);
+        instance = shaderLayout.createInstance(device);
+
+        keygenPipeline = bench.createPipeline("keygen.slang", pipelineLayout, tuning);
+        blendPipeline = bench.createPipeline("blend.slang", pipelineLayout, tuning);
+
+        image = tpd::Image::Builder<tpd::Target>()
+            .extent(options.width, options.height)
+            .format(vk::Format::eR8G8B8A8Unorm)
+            .usage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc)
+            .build(bench.getAllocator());
+        imageView = image.createImageView(vk::ImageViewType::e2D, device);
+        bench.execute([this](const vk::CommandBuffer cmd) {
+            image.recordLayoutTransition(cmd, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+        });
+        instance.setDescriptor(0, 0, eStorageImage, device, vk::DescriptorImageInfo{}.setImageView(imageView).setImageLayout(vk::ImageLayout::eGeneral));
+
+        constexpr auto statsSize = sizeof(uint32_t) * 4; // see FrameStats in splat.slang
+        statsBuffer = bench.createBuffer(statsSize);
+        instance.setDescriptor(0, 19, eStorageBuffer, device, vk::DescriptorBufferInfo{}.setBuffer(statsBuffer).setOffset(0).setRange(statsSize));
+
+        gridX = (options.width + tuning.blockX - 1) / tuning.blockX;
+        gridY = (options.height + tuning.blockY - 1) / tuning.blockY;
+    }
+
+    void SplatKernels::bindSplats(const KernelBench& bench, const vk::Buffer splats, const vk::DeviceSize size) const {
+        const auto info = vk::DescriptorBufferInfo{}.setBuffer(splats).setOffset(0).setRange(size);
+        instance.setDescriptor(0, 3, vk::DescriptorType::eStorageBuffer, bench.getDevice(), info);
+    }
+
+    void SplatKernels::recordDispatch(
+        const vk::CommandBuffer cmd, const vk::Pipeline pipeline,
+        const RasterInfo& info, const uint32_t x, const uint32_t y) const
+    {
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, instance.getDescriptorSets(), {});
+        cmd.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(RasterInfo), &info);
+        cmd.dispatch(x, y, 1);
+    }
+
+    void SplatKernels::destroy(const KernelBench& bench) noexcept {
+        const auto device = bench.getDevice();
+        statsBuffer.destroy(bench.getAllocator());
+        device.destroyImageView(imageView);
+        image.destroy(bench.getAllocator());
+        device.destroyPipeline(blendPipeline);
+        device.destroyPipeline(keygenPipeline);
+        instance.destroy(device);
+        shaderLayout.destroy(device);
+        device.destroyPipelineLayout(pipelineLayout);
+    }
+
+    // Same as getBoundingRect in splat/volume.slang
+    void getBoundingRect(
+        const float x, const float y, const float radius, const SplatKernels& kernels,
+        uint32_t& minX, uint32_t& minY, uint32_t& maxX, uint32_t& maxY)
+    {
+        const auto blockX = static_cast<float>(kernels.tuning.blockX);
+        const auto blockY = static_cast<float>(kernels.tuning.blockY);
+        const auto clamp = [](const float value, const uint32_t grid) {
+            return std::min(grid, static_cast<uint32_t>(std::max(0, static_cast<int>(value))));
+        };
+        minX = clamp((x - radius) / blockX, kernels.gridX);
+        minY = clamp((y - radius) / blockY, kernels.gridY);
+        maxX = clamp((x + radius + blockX - 1) / blockX, kernels.gridX);
+        maxY = clamp((y + radius + blockY - 1) / blockY, kernels.gridY);
+    }
+
+    uint64_t runKeygen(const KernelBench& bench, const SplatKernels& kernels, const Options& options, BenchReport& report) {
+        std::cout << std::format("keygen: tile keys of splats over a {}x{} image\n", options.width, options.height);
+
+        auto failedCount = uint64_t{ 0 };
+        for (const auto exponent : options.splats) {
+            for (const auto radius : options.radii) {
+                const auto count = static_cast<uint32_t>(std::pow(10.0, exponent));
+                const auto name = std::format("keygen.1e{}.r{}", exponent, radius);
+
+                // Image points on a quarter pixel grid and integral radii keep every division by the tile size exact,
+                // so that the host and the device agree on which tiles each splat touches
+                auto rng = SplitMix64{ exponent * 1000 + radius };
+                auto splats = std::vector<Splat>(count);
+                auto offset = uint32_t{ 0 };
+                for (auto& splat : splats) {
+                    const auto x = std::floor(rng.uniform(0.0f, static_cast<float>(options.width) * 4.0f)) / 4.0f;
+                    const auto y = std::floor(rng.uniform(0.0f, static_cast<float>(options.height) * 4.0f)) / 4.0f;
+                    splat = { { 1.0f, 1.0f, 1.0f }, offset, { x, y, rng.uniform(0.1f, 100.0f), static_cast<float>(radius) }, {} };
+
+                    // The exclusive prefix sum of the tiles touched, as left by the project and prefix passes
+                    uint32_t minX, minY, maxX, maxY;
+                    getBoundingRect(x, y, static_cast<float>(radius), kernels, minX, minY, maxX, maxY);
+                    offset += (maxX - minX) * (maxY - minY);
+                }
+                const auto keyCount = offset;
+
+                auto expectedKeys = std::vector<uint64_t>{};
+                auto expectedIndices = std::vector<uint32_t>{};
+                expectedKeys.reserve(keyCount);
+                expectedIndices.reserve(keyCount);
+                for (uint32_t idx = 0; idx < count; ++idx) {
+                    const auto& texel = splats[idx].texel;
+                    uint32_t minX, minY, maxX, maxY;
+                    getBoundingRect(texel[0], texel[1], texel[3], kernels, minX, minY, maxX, maxY);
+                    for (auto y = minY; y < maxY; ++y) {
+                        for (auto x = minX; x < maxX; ++x) {
+                            const auto tileId = uint64_t{ y * kernels.gridX + x };
+                            expectedKeys.push_back(tileId << 32 | std::bit_cast<uint32_t>(texel[2]));
+                            expectedIndices.push_back(idx);
+                        }
+                    }
+                }
+
+                auto splatBuffer = bench.upload(std::span<const Splat>{ splats });
+                auto keys = bench.createBuffer(sizeof(uint64_t) * std::max(keyCount, 1u));
+                auto indices = bench.createBuffer(sizeof(uint32_t) * std::max(keyCount, 1u));
+                kernels.bindSplats(bench, splatBuffer, sizeof(Splat) * count);
+
+                const auto info = RasterInfo{
+                    count, 0, bench.getBufferAddress(keys), bench.getBufferAddress(indices), 0, 0 };
+                const auto groupCount = (count + kernels.tuning.workgroupSize - 1) / kernels.tuning.workgroupSize;
+
+                // Keygen writes the same keys every time, there is nothing to restore
+                const auto stats = bench.measure(options.iterations, [](vk::CommandBuffer) {},
+                    [&](const vk::CommandBuffer cmd) { kernels.recordDispatch(cmd, kernels.keygenPipeline, info, groupCount, 1); });
+
+                const auto mismatchCount = countMismatches(bench.download<uint64_t>(keys, keyCount), expectedKeys)
+                    + countMismatches(bench.download<uint32_t>(indices, keyCount), expectedIndices);
+                failedCount += mismatchCount > 0 ? 1 : 0;
+
+                // Splats are read once, each key and index written once
+                const auto bytes = sizeof(Splat) * count + (sizeof(uint64_t) + sizeof(uint32_t)) * static_cast<double>(keyCount);
+                const auto seconds = reportRun(report, name, stats, mismatchCount);
+                report.set(name + ".keys", keyCount);
+                report.set(name + ".splatsPerSecond", count / seconds);
+                report.set(name + ".keysPerSecond", keyCount / seconds);
+                report.set(name + ".gbPerSecond", bytes / seconds * 1e-9);
+                std::cout << std::format("  {:<24} {:9.1f} M keys/s, {:7.2f} GB/s, {:.1f} tiles per splat\n", "",
+                    keyCount / seconds * 1e-6, bytes / seconds * 1e-9, static_cast<double>(keyCount) / count);
+
+                for (auto* buffer : { &splatBuffer, &keys, &indices }) buffer->destroy(bench.getAllocator());
+            }
+        }
+        return failedCount;
+    }
+
+    // Blends the range of each tile front to back the way blend.slang does, into tightly packed R8G8B8A8 rows
+    std::vector<uint8_t> blendReference(
+        const std::vector<Splat>& splats, const uint32_t depth,
+        const SplatKernels& kernels, const Options& options)
+    {
+        auto pixels = std::vector<uint8_t>(4uz * options.width * options.height);
+        for (uint32_t py = 0; py < options.height; ++py) {
+            for (uint32_t px = 0; px < options.width; ++px) {
+                const auto tile = py / kernels.tuning.blockY * kernels.gridX + px / kernels.tuning.blockX;
+
+                auto T = 1.0f;
+                float color[3]{ 0.0f, 0.0f, 0.0f };
+                for (auto i = tile * depth; i < (tile + 1) * depth; ++i) {
+                    const auto& [c, tiles, texel, copac] = splats[i];
+                    const auto dx = texel[0] - static_cast<float>(px);
+                    const auto dy = texel[1] - static_cast<float>(py);
+                    const auto power = -0.5f * (copac[0] * dx * dx + copac[2] * dy * dy) - copac[1] * dx * dy;
+                    if (power > 0.0f) continue;
+
+                    const auto alpha = std::min(0.99f, copac[3] * std::exp(power));
+                    if (alpha < 1.0f / 255.0f) continue;
+                    if (T * (1.0f - alpha) < 0.0001f) break;
+
+                    for (auto k = 0; k < 3; ++k) color[k] += c[k] * alpha * T;
+                    T *= 1.0f - alpha;
+                }
+
+                const auto pixel = pixels.data() + 4uz * (py * options.width + px);
+                for (auto k = 0; k < 3; ++k) {
+                    pixel[k] = static_cast<uint8_t>(std::lround(std::clamp(color[k], 0.0f, 1.0f) * 255.0f));
+                }
+                pixel[3] = 255;
+            }
+        }
+        return pixels;
+    }
+
+    uint64_t runBlend(const KernelBench& bench, const SplatKernels& kernels, const Options& options, BenchReport& report) {
+        std::cout << std::format("blend: {}x{} image, {}x{} tiles\n", options.width, options.height, kernels.gridX, kernels.gridY);
+
+        const auto tileCount = kernels.gridX * kernels.gridY;
+        const auto pixelCount = options.width * options.height;
+        auto pixelBuffer = bench.createBuffer(4uz * pixelCount);
+
+        auto failedCount = uint64_t{ 0 };
+        for (const auto depth : options.depths) {
+            const auto name = std::format("blend.d{}", depth);
+
+            // Every tile blends its own splats, each centered within the tile and a few pixels wide, as if keygen,
+            // sort and range had already binned them. Splat indices follow the tiles, in order of increasing depth.
+            auto rng = SplitMix64{ depth };
+            auto splats = std::vector<Splat>(static_cast<std::size_t>(tileCount) * depth);
+            auto ranges = std::vector<uint32_t>(2uz * tileCount);
+            for (uint32_t tile = 0; tile < tileCount; ++tile) {
+                const auto originX = static_cast<float>(tile % kernels.gridX * kernels.tuning.blockX);
+                const auto originY = static_cast<float>(tile / kernels.gridX * kernels.tuning.blockY);
+                for (auto i = tile * depth; i < (tile + 1) * depth; ++i) {
+                    const auto sx = rng.uniform(1.5f, 6.0f);
+                    const auto sy = rng.uniform(1.5f, 6.0f);
+                    const auto b = rng.uniform(-0.5f, 0.5f) * sx * sy;
+                    const auto det = sx * sx * sy * sy - b * b;
+
+                    auto& [color, tiles, texel, copac] = splats[i];
+                    color[0] = rng.uniform(); color[1] = rng.uniform(); color[2] = rng.uniform();
+                    tiles = 1;
+                    texel[0] = originX + rng.uniform(0.0f, static_cast<float>(kernels.tuning.blockX));
+                    texel[1] = originY + rng.uniform(0.0f, static_cast<float>(kernels.tuning.blockY));
+                    texel[2] = static_cast<float>(i - tile * depth + 1);
+                    texel[3] = 3.0f * std::max(sx, sy);
+                    copac[0] = sy * sy / det; copac[1] = -b / det; copac[2] = sx * sx / det;
+                    copac[3] = rng.uniform(0.02f, 0.3f);
+                }
+                ranges[2 * tile] = tile * depth;
+                ranges[2 * tile + 1] = (tile + 1) * depth;
+            }
+            auto indices = std::vector<uint32_t>(splats.size());
+            std::iota(indices.begin(), indices.end(), 0u);
+
+            auto splatBuffer = bench.upload(std::span<const Splat>{ splats });
+            auto indexBuffer = bench.upload(std::span<const uint32_t>{ indices });
+            auto rangeBuffer = bench.upload(std::span<const uint32_t>{ ranges });
+            kernels.bindSplats(bench, splatBuffer, sizeof(Splat) * splats.size());
+
+            const auto info = RasterInfo{
+                static_cast<uint32_t>(splats.size()), 0, 0,
+                bench.getBufferAddress(indexBuffer), bench.getBufferAddress(rangeBuffer), 0 };
+
+            // Blend overwrites every pixel, there is nothing to restore
+            const auto stats = bench.measure(options.iterations, [](vk::CommandBuffer) {},
+                [&](const vk::CommandBuffer cmd) { kernels.recordDispatch(cmd, kernels.blendPipeline, info, kernels.gridX, kernels.gridY); });
+
+            bench.execute([&](const vk::CommandBuffer cmd) {
+                const auto region = vk::BufferImageCopy{}
+                    .setImageSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
+                    .setImageExtent({ options.width, options.height, 1 });
+                cmd.copyImageToBuffer(kernels.image, vk::ImageLayout::eGeneral, pixelBuffer, region);
+            });
+            const auto pixels = bench.download<uint8_t>(pixelBuffer, 4 * pixelCount);
+            const auto expected = blendReference(splats, depth, kernels, options);
+
+            // exp and the conversion to unorm differ by an ulp or two between implementations, which occasionally
+            // crosses the alpha and transmittance thresholds, so only pixels off by several steps count as mismatches
+            auto mismatchCount = uint64_t{ 0 };
+            auto maxError = 0;
+            for (auto i = 0uz; i < pixels.size(); i += 4) {
+                auto error = 0;
+                for (auto k = 0uz; k < 4; ++k) error = std::max(error, std::abs(pixels[i + k] - expected[i + k]));
+                maxError = std::max(maxError, error);
+                mismatchCount += error > 2 ? 1 : 0;
+            }
+            // A handful of such pixels is expected, a broken kernel gets whole tiles wrong
+            const auto tolerated = mismatchCount <= pixelCount / 1000;
+            failedCount += tolerated ? 0 : 1;
+
+            const auto seconds = reportRun(report, name, stats, tolerated ? 0 : mismatchCount);
+            report.set(name + ".pixelsPerSecond", pixelCount / seconds);
+            report.set(name + ".splatsPerSecond", static_cast<double>(splats.size()) / seconds);
+            std::cout << std::format("  {:<24} {:9.1f} M pixels/s, {:9.1f} M splats/s, max error {}, {} pixels off\n", "",
+                pixelCount / seconds * 1e-6, static_cast<double>(splats.size()) / seconds * 1e-6, maxError, mismatchCount);
+
+            for (auto* buffer : { &splatBuffer, &indexBuffer, &rangeBuffer }) buffer->destroy(bench.getAllocator());
+        }
+
+        pixelBuffer.destroy(bench.getAllocator());
+        return failedCount;
+    }
+} // namespace
+
+int main(const int argc, char** argv) try {
+    const auto options = parseOptions(argc, argv);
+    if (options.help) {
+        std::cout << USAGE;
+        return 0;
+    }
+    tpd::utils::plantConsoleLogger();
+
+    const auto context = tpd::Context<tpd::HeadlessRenderer>::create();
+    const auto bench = context->bindEngine<KernelBench>();
+
+    auto report = BenchReport{};
+    report.set("device", std::string{ bench->getDeviceName() });
+    report.set("subgroupKernels", bench->subgroupKernels() ? 1.0 : 0.0);
+    report.set("keyBits", options.keyBits);
+    report.set("width", options.width);
+    report.set("height", options.height);
+
+    auto failedCount = uint64_t{ 0 };
+    if (options.runs("scan"))  failedCount += runScan(*bench, options, report);
+    if (options.runs("radix")) failedCount += runRadixSort(*bench, options, report);
+
+    if (options.runs("keygen") || options.runs("blend")) {
+        auto kernels = SplatKernels{};
+        kernels.create(*bench, options);
+        if (options.runs("keygen")) failedCount += runKeygen(*bench, kernels, options, report);
+        if (options.runs("blend"))  failedCount += runBlend(*bench, kernels, options, report);
+        kernels.destroy(*bench);
+    }
+
+    report.save(options.output);
+    std::cout << std::format("Results written to {}\n", options.output.string());
+    if (failedCount > 0) {
+        std::cout << std::format("{} problem size(s) did NOT match the CPU reference\n", failedCount);
+    }
+
+    auto regressionCount = 0u;
+    if (!options.baseline.empty()) {
+        std::cout << std::format("Comparing against {} (tolerance {:.0f}%):\n", options.baseline.string(), options.tolerance * 100.0f);
+        const auto baseline = BenchReport::load(options.baseline);
+        regressionCount = tpd::bench::compare(report, baseline, options.tolerance, options.noiseFloorMs, std::cout);
+        std::cout << std::format("{} regression(s)\n", regressionCount);
+    }
+    return failedCount > 0 || regressionCount > 0 ? 1 : 0;
+} catch (const UsageError& e) {
+    std::cerr << e.what() << "\n\n" << USAGE;
+    return 2;
+} catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 2;
+}
@@ -0,0 +1,272 @@
+#include <torpedo/rendering/Context.h>
+#include <torpedo/rendering/HeadlessRenderer.h>
+#include <torpedo/rendering/LogUtils.h>
+#include <torpedo/rendering/Scene.h>
+
+#include <torpedo/volumetric/GaussianEngine.h>
+#include <torpedo/volumetric/GaussianGeometry.h>
+
+#include <torpedo/extension/PerspectiveCamera.h>
+
+#include "BenchReport.h"
+#include "SyntheticScene.h"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <ranges>
+
+namespace {
+    constexpr auto USAGE = R"(Usage: torpedo_bench [options]
+
+Renders synthetic scenes (and optionally a trained PLY model) headlessly along a fixed orbit, then reports GPU time per
+pass, host time, device memory and tiles rendered. Set VK_DRIVER_FILES to the lavapipe ICD to run without a GPU.
+
+  --scenes <list>      comma-separated powers of ten of the synthetic scene sizes (default 4,5,6,7), "none" to skip
+  --ply <file>         also render a trained model, looking at it with -y as up as trained scenes usually are
+  --size <w>x<h>       resolution of the headless target (default 1280x720)
+  --frames <n>         frames along the orbit, all of them measured (default 120)
+  --warmup <n>         frames rendered from the first pose before measuring (default 8)
+  --sh-degree <n>      spherical harmonics degree the engine compiles with (default 3)
+  --half               store splats in the packed fp16 layout
+  --output <file>      where to write the results (default torpedo_bench.json)
+  --baseline <file>    results of an earlier run to compare against, exits with 1 on any regression
+  --tolerance <x>      relative change of timings and memory considered a regression (default 0.10)
+  --noise-floor <ms>   timing differences ignored regardless of their relative change (default 0.05)
+)";
+
+    // Bad command lines get the usage printed along with what was wrong with them
+    struct UsageError : std::invalid_argument {
+        using std::invalid_argument::invalid_argument;
+    };
+
+    struct Options {
+        std::vector<uint32_t> exponents{ 4, 5, 6, 7 };
+        std::filesystem::path ply{};
+        uint32_t width{ 1280 };
+        uint32_t height{ 720 };
+        uint32_t frames{ 120 };
+        uint32_t warmup{ 8 };
+        uint32_t shDegree{ 3 };
+        bool halfPrecision{ false };
+        std::filesystem::path output{ "torpedo_bench.json" };
+        std::filesystem::path baseline{};
+        float tolerance{ 0.10f };
+        float noiseFloorMs{ 0.05f };
+        bool help{ false };
+    };
+
+    template<typename T>
+    T parseNumber(const std::string_view text) {
+        auto value = T{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            throw UsageError(std::format("torpedo_bench - Not a valid number: '{}'", text));
+        }
+        return value;
+    }
+
+    Options parseOptions(const int argc, char** argv) {
+        auto options = Options{};
+        for (auto i = 1; i < argc; ++i) {
+            const auto arg = std::string_view{ argv[i] };
+            const auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc) throw UsageError(std::format("torpedo_bench - Missing value for {}", arg));
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                options.help = true;
+            }
+            else if (arg == "--scenes") {
+                options.exponents.clear();
+                const auto list = value();
+                if (list == "none") continue;
+                for (const auto exponent : list | std::views::split(',')) {
+                    options.exponents.push_back(parseNumber<uint32_t>(std::string_view{ exponent.begin(), exponent.end() }));
+                    if (options.exponents.back() > 9) throw UsageError("torpedo_bench - Scenes are limited to 10^9 Gaussians");
+                }
+            }
+            else if (arg == "--ply")         options.ply = value();
+            else if (arg == "--size") {
+                const auto size = value();
+                const auto x = size.find('x');
+                if (x == std::string_view::npos) throw UsageError("torpedo_bench - Expected a size such as 1280x720");
+                options.width = parseNumber<uint32_t>(size.substr(0, x));
+                options.height = parseNumber<uint32_t>(size.substr(x + 1));
+            }
+            else if (arg == "--frames")      options.frames = std::max(parseNumber<uint32_t>(value()), 1u);
+            else if (arg == "--warmup")      options.warmup = parseNumber<uint32_t>(value());
+            else if (arg == "--sh-degree")   options.shDegree = parseNumber<uint32_t>(value());
+            else if (arg == "--half")        options.halfPrecision = true;
+            else if (arg == "--output")      options.output = value();
+            else if (arg == "--baseline")    options.baseline = value();
+            else if (arg == "--tolerance")   options.tolerance = parseNumber<float>(value());
+            else if (arg == "--noise-floor") options.noiseFloorMs = parseNumber<float>(value());
+            else throw UsageError(std::format("torpedo_bench - Unknown option: {}", arg));
+        }
+        return options;
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    float toMillis(const Clock::duration duration) {
+        return std::chrono::duration<float, std::milli>{ duration }.count();
+    }
+
+    void runScene(
+        const std::string& name,
+        const std::vector<tpd::GaussianPoint>& points,
+        const tpd::vec3& up,
+        const Options& options,
+        tpd::bench::BenchReport& report)
+    {
+        std::cout << std::format("{}: {} Gaussians\n", name, points.size());
+
+        // A context of its own for each scene, so that nothing allocated for one is counted toward the next
+        const auto context = tpd::Context<tpd::HeadlessRenderer>::create();
+        static_cast<void>(context->initRenderer(options.width, options.height));
+        const auto engine = context->bindEngine<tpd::GaussianEngine>();
+        const auto camera = context->createCamera<tpd::PerspectiveCamera>();
+
+        auto scene = tpd::Scene{};
+        scene.add(tpd::ent::group(points));
+
+        auto settings = tpd::GaussianEngine::Settings::getDefault();
+        settings.sphericalHarmonicsDegree = options.shDegree;
+        settings.halfPrecisionSplats = options.halfPrecision;
+        settings.gpuProfiling = true;
+        settings.frameStatistics = true;
+
+        const auto compileStart = Clock::now();
+        engine->compile(scene, settings);
+        const auto compileMs = toMillis(Clock::now() - compileStart);
+
+        const auto path = tpd::bench::getOrbitPath(tpd::bench::getBounds(points), up, options.frames);
+
+        // Counters read back during a renderToHost belong to the frame rendered as many calls earlier as there are
+        // frames in flight, so the last measured frames are followed by that many more to collect theirs
+        constexpr auto inFlight = tpd::HeadlessRenderer::IN_FLIGHT_FRAME_COUNT;
+        const auto measureBegin = options.warmup;
+        const auto measureEnd = options.warmup + options.frames;
+        const auto totalFrames = measureEnd + inFlight;
+
+        auto submitted = std::vector<Clock::time_point>(totalFrames);
+        auto delivered = std::vector<Clock::time_point>(totalFrames);
+        auto submitMs = std::vector<float>{};
+        auto tilesRendered = uint64_t{ 0 };
+        auto maxTilesRendered = 0u;
+        auto visibleGaussians = uint64_t{ 0 };
+
+        for (uint32_t i = 0; i < totalFrames; ++i) {
+            const auto& [eye, target] = i < measureBegin ? path.front() : path[(i - measureBegin) % options.frames];
+            camera->lookAt(eye, target, up);
+
+            submitted[i] = Clock::now();
+            engine->renderToHost(*camera, [&delivered](const tpd::GaussianEngine::HostFrame& frame) {
+                delivered[frame.number] = Clock::now();
+            });
+            if (i >= measureBegin && i < measureEnd) {
+                submitMs.push_back(toMillis(Clock::now() - submitted[i]));
+            }
+            if (i >= measureBegin + inFlight) {
+                const auto& statistics = engine->getFrameStatistics();
+                tilesRendered += statistics.tilesRendered;
+                maxTilesRendered = std::max(maxTilesRendered, statistics.tilesRendered);
+                visibleGaussians += statistics.visibleGaussians;
+            }
+        }
+        engine->waitHostFrames();
+
+        // Frames are pipelined, so the interval between submissions is how fast frames are produced once steady
+        const auto frameMs = toMillis(submitted[measureEnd] - submitted[measureBegin]) / static_cast<float>(options.frames);
+        auto latencyMs = std::vector<float>{};
+        for (auto i = measureBegin; i < measureEnd; ++i) {
+            latencyMs.push_back(toMillis(delivered[i] - submitted[i]));
+        }
+        std::ranges::sort(submitMs);
+        std::ranges::sort(latencyMs);
+
+        using tpd::bench::percentile;
+        report.set(name + ".gaussians", static_cast<double>(points.size()));
+        report.set(name + ".compileMs", compileMs);
+        report.set(name + ".frameMs", frameMs);
+        report.set(name + ".submitP50Ms", percentile(submitMs, 0.50f));
+        report.set(name + ".submitP95Ms", percentile(submitMs, 0.95f));
+        report.set(name + ".latencyP50Ms", percentile(latencyMs, 0.50f));
+        report.set(name + ".latencyP95Ms", percentile(latencyMs, 0.95f));
+        std::cout << std::format("  host   frame {:9.3f} ms, submit p50 {:8.3f} ms, latency p50 {:8.3f} ms, compile {:9.1f} ms\n",
+            frameMs, percentile(submitMs, 0.50f), percentile(latencyMs, 0.50f), compileMs);
+
+        // Rolling over the profiler's history, which the measured frames make up most of
+        auto gpuTotalMs = 0.0f;
+        for (const auto& [pass, average, p50, p95, p99, sampleCount] : engine->getPassTimings()) {
+            const auto key = std::format("{}.gpu.{}", name, pass);
+            report.set(key + ".averageMs", average);
+            report.set(key + ".p95Ms", p95);
+            gpuTotalMs += average;
+            std::cout << std::format("  gpu    {:<12} {:9.3f} ms (p95 {:8.3f} ms, {} samples)\n", pass, average, p95, sampleCount);
+        }
+        report.set(name + ".gpu.totalMs", gpuTotalMs);
+
+        report.set(name + ".tilesRendered", static_cast<double>(tilesRendered));
+        report.set(name + ".maxTilesRendered", maxTilesRendered);
+        report.set(name + ".visibleGaussians", static_cast<double>(visibleGaussians));
+        std::cout << std::format("  tiles  {} over the orbit, {} at most in a frame\n", tilesRendered, maxTilesRendered);
+
+        const auto memory = engine->getMemoryUsage();
+        const auto sortBuffers = engine->getSortBufferStatistics();
+        report.set(name + ".deviceAllocationBytes", static_cast<double>(memory.allocationBytes));
+        report.set(name + ".deviceBlockBytes", static_cast<double>(memory.blockBytes));
+        report.set(name + ".sortBufferBytes", static_cast<double>(sortBuffers.bytes));
+        std::cout << std::format("  memory {:9.1f} MiB allocated, {:9.1f} MiB in blocks, {:9.1f} MiB for sorting\n",
+            static_cast<double>(memory.allocationBytes) / (1 << 20), static_cast<double>(memory.blockBytes) / (1 << 20),
+            static_cast<double>(sortBuffers.bytes) / (1 << 20));
+    }
+} // namespace
+
+int main(const int argc, char** argv) try {
+    const auto options = parseOptions(argc, argv);
+    if (options.help) {
+        std::cout << USAGE;
+        return 0;
+    }
+    tpd::utils::plantConsoleLogger();
+
+    auto report = tpd::bench::BenchReport{};
+    report.set("width", options.width);
+    report.set("height", options.height);
+    report.set("frames", options.frames);
+    report.set("shDegree", options.shDegree);
+    report.set("halfPrecision", options.halfPrecision ? 1.0 : 0.0);
+
+    for (const auto exponent : options.exponents) {
+        const auto count = static_cast<uint32_t>(std::pow(10.0, exponent));
+        const auto points = tpd::bench::generateScene(count);
+        runScene(std::format("synthetic-1e{}", exponent), points, { 0.0f, 1.0f, 0.0f }, options, report);
+    }
+    if (!options.ply.empty()) {
+        const auto points = tpd::GaussianPoint::fromModel(options.ply);
+        runScene("ply-" + options.ply.stem().string(), points, { 0.0f, -1.0f, 0.0f }, options, report);
+    }
+
+    report.save(options.output);
+    std::cout << std::format("Results written to {}\n", options.output.string());
+
+    if (options.baseline.empty()) {
+        return 0;
+    }
+    std::cout << std::format("Comparing against {} (tolerance {:.0f}%):\n", options.baseline.string(), options.tolerance * 100.0f);
+    const auto baseline = tpd::bench::BenchReport::load(options.baseline);
+    const auto regressionCount = tpd::bench::compare(report, baseline, options.tolerance, options.noiseFloorMs, std::cout);
+    std::cout << std::format("{} regression(s)\n", regressionCount);
+    return regressionCount > 0 ? 1 : 0;
+} catch (const UsageError& e) {
+    std::cerr << e.what() << "\n\n" << USAGE;
+    return 2;
+} catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 2;
+}
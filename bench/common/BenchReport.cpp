@@ -0,0 +1,233 @@
+#include "BenchReport.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    std::string escape(const std::string_view text) {
+        auto escaped = std::string{};
+        for (const auto c : text) {
+            switch (c) {
+                case '"':  escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n";  break;
+                case '\t': escaped += "\\t";  break;
+                default:   escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // Just enough JSON to read back a flat object of numbers and strings, as written by BenchReport::save
+    class FlatJsonReader {
+    public:
+        explicit FlatJsonReader(std::string text) : _text{ std::move(text) } {}
+
+        void expect(const char c) {
+            skipSpaces();
+            if (_cursor >= _text.size() || _text[_cursor] != c) [[unlikely]] {
+                throw std::runtime_error(std::format("BenchReport - Expected '{}' at offset {} of the baseline", c, _cursor));
+            }
+            ++_cursor;
+        }
+
+        [[nodiscard]] bool consume(const char c) {
+            skipSpaces();
+            if (_cursor < _text.size() && _text[_cursor] == c) {
+                ++_cursor;
+                return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool peek(const char c) {
+            skipSpaces();
+            return _cursor < _text.size() && _text[_cursor] == c;
+        }
+
+        [[nodiscard]] std::string readString() {
+            expect('"');
+            auto result = std::string{};
+            while (_cursor < _text.size() && _text[_cursor] != '"') {
+                if (_text[_cursor] == '\\' && _cursor + 1 < _text.size()) {
+                    ++_cursor;
+                    switch (_text[_cursor]) {
+                        case 'n': result += '\n'; break;
+                        case 't': result += '\t'; break;
+                        default:  result += _text[_cursor];
+                    }
+                } else {
+                    result += _text[_cursor];
+                }
+                ++_cursor;
+            }
+            expect('"');
+            return result;
+        }
+
+        // Literals other than numbers (true, false, null) carry nothing to compare and read as nullopt
+        [[nodiscard]] std::optional<double> readNumber() {
+            skipSpaces();
+            const auto begin = _cursor;
+            while (_cursor < _text.size() && std::string_view{ "+-.0123456789eEtruefalsn" }.contains(_text[_cursor])) {
+                ++_cursor;
+            }
+            const auto token = _text.substr(begin, _cursor - begin);
+            if (token == "true" || token == "false" || token == "null") {
+                return std::nullopt;
+            }
+            try {
+                auto consumed = 0uz;
+                const auto value = std::stod(token, &consumed);
+                if (consumed == token.size()) return value;
+            } catch (const std::exception&) {}
+            throw std::runtime_error(std::format("BenchReport - Invalid value '{}' at offset {} of the baseline", token, begin));
+        }
+
+    private:
+        void skipSpaces() noexcept {
+            while (_cursor < _text.size() && std::isspace(static_cast<unsigned char>(_text[_cursor]))) ++_cursor;
+        }
+
+        std::string _text;
+        std::size_t _cursor{ 0 };
+    };
+
+    enum class Metric { Cost, Throughput, Count };
+
+    Metric classify(const std::string_view key) noexcept {
+        if (key.ends_with("Ms") || key.ends_with("Bytes")) return Metric::Cost;
+        if (key.ends_with("PerSecond")) return Metric::Throughput;
+        return Metric::Count;
+    }
+} // namespace
+
+void tpd::bench::BenchReport::set(std::string key, const double value) {
+    const auto entry = std::ranges::find(_entries, key, &Entry::key);
+    if (entry != _entries.end()) entry->value = value;
+    else _entries.emplace_back(std::move(key), value);
+}
+
+void tpd::bench::BenchReport::set(std::string key, std::string value) {
+    const auto entry = std::ranges::find(_entries, key, &Entry::key);
+    if (entry != _entries.end()) entry->value = std::move(value);
+    else _entries.emplace_back(std::move(key), std::move(value));
+}
+
+const tpd::bench::BenchReport::Value* tpd::bench::BenchReport::find(const std::string_view key) const noexcept {
+    const auto entry = std::ranges::find(_entries, key, &Entry::key);
+    return entry != _entries.end() ? &entry->value : nullptr;
+}
+
+void tpd::bench::BenchReport::save(const std::filesystem::path& file) const {
+    auto json = std::ofstream{ file };
+    if (!json.is_open()) [[unlikely]] {
+        throw std::runtime_error("BenchReport - Failed to open file for writing: " + file.string());
+    }
+
+    json << "{\n";
+    for (auto i = 0uz; i < _entries.size(); ++i) {
+        const auto& [key, value] = _entries[i];
+        json << "  \"" << escape(key) << "\": ";
+        if (const auto number = std::get_if<double>(&value)) {
+            // JSON has no representation of NaN or infinity, such a sample is as good as missing
+            json << (std::isfinite(*number) ? std::format("{}", *number) : "null");
+        } else {
+            json << '"' << escape(std::get<std::string>(value)) << '"';
+        }
+        json << (i + 1 < _entries.size() ? ",\n" : "\n");
+    }
+    json << "}\n";
+}
+
+tpd::bench::BenchReport tpd::bench::BenchReport::load(const std::filesystem::path& file) {
+    auto json = std::ifstream{ file };
+    if (!json.is_open()) [[unlikely]] {
+        throw std::runtime_error("BenchReport - Failed to open baseline: " + file.string());
+    }
+    auto text = std::stringstream{};
+    text << json.rdbuf();
+
+    auto report = BenchReport{};
+    auto reader = FlatJsonReader{ text.str() };
+    reader.expect('{');
+    if (reader.consume('}')) {
+        return report;
+    }
+    do {
+        auto key = reader.readString();
+        reader.expect(':');
+        if (reader.peek('"')) {
+            report.set(std::move(key), reader.readString());
+        } else if (const auto number = reader.readNumber()) {
+            report.set(std::move(key), *number);
+        }
+    } while (reader.consume(','));
+    reader.expect('}');
+    return report;
+}
+
+uint32_t tpd::bench::compare(
+    const BenchReport& current,
+    const BenchReport& baseline,
+    const float tolerance,
+    const float noiseFloorMs,
+    std::ostream& out)
+{
+    auto regressionCount = 0u;
+    for (const auto& [key, baselineValue] : baseline.getEntries()) {
+        const auto currentValue = current.find(key);
+        if (!currentValue) {
+            out << std::format("  {:<56} missing from this run\n", key);
+            continue;
+        }
+
+        if (const auto text = std::get_if<std::string>(&baselineValue)) {
+            if (const auto currentText = std::get_if<std::string>(currentValue); currentText && *currentText != *text) {
+                out << std::format("  {:<56} '{}' -> '{}'\n", key, *text, *currentText);
+            }
+            continue;
+        }
+
+        const auto before = std::get<double>(baselineValue);
+        const auto now = std::get_if<double>(currentValue);
+        if (!now) {
+            continue;
+        }
+        const auto after = *now;
+        const auto change = before != 0.0 ? (after - before) / before : (after != 0.0 ? 1.0 : 0.0);
+
+        auto verdict = std::string_view{};
+        switch (classify(key)) {
+            case Metric::Cost:
+                // Short stages jitter by a few microseconds regardless of how much they relatively change
+                if (key.ends_with("Ms") && std::abs(after - before) < noiseFloorMs) break;
+                if (change > tolerance) verdict = "REGRESSED";
+                else if (change < -tolerance) verdict = "improved";
+                break;
+            case Metric::Throughput:
+                if (change < -tolerance) verdict = "REGRESSED";
+                else if (change > tolerance) verdict = "improved";
+                break;
+            case Metric::Count:
+                if (after != before) verdict = "CHANGED";
+                break;
+        }
+
+        if (!verdict.empty()) {
+            out << std::format("  {:<56} {:>14.4f} -> {:>14.4f} ({:+6.1f}%) {}\n", key, before, after, change * 100.0, verdict);
+            regressionCount += verdict == "improved" ? 0 : 1;
+        }
+    }
+    return regressionCount;
+}
+
+float tpd::bench::percentile(const std::vector<float>& sortedSamples, const float p) noexcept {
+    if (sortedSamples.empty()) return 0.0f;
+    return sortedSamples[static_cast<std::size_t>(p * static_cast<float>(sortedSamples.size() - 1) + 0.5f)];
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace tpd::bench {
+    // Results of a benchmark run as a flat JSON object, keyed by dotted paths such as "synthetic-1e5.gpu.Blend.p50Ms".
+    // The suffix of a key tells how it compares against a baseline:
+    //  - "Ms" and "Bytes" are costs, which regress when they grow beyond the tolerance
+    //  - "PerSecond" is a throughput, which regresses when it shrinks beyond the tolerance
+    //  - any other number is a count (e.g. tilesRendered) that a deterministic run must reproduce exactly
+    // Strings describe the run (device, kernel names) and are reported when they differ, but never fail a comparison.
+    class BenchReport final {
+    public:
+        using Value = std::variant<double, std::string>;
+
+        void set(std::string key, double value);
+        void set(std::string key, std::string value);
+
+        [[nodiscard]] const Value* find(std::string_view key) const noexcept;
+
+        void save(const std::filesystem::path& file) const;
+        [[nodiscard]] static BenchReport load(const std::filesystem::path& file);
+
+        struct Entry {
+            std::string key;
+            Value value;
+        };
+
+        [[nodiscard]] const std::vector<Entry>& getEntries() const noexcept;
+
+    private:
+        std::vector<Entry> _entries{}; // in the order they were first set
+    };
+
+    // Compares every number of the current run with the baseline's, printing one line per key that regressed, improved
+    // or went missing. Differences below the noise floor are ignored for timings. Returns the number of regressions.
+    [[nodiscard]] uint32_t compare(
+        const BenchReport& current, const BenchReport& baseline,
+        float tolerance, float noiseFloorMs, std::ostream& out);
+
+    // Same rule as TimestampProfiler::getStats, expects sorted samples
+    [[nodiscard]] float percentile(const std::vector<float>& sortedSamples, float p) noexcept;
+} // namespace tpd::bench
+
+inline const std::vector<tpd::bench::BenchReport::Entry>& tpd::bench::BenchReport::getEntries() const noexcept {
+    return _entries;
+}
@@ -0,0 +1,78 @@
+#include "SyntheticScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <ranges>
+
+std::vector<tpd::GaussianPoint> tpd::bench::generateScene(const uint32_t count, const uint64_t seed) {
+    auto rng = SplitMix64{ seed };
+
+    // Keeps the summed footprint of all splats growing with the cube root of the count rather than linearly
+    const auto baseScale = SYNTHETIC_SCENE_RADIUS * 1.5f / std::cbrt(static_cast<float>(std::max(count, 1u)));
+
+    auto points = std::vector<GaussianPoint>(count);
+    for (auto& [position, opacity, quaternion, scale, sh] : points) {
+        // Rejection sampling only takes square roots, whose results are exact everywhere, unlike sin and cos
+        auto p = vec3{};
+        do {
+            p = vec3{ rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f) };
+        } while (math::dot(p, p) > 1.0f);
+        position = p * SYNTHETIC_SCENE_RADIUS;
+
+        auto q = vec4{};
+        auto lengthSquared = 0.0f;
+        do {
+            q = vec4{ rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f) };
+            lengthSquared = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+        } while (lengthSquared > 1.0f || lengthSquared < 1e-4f);
+        const auto length = std::sqrt(lengthSquared);
+        quaternion = vec4{ q.x / length, q.y / length, q.z / length, q.w / length };
+
+        opacity = rng.uniform(0.05f, 1.0f);
+        scale = vec4{ rng.uniform(0.2f, 1.0f), rng.uniform(0.2f, 1.0f), rng.uniform(0.2f, 1.0f), baseScale };
+
+        sh = utils::rgb2sh(rng.uniform(), rng.uniform(), rng.uniform());
+        std::ranges::generate(sh | std::views::drop(3), [&rng] { return rng.uniform(-0.1f, 0.1f); });
+    }
+    return points;
+}
+
+tpd::bench::Bounds tpd::bench::getBounds(const std::span<const GaussianPoint> points) {
+    if (points.empty()) {
+        return { vec3{ 0.0f, 0.0f, 0.0f }, 1.0f };
+    }
+
+    auto center = vec3{ 0.0f, 0.0f, 0.0f };
+    for (const auto& point : points) {
+        center = center + point.position;
+    }
+    center = center / static_cast<float>(points.size());
+
+    // Trained scenes are surrounded by sparse floaters, which would put the camera much too far from the subject
+    auto distances = std::vector<float>(points.size());
+    std::ranges::transform(points, distances.begin(), [&center](const auto& point) { return math::norm(point.position - center); });
+    const auto nth = distances.begin() + static_cast<std::ptrdiff_t>(static_cast<double>(distances.size() - 1) * 0.95);
+    std::ranges::nth_element(distances, nth);
+
+    return { center, std::max(*nth, 1e-3f) };
+}
+
+std::vector<tpd::bench::CameraPose> tpd::bench::getOrbitPath(const Bounds& bounds, const vec3& up, const uint32_t frameCount) {
+    // Any direction perpendicular to up starts the orbit
+    const auto upAxis = math::normalize(up);
+    const auto helper = std::abs(upAxis.x) < 0.9f ? vec3{ 1.0f, 0.0f, 0.0f } : vec3{ 0.0f, 1.0f, 0.0f };
+    const auto side = math::normalize(math::cross(upAxis, helper));
+    const auto front = math::cross(side, upAxis);
+
+    // Far enough for the bounds to fit in the 60-degree field of view of PerspectiveCamera
+    const auto distance = bounds.radius * 2.2f;
+
+    auto path = std::vector<CameraPose>(frameCount);
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        const auto angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(frameCount);
+        const auto offset = side * std::cos(angle) + front * std::sin(angle) + upAxis * (0.3f * std::sin(2.0f * angle));
+        path[i] = { bounds.center + offset * distance, bounds.center };
+    }
+    return path;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <torpedo/volumetric/GaussianGeometry.h>
+
+#include <span>
+
+namespace tpd::bench {
+    // Deterministic across platforms and standard libraries, which the distributions of <random> are not: synthetic
+    // scenes of the same size and seed must produce the same tilesRendered wherever a baseline is compared.
+    class SplitMix64 final {
+    public:
+        explicit constexpr SplitMix64(const uint64_t seed) noexcept : _state{ seed } {}
+
+        [[nodiscard]] constexpr uint64_t next() noexcept;
+        [[nodiscard]] constexpr float uniform() noexcept; // in [0, 1)
+        [[nodiscard]] constexpr float uniform(float min, float max) noexcept;
+
+    private:
+        uint64_t _state;
+    };
+
+    // Radius of the ball every synthetic scene fills, regardless of its size
+    constexpr float SYNTHETIC_SCENE_RADIUS = 10.0f;
+
+    // Gaussians spread over a ball, with random orientations and anisotropic scales shrinking with the cube root of the
+    // count, so that depth complexity keeps growing with the scene while each splat stays a few tiles wide. Colors are
+    // view dependent up to the third spherical harmonics degree.
+    [[nodiscard]] std::vector<GaussianPoint> generateScene(uint32_t count, uint64_t seed = 42);
+
+    struct Bounds {
+        vec3 center;
+        float radius; // around the center, ignoring the farthest few percent of points
+    };
+
+    [[nodiscard]] Bounds getBounds(std::span<const GaussianPoint> points);
+
+    struct CameraPose {
+        vec3 eye;
+        vec3 target;
+    };
+
+    // One lap around the bounds, bobbing up and down twice, always looking at the center
+    [[nodiscard]] std::vector<CameraPose> getOrbitPath(const Bounds& bounds, const vec3& up, uint32_t frameCount);
+} // namespace tpd::bench
+
+constexpr uint64_t tpd::bench::SplitMix64::next() noexcept {
+    auto z = _state += 0x9E3779B97F4A7C15;
+    z = (z ^ z >> 30) * 0xBF58476D1CE4E5B9;
+    z = (z ^ z >> 27) * 0x94D049BB133111EB;
+    return z ^ z >> 31;
+}
+
+constexpr float tpd::bench::SplitMix64::uniform() noexcept {
+    return static_cast<float>(next() >> 40) * 0x1.0p-24f; // the 24 bits a float can represent exactly
+}
+
+constexpr float tpd::bench::SplitMix64::uniform(const float min, const float max) noexcept {
+    return min + (max - min) * uniform();
+}
@@ -1,7 +1,10 @@
 # TORPEDO BUILD OPTIONS
 # ---------------------
 option(TORPEDO_BUILD_DEMO "Build torpedo demo targets" OFF)
+option(TORPEDO_BUILD_BENCH "Build torpedo benchmark targets" OFF)
+option(TORPEDO_BUILD_TESTS "Build torpedo test targets, run them with ctest" OFF)
 option(TORPEDO_BUILD_PEDO "Build pedo Gaussian engine" ON)
+option(TORPEDO_ENABLE_TRACING "Compile in host-side tracing zones, see FrameTracer.h" OFF)
 
 # Default to Release build
 if (NOT CMAKE_BUILD_TYPE)
@@ -13,8 +16,11 @@ message(STATUS "Configuring for ${CMAKE_BUILD_TYPE} build:")
 if (CMAKE_BUILD_TYPE STREQUAL "Debug" AND NOT TORPEDO_BUILD_DEMO)
     set(TORPEDO_BUILD_DEMO ON)
 endif()
-message(STATUS "+ Build demo: ${TORPEDO_BUILD_DEMO}")
-message(STATUS "+ Build pedo: ${TORPEDO_BUILD_PEDO}")
+message(STATUS "+ Build demo:  ${TORPEDO_BUILD_DEMO}")
+message(STATUS "+ Build bench: ${TORPEDO_BUILD_BENCH}")
+message(STATUS "+ Build tests: ${TORPEDO_BUILD_TESTS}")
+message(STATUS "+ Build pedo:  ${TORPEDO_BUILD_PEDO}")
+message(STATUS "+ Tracing:     ${TORPEDO_ENABLE_TRACING}")
 
 
 # GLFW SPECIFICS
@@ -0,0 +1,31 @@
+# Generates a C++ translation unit embedding SPIR-V binaries as constexpr word arrays, run in script mode:
+# cmake -DMODULE_NAME=<name> -DHEADER_NAME=<header> -DSPIR_V_FILES=<a.spv;b.spv> -DOUTPUT=<file.cpp> -P EmbedSpirv.cmake
+cmake_minimum_required(VERSION 3.25)
+
+set(ARRAYS "")
+set(LOOKUPS "")
+
+foreach(SPIR_V ${SPIR_V_FILES})
+    # The lookup key is the source file name, i.e. project.slang for project.slang.spv
+    get_filename_component(FILE_NAME ${SPIR_V} NAME)
+    string(REGEX REPLACE "\\.spv$" "" KEY ${FILE_NAME})
+    string(MAKE_C_IDENTIFIER ${KEY} IDENTIFIER)
+
+    # SPIR-V is a stream of little-endian 32-bit words
+    file(READ ${SPIR_V} HEX_CONTENT HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" "0x\\4\\3\\2\\1u," WORDS "${HEX_CONTENT}")
+    string(REGEX REPLACE "(0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,)" "\\1\n        " WORDS "${WORDS}")
+    string(REGEX REPLACE "\n        $" "" WORDS "${WORDS}")
+
+    string(APPEND ARRAYS "    constexpr uint32_t ${IDENTIFIER}[] = {\n        ${WORDS}\n    };\n\n")
+    string(APPEND LOOKUPS "    if (slangFile == \"${KEY}\") return ${IDENTIFIER};\n")
+endforeach()
+
+set(CONTENT "// Generated by torpedo_compile_slang, do not edit\n")
+string(APPEND CONTENT "#include \"${HEADER_NAME}\"\n\n")
+string(APPEND CONTENT "namespace {\n${ARRAYS}} // namespace\n\n")
+string(APPEND CONTENT "std::span<const uint32_t> tpd::spirv::${MODULE_NAME}(const std::string_view slangFile) noexcept {\n")
+string(APPEND CONTENT "${LOOKUPS}    return {};\n}\n")
+
+# Only touch the output if its content has changed to avoid needless recompilation
+file(CONFIGURE OUTPUT ${OUTPUT} CONTENT "${CONTENT}" @ONLY)
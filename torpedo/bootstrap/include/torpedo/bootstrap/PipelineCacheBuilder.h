@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <filesystem>
+
+namespace tpd {
+    class PipelineCacheBuilder {
+    public:
+        PipelineCacheBuilder& cacheDirectory(const std::filesystem::path& directory);
+
+        // Returns an empty cache if there is no valid cache file for the device under the cache directory
+        [[nodiscard]] vk::PipelineCache build(vk::PhysicalDevice physicalDevice, vk::Device device) const;
+
+    private:
+        [[nodiscard]] static bool compatible(const std::vector<char>& data, const vk::PhysicalDeviceProperties& properties) noexcept;
+
+        std::filesystem::path _cacheDirectory{};
+    };
+
+    namespace utils {
+        // Cache blobs are only valid for the device and driver that produced them, so both are part of the file name
+        [[nodiscard]] std::filesystem::path getPipelineCacheFile(const std::filesystem::path& directory, vk::PhysicalDevice physicalDevice);
+
+        // Returns false if the cache could not be written, which is never fatal
+        bool savePipelineCache(vk::PipelineCache cache, const std::filesystem::path& directory, vk::PhysicalDevice physicalDevice, vk::Device device);
+    } // namespace utils
+}  // namespace tpd
+
+inline tpd::PipelineCacheBuilder& tpd::PipelineCacheBuilder::cacheDirectory(const std::filesystem::path& directory) {
+    _cacheDirectory = directory;
+    return *this;
+}
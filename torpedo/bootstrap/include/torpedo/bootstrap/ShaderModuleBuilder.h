@@ -3,15 +3,26 @@
 #include <vulkan/vulkan.hpp>
 
 #include <filesystem>
+#include <span>
 
 namespace tpd {
     class ShaderModuleBuilder {
     public:
         ShaderModuleBuilder& spirvPath(const std::filesystem::path& path);
 
+        // The code is referenced, not copied, and must outlive the build() call
+        ShaderModuleBuilder& spirvCode(std::span<const uint32_t> code) noexcept;
+
         [[nodiscard]] vk::ShaderModule build(vk::Device device) const;
 
     private:
-        std::vector<std::byte> _shaderCode{};
+        std::vector<uint32_t> _shaderCode{};
+        std::span<const uint32_t> _externalCode{};
     };
 }
+
+inline tpd::ShaderModuleBuilder& tpd::ShaderModuleBuilder::spirvCode(const std::span<const uint32_t> code) noexcept {
+    _shaderCode.clear();
+    _externalCode = code;
+    return *this;
+}
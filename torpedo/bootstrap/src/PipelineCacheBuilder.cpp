@@ -0,0 +1,100 @@
+#include "torpedo/bootstrap/PipelineCacheBuilder.h"
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+#include <thread>
+
+vk::PipelineCache tpd::PipelineCacheBuilder::build(const vk::PhysicalDevice physicalDevice, const vk::Device device) const {
+    auto data = std::vector<char>{};
+
+    if (const auto file = utils::getPipelineCacheFile(_cacheDirectory, physicalDevice); std::filesystem::exists(file)) {
+        auto stream = std::ifstream{ file, std::ios::ate | std::ios::binary };
+        if (stream.is_open()) {
+            data.resize(static_cast<size_t>(stream.tellg()));
+            stream.seekg(0);
+            stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+    }
+
+    // Drivers are supposed to reject foreign blobs, but not all of them do it gracefully
+    if (!compatible(data, physicalDevice.getProperties())) {
+        data.clear();
+    }
+
+    auto cacheInfo = vk::PipelineCacheCreateInfo{};
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.data();
+    return device.createPipelineCache(cacheInfo);
+}
+
+bool tpd::PipelineCacheBuilder::compatible(const std::vector<char>& data, const vk::PhysicalDeviceProperties& properties) noexcept {
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+        return false;
+    }
+
+    auto header = VkPipelineCacheHeaderVersionOne{};
+    std::memcpy(&header, data.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+    return header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+std::filesystem::path tpd::utils::getPipelineCacheFile(const std::filesystem::path& directory, const vk::PhysicalDevice physicalDevice) {
+    const auto properties = physicalDevice.getProperties();
+
+    auto uuid = std::string{};
+    for (const auto byte : properties.pipelineCacheUUID) {
+        uuid += std::format("{:02x}", byte);
+    }
+    return directory / std::format("{}-{:x}.bin", uuid, properties.driverVersion);
+}
+
+bool tpd::utils::savePipelineCache(
+    const vk::PipelineCache cache,
+    const std::filesystem::path& directory,
+    const vk::PhysicalDevice physicalDevice,
+    const vk::Device device)
+{
+    auto error = std::error_code{};
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return false;
+    }
+
+    const auto data = device.getPipelineCacheData(cache);
+    const auto file = getPipelineCacheFile(directory, physicalDevice);
+
+    // Write to a temporary file first so that a concurrent reader never sees a partially written cache. Writers in
+    // this and other processes may be saving the same cache, so each of them gets a temporary file of its own.
+    static const auto processToken = std::random_device{}();
+    static auto saveCount = std::atomic_uint32_t{ 0 };
+    const auto threadToken = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    auto temp = file;
+    temp += std::format(".{:08x}-{:x}-{}.tmp", processToken, threadToken, saveCount.fetch_add(1, std::memory_order_relaxed));
+    {
+        auto stream = std::ofstream{ temp, std::ios::binary | std::ios::trunc };
+        if (!stream.is_open()) {
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!stream) {
+            stream.close();
+            std::filesystem::remove(temp, error);
+            return false;
+        }
+    }
+
+    // The last writer wins, every one of them renames a complete cache into place
+    std::filesystem::rename(temp, file, error);
+    if (error) {
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+    return true;
+}
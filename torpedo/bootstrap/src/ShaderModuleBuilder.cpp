@@ -1,7 +1,6 @@
 #include "torpedo/bootstrap/ShaderModuleBuilder.h"
 
 #include <fstream>
-#include <ranges>
 
 tpd::ShaderModuleBuilder& tpd::ShaderModuleBuilder::spirvPath(const std::filesystem::path& path) {
     // Reading from the end of the file as binary format to determine the file size
@@ -10,26 +9,27 @@ tpd::ShaderModuleBuilder& tpd::ShaderModuleBuilder::spirvPath(const std::filesys
         throw std::runtime_error("ShaderModuleBuilder - Failed to open file: " + path.string());
     }
 
+    // SPIR-V is a stream of 32-bit words, read them in place
     const auto fileSize = static_cast<size_t>(file.tellg());
-    auto buffer = std::vector<char>(fileSize);
+    _shaderCode.resize((fileSize + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    _externalCode = {};
 
     file.seekg(0);
-    file.read(buffer.data(), static_cast<std::streamsize>(fileSize));
+    file.read(reinterpret_cast<char*>(_shaderCode.data()), static_cast<std::streamsize>(fileSize));
     file.close();
 
-    _shaderCode = buffer
-        | std::views::transform([](const auto it) { return static_cast<std::byte>(it); })
-        | std::ranges::to<std::vector>();
-
     return *this;
 }
 
 vk::ShaderModule tpd::ShaderModuleBuilder::build(const vk::Device device) const {
-    if (_shaderCode.empty()) {
-        throw std::runtime_error("ShaderModuleBuilder - Shader code is empty: did you forget to call ShaderModuleBuilder::spirvPath()?");
+    const auto code = _shaderCode.empty() ? _externalCode : std::span{ _shaderCode };
+    if (code.empty()) {
+        throw std::runtime_error(
+            "ShaderModuleBuilder - Shader code is empty: "
+            "did you forget to call ShaderModuleBuilder::spirvPath() or ShaderModuleBuilder::spirvCode()?");
     }
     auto shaderModuleCreateInfo = vk::ShaderModuleCreateInfo{};
-    shaderModuleCreateInfo.codeSize = static_cast<uint32_t>(_shaderCode.size());
-    shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(_shaderCode.data());
+    shaderModuleCreateInfo.codeSize = code.size_bytes();
+    shaderModuleCreateInfo.pCode = code.data();
     return device.createShaderModule(shaderModuleCreateInfo);
 }
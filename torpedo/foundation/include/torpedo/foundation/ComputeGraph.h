@@ -0,0 +1,118 @@
+#pragma once
+
+#include "torpedo/foundation/VmaUsage.h"
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace tpd {
+    // A linear sequence of compute and transfer passes recorded into a single command buffer. Each pass declares the
+    // resources it reads and writes, from which the graph derives the minimal set of global memory barriers between
+    // passes, and places transient buffers whose lifetimes don't overlap in the same memory.
+    class ComputeGraph final {
+    public:
+        using Resource = uint32_t;
+        using RecordFunction = std::function<void(vk::CommandBuffer)>;
+
+        enum class PassType { Compute, Transfer };
+
+        class Builder {
+        public:
+            // Transient buffers are owned by the graph, their contents are undefined at the start of each execution
+            [[nodiscard]] Resource transient(std::string_view name, vk::DeviceSize size, vk::BufferUsageFlags usage = {});
+
+            // Imported resources are owned elsewhere and only take part in hazard tracking
+            [[nodiscard]] Resource import(std::string_view name);
+
+            // Passes are executed in the order they are added
+            Builder& pass(
+                std::string_view name, PassType type,
+                std::initializer_list<Resource> reads, std::initializer_list<Resource> writes,
+                RecordFunction&& record);
+
+            Builder& aliasing(bool enabled) noexcept; // place every transient in its own memory range when disabled
+
+            [[nodiscard]] ComputeGraph build(vk::Device device, VmaAllocator allocator) const;
+
+        private:
+            struct ResourceInfo {
+                std::string name;
+                vk::DeviceSize size;
+                vk::BufferUsageFlags usage;
+                bool transient;
+            };
+
+            struct PassInfo {
+                std::string name;
+                PassType type;
+                std::vector<Resource> reads;
+                std::vector<Resource> writes;
+                RecordFunction record;
+            };
+
+            std::vector<ResourceInfo> _resources{};
+            std::vector<PassInfo> _passes{};
+            bool _aliasing{ true };
+        };
+
+        struct Statistics {
+            uint32_t passCount{ 0 };
+            uint32_t barrierCount{ 0 };         // per execution of the graph
+            vk::DeviceSize transientBytes{ 0 }; // peak memory held by transient buffers
+            vk::DeviceSize unaliasedBytes{ 0 }; // what transient buffers would take without aliasing
+        };
+
+        ComputeGraph() noexcept = default;
+
+        ComputeGraph(ComputeGraph&& other) noexcept;
+        ComputeGraph& operator=(ComputeGraph&& other) noexcept;
+
+        // Every resource is assumed to have been written by compute or transfer work submitted earlier, so the first
+        // pass is always preceded by a barrier synchronizing it with the previous execution of the graph
+        void record(vk::CommandBuffer cmd) const;
+
+        [[nodiscard]] vk::Buffer getBuffer(Resource resource) const noexcept;
+        [[nodiscard]] vk::DeviceSize getSize(Resource resource) const noexcept;
+        [[nodiscard]] const Statistics& getStatistics() const noexcept;
+        [[nodiscard]] bool valid() const noexcept;
+
+        void destroy(vk::Device device, VmaAllocator allocator) noexcept;
+
+    private:
+        struct Pass {
+            std::string name;
+            RecordFunction record;
+            bool barrier;
+            vk::MemoryBarrier2 memoryBarrier;
+        };
+
+        std::vector<Pass> _passes{};
+        std::vector<vk::Buffer> _buffers{}; // null for imported resources
+        std::vector<vk::DeviceSize> _sizes{};
+        VmaAllocation _allocation{ nullptr };
+        Statistics _statistics{};
+    };
+} // namespace tpd
+
+inline tpd::ComputeGraph::Builder& tpd::ComputeGraph::Builder::aliasing(const bool enabled) noexcept {
+    _aliasing = enabled;
+    return *this;
+}
+
+inline vk::Buffer tpd::ComputeGraph::getBuffer(const Resource resource) const noexcept {
+    return _buffers[resource];
+}
+
+inline vk::DeviceSize tpd::ComputeGraph::getSize(const Resource resource) const noexcept {
+    return _sizes[resource];
+}
+
+inline const tpd::ComputeGraph::Statistics& tpd::ComputeGraph::getStatistics() const noexcept {
+    return _statistics;
+}
+
+inline bool tpd::ComputeGraph::valid() const noexcept {
+    return !_passes.empty();
+}
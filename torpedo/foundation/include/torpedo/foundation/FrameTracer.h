@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// Zones compile down to nothing unless the library is configured with -DTORPEDO_ENABLE_TRACING=ON
+#ifdef TORPEDO_ENABLE_TRACING
+    #define TPD_TRACE_CONCAT_IMPL(a, b) a##b
+    #define TPD_TRACE_CONCAT(a, b) TPD_TRACE_CONCAT_IMPL(a, b)
+    #define TPD_TRACE_ZONE(name) const auto TPD_TRACE_CONCAT(tpdTraceZone, __LINE__) = tpd::FrameTracer::Zone{ name }
+    #define TPD_TRACE_THREAD(name) tpd::FrameTracer::setThreadName(name)
+#else
+    #define TPD_TRACE_ZONE(name) static_cast<void>(0)
+    #define TPD_TRACE_THREAD(name) static_cast<void>(0)
+#endif
+
+namespace tpd {
+    class FrameTracer final {
+    public:
+        // Records the scope it lives in as a zone on the calling thread, name must outlive the tracer (a literal)
+        class Zone {
+        public:
+            explicit Zone(const char* name) noexcept;
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+            ~Zone() noexcept;
+
+        private:
+            const char* _name;
+            uint64_t _begin;
+        };
+
+        // Tracing is off by default even when compiled in, zones created while disabled record nothing
+        static void setEnabled(bool enabled) noexcept;
+        [[nodiscard]] static bool enabled() noexcept;
+
+        static void setThreadName(std::string_view name);
+
+        // Nanoseconds on the tracer's timeline, which GPU zones must be mapped onto before being recorded
+        [[nodiscard]] static uint64_t now() noexcept;
+
+        // Lock-free, each thread writes into its own buffer and drops events when the buffer is full
+        static void recordZone(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+        // GPU zones arrive at most once per frame per profiler, a mutex is fine here
+        static void recordGpuZone(std::string_view track, std::string_view name, uint64_t begin, uint64_t end);
+
+        // Drains all events recorded so far into a Chrome trace JSON file, viewable in Perfetto or chrome://tracing
+        static bool exportChromeTrace(const std::filesystem::path& file);
+        static void clear();
+
+    private:
+        static std::atomic<bool> _enabled;
+    };
+} // namespace tpd
+
+inline bool tpd::FrameTracer::enabled() noexcept {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline void tpd::FrameTracer::setEnabled(const bool enabled) noexcept {
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+inline tpd::FrameTracer::Zone::Zone(const char* name) noexcept
+    : _name{ enabled() ? name : nullptr }, _begin{ _name ? now() : 0 } {
+}
+
+inline tpd::FrameTracer::Zone::~Zone() noexcept {
+    if (_name) recordZone(_name, _begin, now());
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+namespace tpd {
+    // Single-pass exclusive prefix scan over 32-bit unsigned integers with decoupled look-back. Buffers are accessed
+    // through their device addresses and must be created with eShaderDeviceAddress usage, items and their sum must
+    // fit in 30 bits.
+    class GpuPrefixScan final {
+    public:
+        class Builder {
+        public:
+            Builder& pipelineCache(vk::PipelineCache cache) noexcept;
+
+            // Scan within each workgroup with subgroup arithmetic rather than shared memory sweeps. Only enable this
+            // if subgroupSupported() and the device was created with the computeFullSubgroups feature.
+            Builder& subgroupKernels(bool enabled) noexcept;
+
+            [[nodiscard]] GpuPrefixScan build(vk::Device device) const;
+
+        private:
+            vk::PipelineCache _pipelineCache{};
+            bool _subgroupKernels{ false };
+        };
+
+        struct Input {
+            vk::Buffer data{};           // scanned in place
+            vk::DeviceSize offset{ 0 };  // of the first item, in bytes
+            uint32_t count{ 0 };
+            uint32_t stride{ 1 };        // between items in 32-bit words, allowing to scan a member of an array of structs
+            vk::Buffer scratch{};        // at least getScratchSize(count) bytes, with eTransferDst usage
+            vk::Buffer total{};          // optional, receives the sum of all items
+            vk::DeviceSize totalOffset{ 0 };
+        };
+
+        static constexpr uint32_t PARTITION_SIZE = 256; // items per workgroup, must match scan.slang
+
+        GpuPrefixScan() noexcept = default;
+
+        [[nodiscard]] static vk::DeviceSize getScratchSize(uint32_t count) noexcept;
+        [[nodiscard]] static bool subgroupSupported(vk::PhysicalDevice physicalDevice);
+
+        // The scratch is cleared with a transfer command guarded by global barriers, which therefore also synchronize
+        // the scan with compute and transfer work recorded earlier. Nothing is recorded for an empty input.
+        void record(vk::CommandBuffer cmd, const Input& input) const;
+
+        [[nodiscard]] bool valid() const noexcept;
+
+        void destroy() noexcept;
+
+    private:
+        struct PushConstants {
+            vk::DeviceAddress data;
+            vk::DeviceAddress partitionCount;
+            vk::DeviceAddress partitionDescriptors;
+            vk::DeviceAddress total;
+            uint32_t count;
+            uint32_t stride;
+        };
+
+        vk::Device _device{};
+        vk::PipelineLayout _pipelineLayout{};
+        vk::Pipeline _pipeline{};
+    };
+} // namespace tpd
+
+inline tpd::GpuPrefixScan::Builder& tpd::GpuPrefixScan::Builder::pipelineCache(const vk::PipelineCache cache) noexcept {
+    _pipelineCache = cache;
+    return *this;
+}
+
+inline tpd::GpuPrefixScan::Builder& tpd::GpuPrefixScan::Builder::subgroupKernels(const bool enabled) noexcept {
+    _subgroupKernels = enabled;
+    return *this;
+}
+
+inline vk::DeviceSize tpd::GpuPrefixScan::getScratchSize(const uint32_t count) noexcept {
+    // The partition counter followed by one descriptor per workgroup
+    return sizeof(uint32_t) + sizeof(uint32_t) * ((count + PARTITION_SIZE - 1) / PARTITION_SIZE);
+}
+
+inline bool tpd::GpuPrefixScan::valid() const noexcept {
+    return _pipeline != nullptr;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "torpedo/foundation/TimestampProfiler.h"
+
+#include <vulkan/vulkan.hpp>
+
+namespace tpd {
+    // Stable LSD radix sort of 32- or 64-bit keys, optionally carrying a 32-bit value along with each key. Every pass
+    // sorts 2 bits with a 4-way local shuffle, a decoupled look-back scan of per-block radix counts, and a coalesced
+    // global mapping. Buffers are accessed through their device addresses and must be created with
+    // eShaderDeviceAddress usage.
+    class GpuRadixSort final {
+    public:
+        enum class KeyType { Uint32, Uint64 };
+
+        class Builder {
+        public:
+            Builder& keyType(KeyType type) noexcept;
+            Builder& pipelineCache(vk::PipelineCache cache) noexcept;
+
+            // Shuffle keys with ballot-based splits and scan block counts with subgroup arithmetic. Only enable this
+            // if subgroupSupported() and the device was created with the computeFullSubgroups feature.
+            Builder& subgroupKernels(bool enabled) noexcept;
+
+            [[nodiscard]] GpuRadixSort build(vk::Device device) const;
+
+        private:
+            KeyType _keyType{ KeyType::Uint64 };
+            vk::PipelineCache _pipelineCache{};
+            bool _subgroupKernels{ false };
+        };
+
+        struct Input {
+            vk::Buffer keys{};
+            vk::Buffer values{};   // optional, sorted along with keys
+            vk::Buffer scratch{};  // at least getScratchSize(capacity) bytes
+            uint32_t capacity{ 0 }; // the most keys the scratch was sized for
+            uint32_t beginBit{ 0 };
+            uint32_t endBit{ 32 }; // exclusive, bits outside of [beginBit, endBit) are ignored
+        };
+
+        // Indirect arguments for sorting a number of keys which is only known on the device
+        struct Dispatch {
+            vk::DispatchIndirectCommand sort;   // one workgroup per sort block
+            vk::DispatchIndirectCommand prefix; // one workgroup per BLOCK_SIZE sort blocks
+            uint32_t count;
+        };
+
+        // Timestamps written around each kernel group of a pass, with the pass as the instance of every stage. The
+        // stages must have been built with at least as many instances as there are passes.
+        struct Profiling {
+            const TimestampProfiler* profiler{ nullptr };
+            uint32_t frameIndex{ 0 };
+            uint32_t shuffleStage{ 0 };
+            uint32_t prefixStage{ 0 };  // covers both prefix kernels
+            uint32_t mappingStage{ 0 };
+        };
+
+        static constexpr uint32_t BLOCK_SIZE = 256; // keys per sort block, must match radix/common.slang
+
+        GpuRadixSort() noexcept = default;
+
+        [[nodiscard]] static Dispatch getDispatch(uint32_t count) noexcept;
+        [[nodiscard]] static uint32_t getPassCount(uint32_t beginBit, uint32_t endBit) noexcept;
+        [[nodiscard]] vk::DeviceSize getScratchSize(uint32_t capacity) const noexcept;
+        [[nodiscard]] static bool subgroupSupported(vk::PhysicalDevice physicalDevice); // same as GpuPrefixScan's
+
+        // Records every pass with barriers in between. Keys and values are sorted in place and are expected to have
+        // been synchronized with earlier writes, the scratch's contents need not be preserved between sorts. Kernels
+        // are only timed if profiling is not null.
+        void record(vk::CommandBuffer cmd, const Input& input, uint32_t count, const Profiling* profiling = nullptr) const;
+
+        // Records a single pass, consecutive passes must be separated by compute-to-compute memory barriers
+        void recordPass(
+            vk::CommandBuffer cmd, const Input& input, uint32_t count, uint32_t pass,
+            const Profiling* profiling = nullptr) const;
+
+        // Same as recordPass, taking dispatch sizes and the key count from a Dispatch at the given buffer offset
+        void recordPassIndirect(
+            vk::CommandBuffer cmd, const Input& input, uint32_t pass,
+            vk::Buffer dispatchBuffer, vk::DeviceSize dispatchOffset = 0,
+            const Profiling* profiling = nullptr) const;
+
+        [[nodiscard]] KeyType getKeyType() const noexcept;
+        [[nodiscard]] bool valid() const noexcept;
+
+        void destroy() noexcept;
+
+    private:
+        struct PushConstants {
+            vk::DeviceAddress keys;
+            vk::DeviceAddress values;
+            vk::DeviceAddress tempKeys;
+            vk::DeviceAddress tempVals;
+            vk::DeviceAddress prefixA;
+            vk::DeviceAddress prefixB;
+            vk::DeviceAddress descriptorA;
+            vk::DeviceAddress descriptorB;
+            vk::DeviceAddress counters;
+            vk::DeviceAddress countAddress;
+            uint32_t count;
+            uint32_t shift;
+            uint32_t bits;
+        };
+
+        // Byte offsets of each scratch region, counters first
+        struct ScratchLayout {
+            vk::DeviceSize prefixA;
+            vk::DeviceSize prefixB;
+            vk::DeviceSize descriptorA;
+            vk::DeviceSize descriptorB;
+            vk::DeviceSize tempKeys;
+            vk::DeviceSize tempVals;
+            vk::DeviceSize size;
+        };
+
+        [[nodiscard]] ScratchLayout getScratchLayout(uint32_t capacity) const noexcept;
+        [[nodiscard]] PushConstants getPushConstants(const Input& input, uint32_t pass) const;
+        // Dispatches indirectly from dispatchBuffer if not null, otherwise with the sizes in dispatch
+        void recordKernels(
+            vk::CommandBuffer cmd, const PushConstants& pc, const Dispatch& dispatch,
+            vk::Buffer dispatchBuffer, vk::DeviceSize dispatchOffset,
+            uint32_t pass, const Profiling* profiling) const;
+
+        vk::Device _device{};
+        KeyType _keyType{ KeyType::Uint64 };
+        vk::PipelineLayout _pipelineLayout{};
+        vk::Pipeline _shufflePipeline{};
+        vk::Pipeline _prefixAPipeline{};
+        vk::Pipeline _prefixBPipeline{};
+        vk::Pipeline _mappingPipeline{};
+    };
+} // namespace tpd
+
+inline tpd::GpuRadixSort::Builder& tpd::GpuRadixSort::Builder::keyType(const KeyType type) noexcept {
+    _keyType = type;
+    return *this;
+}
+
+inline tpd::GpuRadixSort::Builder& tpd::GpuRadixSort::Builder::pipelineCache(const vk::PipelineCache cache) noexcept {
+    _pipelineCache = cache;
+    return *this;
+}
+
+inline tpd::GpuRadixSort::Builder& tpd::GpuRadixSort::Builder::subgroupKernels(const bool enabled) noexcept {
+    _subgroupKernels = enabled;
+    return *this;
+}
+
+inline tpd::GpuRadixSort::Dispatch tpd::GpuRadixSort::getDispatch(const uint32_t count) noexcept {
+    const auto blockCount = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    return { { blockCount, 1, 1 }, { (blockCount + BLOCK_SIZE - 1) / BLOCK_SIZE, 1, 1 }, count };
+}
+
+inline uint32_t tpd::GpuRadixSort::getPassCount(const uint32_t beginBit, const uint32_t endBit) noexcept {
+    return endBit > beginBit ? (endBit - beginBit + 1) / 2 : 0;
+}
+
+inline vk::DeviceSize tpd::GpuRadixSort::getScratchSize(const uint32_t capacity) const noexcept {
+    return getScratchLayout(capacity).size;
+}
+
+inline tpd::GpuRadixSort::KeyType tpd::GpuRadixSort::getKeyType() const noexcept {
+    return _keyType;
+}
+
+inline bool tpd::GpuRadixSort::valid() const noexcept {
+    return _shufflePipeline != nullptr;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+namespace tpd {
+    // Unbounded multi-producer single-consumer queue, after Dmitry Vyukov's intrusive node-based design. Pushing is a
+    // single atomic exchange and never blocks or fails, popping is only ever done by one thread at a time. An element
+    // whose push has not fully completed yet is invisible to pop, which then reports the queue empty: consumers that
+    // must not miss elements pair the queue with a counter or semaphore released after each push.
+    template<typename T>
+    class MpscQueue final {
+    public:
+        MpscQueue();
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // Safe to call from any number of threads
+        void push(T&& value);
+
+        // Consumer only
+        [[nodiscard]] std::optional<T> pop();
+
+        ~MpscQueue() noexcept;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            std::optional<T> value{}; // empty for the stub
+        };
+
+        // Producers link new nodes after the head, the consumer follows next pointers from the tail
+        alignas(64) std::atomic<Node*> _head;
+        alignas(64) Node* _tail;
+    };
+} // namespace tpd
+
+template<typename T>
+tpd::MpscQueue<T>::MpscQueue() {
+    const auto stub = new Node{};
+    _head.store(stub, std::memory_order_relaxed);
+    _tail = stub;
+}
+
+template<typename T>
+void tpd::MpscQueue<T>::push(T&& value) {
+    const auto node = new Node{};
+    node->value.emplace(std::move(value));
+
+    // Between the exchange and the store, the chain is broken at prev and the consumer cannot see past it
+    const auto prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+template<typename T>
+std::optional<T> tpd::MpscQueue<T>::pop() {
+    const auto next = _tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        return std::nullopt;
+    }
+
+    // The next node becomes the new stub once its value has been taken
+    auto value = std::move(next->value);
+    next->value.reset();
+    delete _tail;
+    _tail = next;
+    return value;
+}
+
+template<typename T>
+tpd::MpscQueue<T>::~MpscQueue() noexcept {
+    while (_tail) {
+        const auto next = _tail->next.load(std::memory_order_relaxed);
+        delete _tail;
+        _tail = next;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace tpd {
+    // Serializes host access to the queues of a device shared by several clients, each possibly running on a thread of
+    // its own. Vulkan requires submissions to the same queue to be externally synchronized: every queue is guarded by a
+    // ticket lock which grants it in the order it was requested, so that a client submitting in a tight loop cannot
+    // starve the others. Queue families serving more than one role share the same queue, and so the same lock.
+    class QueueArbiter final {
+    public:
+        QueueArbiter(vk::Device device, std::span<const uint32_t> queueFamilies);
+
+        QueueArbiter(const QueueArbiter&) = delete;
+        QueueArbiter& operator=(const QueueArbiter&) = delete;
+
+        // The queue must be one of those the arbiter was created for
+        void submit(vk::Queue queue, const vk::SubmitInfo2& submitInfo, vk::Fence fence = {});
+
+        // Holds every queue while waiting, vkDeviceWaitIdle requires them all to be externally synchronized
+        void waitIdle();
+
+        // Runs the function while holding every queue, for code that submits on its own or waits for the device
+        template<typename F>
+        void exclusive(F&& function);
+
+    private:
+        // Satisfies BasicLockable, so that it works with std::lock_guard
+        class TicketLock {
+        public:
+            void lock();
+            void unlock() noexcept;
+
+        private:
+            std::mutex _mutex{};
+            std::condition_variable _served{};
+            uint64_t _nextTicket{ 0 };
+            uint64_t _nowServing{ 0 };
+        };
+
+        struct Entry {
+            vk::Queue queue;
+            std::unique_ptr<TicketLock> lock; // not movable
+        };
+
+        [[nodiscard]] TicketLock& getLock(vk::Queue queue);
+        void lockAll();
+        void unlockAll() noexcept;
+
+        vk::Device _device;
+        std::vector<Entry> _entries{}; // always locked in this order, see lockAll
+    };
+} // namespace tpd
+
+template<typename F>
+void tpd::QueueArbiter::exclusive(F&& function) {
+    lockAll();
+    try {
+        std::forward<F>(function)();
+    } catch (...) {
+        unlockAll();
+        throw;
+    }
+    unlockAll();
+}
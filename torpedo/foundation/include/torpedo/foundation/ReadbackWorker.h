@@ -0,0 +1,134 @@
+#pragma once
+
+#include "torpedo/foundation/QueueArbiter.h"
+#include "torpedo/foundation/VmaUsage.h"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <span>
+
+namespace tpd {
+    // Downloads buffer and image regions to the host without stalling the caller. Regions enqueued between submits are
+    // copied into a persistently mapped, host-cached staging ring by a single command buffer, submitted to the queue of
+    // the given family and tracked by the value it signals on a timeline semaphore. Completed readbacks are delivered
+    // through callbacks or futures from poll or wait, always on the calling thread. Sources must be owned by the queue
+    // family the worker was created for, and the device must have the timelineSemaphore feature enabled.
+    class ReadbackWorker final {
+    public:
+        static constexpr vk::DeviceSize DEFAULT_STAGING_RING_SIZE = 16 * 1024 * 1024;
+
+        // The span is only valid for the duration of the call, it points directly into the staging ring
+        using Callback = std::move_only_function<void(std::span<const std::byte>)>;
+
+        struct ImageRegion {
+            vk::Image image{};
+            vk::ImageLayout layout{ vk::ImageLayout::eTransferSrcOptimal }; // either transfer src or general
+            vk::ImageSubresourceLayers subresource{ vk::ImageAspectFlagBits::eColor, 0, 0, 1 };
+            vk::Offset3D offset{};
+            vk::Extent3D extent{};
+            uint32_t texelSize{ 4 }; // bytes per texel, texels are read back tightly packed
+        };
+
+        // With an arbiter, submissions go through it so that the queue can be shared with other clients of the device
+        ReadbackWorker(
+            uint32_t queueFamily, vk::Device device, VmaAllocator vmaAllocator,
+            vk::DeviceSize stagingRingSize = DEFAULT_STAGING_RING_SIZE, QueueArbiter* arbiter = nullptr);
+
+        ReadbackWorker(const ReadbackWorker&) = delete;
+        ReadbackWorker& operator=(const ReadbackWorker&) = delete;
+
+        // The source sync describes the last writes to the region, in case they were submitted earlier to the same
+        // queue. Writes from other queues must be waited for with semaphores passed to submit instead.
+        void enqueue(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, SyncPoint srcSync, Callback&& callback);
+        void enqueue(const ImageRegion& region, SyncPoint srcSync, Callback&& callback);
+
+        [[nodiscard]] std::future<std::vector<std::byte>> enqueue(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, SyncPoint srcSync);
+        [[nodiscard]] std::future<std::vector<std::byte>> enqueue(const ImageRegion& region, SyncPoint srcSync);
+
+        // Submits regions enqueued since the last submit after the given semaphores, returning the timeline value their
+        // completion signals. Without enqueued regions, nothing is submitted and the value of the last submit is returned,
+        // though the fence, if any, is still signaled once all work submitted to the queue so far has completed.
+        uint64_t submit(std::span<const vk::SemaphoreSubmitInfo> waitInfos = {}, vk::Fence fence = {});
+
+        // Delivers readbacks that have completed by now and makes their staging space available again, never blocks
+        void poll();
+
+        // Blocks until the timeline reaches the value, then polls
+        void wait(uint64_t value);
+        void waitIdle();
+
+        [[nodiscard]] bool completed(uint64_t value) const;
+        [[nodiscard]] vk::Semaphore getTimeline() const noexcept;
+
+        void destroy() noexcept;
+
+    private:
+        struct Readback {
+            vk::DeviceSize ringOffset; // absolute ring position
+            vk::DeviceSize size;
+            Callback callback;
+        };
+
+        struct BufferCopy {
+            vk::Buffer buffer;
+            vk::BufferCopy region;
+        };
+
+        struct ImageCopy {
+            vk::Image image;
+            vk::ImageLayout layout;
+            vk::BufferImageCopy region;
+        };
+
+        // Submitted readbacks still in flight, oldest first
+        struct Batch {
+            uint64_t value;
+            vk::CommandBuffer command;
+            vk::DeviceSize ringEnd;
+            std::vector<Readback> readbacks;
+        };
+
+        // Returns the absolute ring position of a contiguous range, waiting for older batches if there is no room
+        [[nodiscard]] vk::DeviceSize reserveStaging(vk::DeviceSize size, vk::DeviceSize alignment);
+        void retireBatch(Batch& batch);
+
+        [[nodiscard]] vk::CommandBuffer getCommandBuffer();
+        void submitToQueue(const vk::SubmitInfo2& submitInfo, vk::Fence fence);
+
+        vk::Device _device;
+        VmaAllocator _vmaAllocator;
+
+        vk::Queue _queue;
+        QueueArbiter* _arbiter;
+        vk::CommandPool _commandPool{};
+        std::vector<vk::CommandBuffer> _freeCommandBuffers{};
+
+        vk::Semaphore _timeline{};
+        uint64_t _timelineValue{ 0 };
+
+        // Ring positions count all bytes ever reserved, the ring holds those from the tail up to the head
+        OpaqueResource<vk::Buffer> _stagingRing{};
+        const std::byte* _stagingData{ nullptr };
+        vk::DeviceSize _stagingRingSize;
+        vk::DeviceSize _ringHead{ 0 };
+        vk::DeviceSize _ringTail{ 0 };
+
+        // Enqueued since the last submit, recorded into a command buffer on submit
+        std::vector<BufferCopy> _bufferCopies{};
+        std::vector<ImageCopy> _imageCopies{};
+        std::vector<Readback> _readbacks{};
+        SyncPoint _srcSync{};
+
+        std::deque<Batch> _batches{};
+    };
+} // namespace tpd
+
+inline bool tpd::ReadbackWorker::completed(const uint64_t value) const {
+    return _device.getSemaphoreCounterValue(_timeline) >= value;
+}
+
+inline vk::Semaphore tpd::ReadbackWorker::getTimeline() const noexcept {
+    return _timeline;
+}
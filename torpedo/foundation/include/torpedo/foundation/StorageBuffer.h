@@ -7,7 +7,12 @@ namespace tpd {
     public:
         class Builder final : public Buffer::Builder<Builder, StorageBuffer> {
         public:
+            Builder& strategy(vma::AllocationStrategy strategy) noexcept;
+
             [[nodiscard]] StorageBuffer build(VmaAllocator allocator) const override;
+
+        private:
+            vma::AllocationStrategy _strategy{ vma::AllocationStrategy::Auto };
         };
 
         StorageBuffer() noexcept = default;
@@ -23,5 +28,10 @@ namespace tpd {
     };
 } // namespace tpd
 
+inline tpd::StorageBuffer::Builder& tpd::StorageBuffer::Builder::strategy(const vma::AllocationStrategy strategy) noexcept {
+    _strategy = strategy;
+    return *this;
+}
+
 inline tpd::StorageBuffer::StorageBuffer(const vk::Buffer buffer, VmaAllocation allocation) 
     : Buffer{ buffer, allocation } {}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tpd {
+    // Fixed set of worker threads running parallel loops with range stealing. Each loop splits its indices evenly
+    // among the workers and the calling thread, which take them one at a time from the front of their own range.
+    // Those running out of work steal the back half of another thread's range, so that uneven items (tiles with a few
+    // splats next to tiles with thousands) still keep every thread busy. Only one loop runs at a time.
+    class ThreadPool final {
+    public:
+        // Zero picks one worker less than the hardware concurrency, the calling thread being the last one
+        explicit ThreadPool(uint32_t workerCount = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Runs the task for every index in [0, count) and blocks until all of them have completed. The first exception
+        // thrown by a task is rethrown here once the loop has drained, indices not yet taken by then are skipped.
+        void parallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+
+        [[nodiscard]] uint32_t getThreadCount() const noexcept; // workers and the calling thread
+
+        ~ThreadPool() noexcept;
+
+    private:
+        struct alignas(64) Range {
+            std::mutex mutex{};
+            uint32_t begin{ 0 };
+            uint32_t end{ 0 };
+        };
+
+        void work(uint32_t participant);
+        void runLoop(uint32_t participant);
+
+        [[nodiscard]] bool takeOwn(uint32_t participant, uint32_t& index);
+        [[nodiscard]] bool steal(uint32_t participant);
+        void abandon(); // empties every range after a task has thrown
+
+        std::vector<std::unique_ptr<Range>> _ranges{}; // one per worker, then one for the calling thread
+        std::vector<std::thread> _workers{};
+
+        // Guards the loop state below, workers wait for the generation to change
+        std::mutex _mutex{};
+        std::condition_variable _loopStarted{};
+        std::condition_variable _loopDrained{};
+        uint64_t _generation{ 0 };
+        uint32_t _activeWorkers{ 0 };
+        bool _stopping{ false };
+
+        const std::function<void(uint32_t)>* _task{ nullptr };
+        std::exception_ptr _exception{};
+    };
+} // namespace tpd
+
+inline uint32_t tpd::ThreadPool::getThreadCount() const noexcept {
+    return static_cast<uint32_t>(_ranges.size());
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <string>
+#include <vector>
+
+namespace tpd {
+    class TimestampProfiler final {
+    public:
+        class Builder {
+        public:
+            // Stages are indexed in the order they are added, each stage can be recorded up to instanceCount
+            // times per frame (e.g. once per sort pass) and its sample is the sum of all recorded instances
+            Builder& stage(std::string_view name, uint32_t instanceCount = 1);
+            Builder& frameCount(uint32_t count) noexcept;
+            Builder& historySize(uint32_t size) noexcept;
+            Builder& traceTrack(std::string_view name); // name of the GPU track in FrameTracer exports
+
+            [[nodiscard]] TimestampProfiler build(vk::PhysicalDevice physicalDevice, vk::Device device) const;
+
+        private:
+            std::vector<std::pair<std::string, uint32_t>> _stages{};
+            uint32_t _frameCount{ 1 };
+            uint32_t _historySize{ 128 };
+            std::string _traceTrack{ "gpu" };
+        };
+
+        struct Stats {
+            std::string_view name{};
+            float average{ 0.0f }; // all timings are in milliseconds
+            float p50{ 0.0f };
+            float p95{ 0.0f };
+            float p99{ 0.0f };
+            uint32_t sampleCount{ 0 };
+        };
+
+        TimestampProfiler() noexcept = default;
+
+        [[nodiscard]] static bool supported(vk::PhysicalDevice physicalDevice, uint32_t queueFamilyIndex);
+
+        // Must be recorded before any stage of the same frame, outside of the commands being timed
+        void recordReset(vk::CommandBuffer cmd, uint32_t frameIndex);
+        void recordBegin(vk::CommandBuffer cmd, uint32_t frameIndex, uint32_t stage, uint32_t instance = 0) const noexcept;
+        void recordEnd(vk::CommandBuffer cmd, uint32_t frameIndex, uint32_t stage, uint32_t instance = 0) const noexcept;
+
+        // Maps GPU ticks onto the FrameTracer timeline with a single timestamp round trip on the given queue, after
+        // which collected timings are also recorded as GPU zones whenever FrameTracer is enabled
+        void calibrate(vk::Device device, vk::Queue queue, vk::CommandPool commandPool);
+
+        // Never waits: stages whose results are not yet available for this frame are skipped
+        void collect(vk::Device device, uint32_t frameIndex);
+
+        [[nodiscard]] Stats getStats(uint32_t stage) const;
+        [[nodiscard]] uint32_t getStageCount() const noexcept;
+        [[nodiscard]] bool valid() const noexcept;
+
+        void destroy(vk::Device device) noexcept;
+
+    private:
+        struct Stage {
+            std::string name;
+            uint32_t firstSlot;
+            uint32_t instanceCount;
+            std::vector<float> history; // ring of recent samples
+            uint32_t cursor;
+            uint32_t sampleCount;
+        };
+
+        std::vector<Stage> _stages{};
+        std::vector<vk::QueryPool> _queryPools{}; // one pool per in-flight frame
+        std::vector<bool> _recorded{};
+        uint32_t _slotCount{ 0 };
+        float _timestampPeriod{ 1.0f }; // nanoseconds per tick
+
+        std::string _traceTrack{};
+        uint64_t _calibrationTicks{ 0 };
+        uint64_t _calibrationTime{ 0 }; // FrameTracer time at _calibrationTicks
+        bool _calibrated{ false };
+    };
+} // namespace tpd
+
+inline tpd::TimestampProfiler::Builder& tpd::TimestampProfiler::Builder::stage(const std::string_view name, const uint32_t instanceCount) {
+    _stages.emplace_back(name, instanceCount);
+    return *this;
+}
+
+inline tpd::TimestampProfiler::Builder& tpd::TimestampProfiler::Builder::frameCount(const uint32_t count) noexcept {
+    _frameCount = count;
+    return *this;
+}
+
+inline tpd::TimestampProfiler::Builder& tpd::TimestampProfiler::Builder::historySize(const uint32_t size) noexcept {
+    _historySize = size;
+    return *this;
+}
+
+inline tpd::TimestampProfiler::Builder& tpd::TimestampProfiler::Builder::traceTrack(const std::string_view name) {
+    _traceTrack = name;
+    return *this;
+}
+
+inline void tpd::TimestampProfiler::recordBegin(
+    const vk::CommandBuffer cmd,
+    const uint32_t frameIndex,
+    const uint32_t stage,
+    const uint32_t instance) const noexcept
+{
+    const auto slot = _stages[stage].firstSlot + instance;
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, _queryPools[frameIndex], slot * 2);
+}
+
+inline void tpd::TimestampProfiler::recordEnd(
+    const vk::CommandBuffer cmd,
+    const uint32_t frameIndex,
+    const uint32_t stage,
+    const uint32_t instance) const noexcept
+{
+    const auto slot = _stages[stage].firstSlot + instance;
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, _queryPools[frameIndex], slot * 2 + 1);
+}
+
+inline uint32_t tpd::TimestampProfiler::getStageCount() const noexcept {
+    return static_cast<uint32_t>(_stages.size());
+}
+
+inline bool tpd::TimestampProfiler::valid() const noexcept {
+    return !_queryPools.empty();
+}
@@ -1,73 +1,48 @@
 #pragma once
 
+#include "torpedo/foundation/QueueArbiter.h"
 #include "torpedo/foundation/VmaUsage.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <deque>
 #include <functional>
-#include <mutex>
-#include <thread>
 
 namespace tpd {
     class StorageBuffer;
     class Texture;
 
-    class DeletionWorker final {
-    public:
-        DeletionWorker(vk::Device device, VmaAllocator vmaAllocator);
-
-        DeletionWorker(const DeletionWorker&) = delete;
-        DeletionWorker& operator=(const DeletionWorker&) = delete;
-
-        void start();
-
-        void submit(
-            vk::Fence fence, vk::Buffer buffer, VmaAllocation allocation, vk::Semaphore semaphore = {},
-            std::vector<std::pair<vk::CommandPool, vk::CommandBuffer>>&& commandBuffers = {});
-
-        void waitEmpty();
-
-        void shutdown() noexcept;
-        ~DeletionWorker() noexcept { shutdown(); }
-
-    private:
-        std::function<void(std::string_view)> _statusUpdateCallback{ [](std::string_view) {} };
-
-        vk::Device _device;
-        VmaAllocator _vmaAllocator;
-
-        void deletionWork();
-        std::thread _workerThread;
-
-        struct Task {
-            vk::Fence fence;
-            OpaqueResource<vk::Buffer> buffer;
-            vk::Semaphore semaphore;
-            std::vector<std::pair<vk::CommandPool, vk::CommandBuffer>> buffers;
-        };
-        std::deque<Task> _tasks{};
-        bool _stopWorker{ false };
-
-        std::mutex _queueMutex{};
-        std::condition_variable _queueCondition{};
-
-        // According to the spec, the command pool and command buffers involved in vkFreeCommandBuffers
-        // must be externally synchronized. While the command buffers are no longer the interest of the
-        // main thread, the command pool may still be used by the main thread, hence an extra lock for it
-        std::mutex _commandPoolMutex{};
-        friend class TransferWorker;
-    };
-
+    // Uploads host data to buffers and textures, transferring queue family ownership when they are used by a family
+    // other than the transfer one. Every submission signals the timeline semaphore of its queue, and the resources it
+    // uses are destroyed once that timeline reaches the signaled value, see reclaim.
     class TransferWorker final {
     public:
+        static constexpr vk::DeviceSize DEFAULT_STAGING_RING_SIZE = 64 * 1024 * 1024;
+
+        // With an arbiter, submissions go through it so that the queues can be shared with other clients of the device
         TransferWorker(
             uint32_t transferFamily, uint32_t graphicsFamily, uint32_t computeFamily,
-            vk::PhysicalDevice physicalDevice, vk::Device device, VmaAllocator vmaAllocator);
+            vk::PhysicalDevice physicalDevice, vk::Device device, VmaAllocator vmaAllocator,
+            vk::DeviceSize stagingRingSize = DEFAULT_STAGING_RING_SIZE, QueueArbiter* arbiter = nullptr);
 
         TransferWorker(const TransferWorker&) = delete;
         TransferWorker& operator=(const TransferWorker&) = delete;
 
+        // Enqueues into the current batch if there is one, otherwise makes a batch of its own
         void transfer(const void* data, vk::DeviceSize size, const StorageBuffer& buffer, uint32_t dstFamily, SyncPoint dstSync);
 
+        // Buffer transfers enqueued between beginBatch and flush are staged through a persistently mapped ring and
+        // recorded into a single command buffer, submitted once with one barrier per buffer. Data is copied to the ring
+        // before enqueue returns. Transfers larger than the free space are split into segments, submitting copies
+        // recorded so far early and waiting for older ones to complete whenever the ring runs out of space.
+        void beginBatch();
+        void enqueue(
+            const void* data, vk::DeviceSize size, const StorageBuffer& buffer, uint32_t dstFamily, SyncPoint dstSync,
+            vk::DeviceSize dstOffset = 0);
+        void flush();
+
+        [[nodiscard]] bool batching() const noexcept;
+
         void transfer(
             const void* data, vk::DeviceSize size, const Texture& texture, vk::Extent3D extent, uint32_t dstFamily,
             vk::ImageLayout dstLayout = vk::ImageLayout::eShaderReadOnlyOptimal, uint32_t mipLevel = 0);
@@ -79,55 +54,103 @@ namespace tpd {
         void setStatusUpdateCallback(const std::function<void(std::string_view)>& callback) noexcept;
         void setStatusUpdateCallback(std::function<void(std::string_view)>&& callback) noexcept;
 
-        void waitIdle() { _deletionWorker.waitEmpty(); }
+        // Destroys staging resources and frees command buffers of transfers that have completed, without blocking.
+        // This already happens before each transfer, render loops may additionally call it once per frame.
+        void reclaim();
+
+        // Blocks until all submitted transfers have completed, then reclaims everything
+        void waitIdle();
 
         void destroy() noexcept;
 
     private:
-        [[nodiscard]] vk::CommandPool getPool(uint32_t queueFamily) const;
+        struct Deletion {
+            uint64_t value; // timeline value after which the resources are no longer in use
+            vk::CommandBuffer command;
+            OpaqueResource<vk::Buffer> staging;
+        };
+
+        // One per distinct queue family, families of the same index share the same queue
+        struct Timeline {
+            uint32_t family;
+            vk::Queue queue;
+            vk::CommandPool pool;
+            vk::Semaphore semaphore;
+            uint64_t value; // signaled by the last submission
+            std::deque<Deletion> deletions;
+        };
+
+        [[nodiscard]] Timeline& getTimeline(uint32_t queueFamily);
+
+        [[nodiscard]] vk::CommandBuffer beginTransfer(uint32_t queueFamily);
+
+        // Ends and submits the command buffer to the family's queue, returning the value it signals on the family's
+        // timeline. A non-zero transferValue makes the submission wait for that value on the transfer timeline first.
+        uint64_t submit(vk::CommandBuffer buffer, uint32_t queueFamily, uint64_t transferValue = 0);
+
+        // Resources are only destroyed once the family's timeline reaches the value
+        void defer(uint32_t queueFamily, uint64_t value, vk::CommandBuffer buffer, OpaqueResource<vk::Buffer>&& staging = {});
 
-        [[nodiscard]] vk::CommandBuffer beginTransfer(uint32_t queueFamily) const;
-        void endTransfer(vk::CommandBuffer buffer, vk::Fence deletionFence) const;
+        // Returns how many of the requested bytes can be staged at the ring's head, making room if there is none
+        [[nodiscard]] vk::DeviceSize reserveStaging(vk::DeviceSize size);
+        void submitCopies(); // submits the copies recorded so far without barriers, so that their ring space can be reclaimed
+        void retireSegments(bool waitOldest);
 
-        [[nodiscard]] vk::SemaphoreSubmitInfo createOwnershipSemaphoreInfo() const;
-        void endRelease(vk::CommandBuffer buffer, const vk::SemaphoreSubmitInfo& semaphoreInfo) const;
-        void endAcquire(vk::CommandBuffer buffer, const vk::SemaphoreSubmitInfo& semaphoreInfo, uint32_t dstFamily, vk::Fence deletionFence) const;
+        // Empty unless set, so that status messages are only formatted when someone listens
+        std::function<void(std::string_view)> _statusUpdateCallback{};
 
         vk::PhysicalDevice _physicalDevice;
-        DeletionWorker _deletionWorker;
+        vk::Device _device;
+        VmaAllocator _vmaAllocator;
+        QueueArbiter* _arbiter;
 
         uint32_t _transferFamily;
         uint32_t _graphicsFamily;
         uint32_t _computeFamily;
 
-        vk::Queue _transferQueue;
-        vk::Queue _graphicsQueue;
-        vk::Queue _computeQueue;
+        std::vector<Timeline> _timelines{};
+
+        // Ring positions count all bytes ever staged, the ring holds those from the tail up to the head
+        OpaqueResource<vk::Buffer> _stagingRing{};
+        std::byte* _stagingData{ nullptr };
+        vk::DeviceSize _stagingRingSize;
+        vk::DeviceSize _ringHead{ 0 };
+        vk::DeviceSize _ringTail{ 0 };
+
+        // Submitted copies still reading from the ring, oldest first, tracked by values of the transfer timeline
+        struct StagingSegment {
+            uint64_t value;
+            vk::DeviceSize ringEnd;
+        };
+        std::deque<StagingSegment> _stagingSegments{};
 
-        vk::CommandPool _releasePool;
-        vk::CommandPool _graphicsAcquirePool;
-        vk::CommandPool _computeAcquirePool;
+        struct PendingTransfer {
+            vk::Buffer buffer;
+            uint32_t dstFamily;
+            SyncPoint dstSync;
+        };
+        bool _batching{ false };
+        vk::CommandBuffer _batchCommand{};
+        std::vector<PendingTransfer> _pendingTransfers{};
     };
 } // namespace tpd
 
 inline void tpd::TransferWorker::setStatusUpdateCallback(const std::function<void(std::string_view)>& callback) noexcept {
-    _deletionWorker._statusUpdateCallback = callback;
+    _statusUpdateCallback = callback;
 }
 
 inline void tpd::TransferWorker::setStatusUpdateCallback(std::function<void(std::string_view)>&& callback) noexcept {
-    _deletionWorker._statusUpdateCallback = std::move(callback);
+    _statusUpdateCallback = std::move(callback);
 }
 
-inline vk::CommandPool tpd::TransferWorker::getPool(const uint32_t queueFamily) const {
-    if (queueFamily == _transferFamily) {
-        return _releasePool;
-    }
-    if (queueFamily == _computeFamily) {
-        return _computeAcquirePool;
-    }
-    if (queueFamily == _graphicsFamily) {
-        return _graphicsAcquirePool;
+inline bool tpd::TransferWorker::batching() const noexcept {
+    return _batching;
+}
+
+inline tpd::TransferWorker::Timeline& tpd::TransferWorker::getTimeline(const uint32_t queueFamily) {
+    const auto timeline = std::ranges::find(_timelines, queueFamily, &Timeline::family);
+    if (timeline == _timelines.end()) [[unlikely]] {
+        throw std::invalid_argument("TransferWorker - Unrecognized queue family for transfer");
     }
-    [[unlikely]]
-    throw std::invalid_argument("TransferWorker - Unrecognized queue family for transfer command pool");
+    return *timeline;
 }
@@ -26,7 +26,20 @@ namespace tpd::vma {
 
     void deallocateImage(VmaAllocator allocator, vk::Image image, VmaAllocation allocation) noexcept;
 
-    [[nodiscard]] vk::Buffer allocateDeviceBuffer(VmaAllocator allocator, const vk::BufferCreateInfo& info, VmaAllocation* allocation);
+    // Every vkAllocateMemory counts towards maxMemoryAllocationCount and is slow to make, so only large and long-lived
+    // resources deserve memory of their own, small and frequently recreated ones are better placed in shared blocks
+    enum class AllocationStrategy {
+        Auto,         // dedicated at or above DEDICATED_THRESHOLD bytes, sub-allocated below
+        Dedicated,    // a vkDeviceMemory of its own
+        SubAllocated, // placed in a memory block shared with other allocations
+    };
+
+    constexpr vk::DeviceSize DEDICATED_THRESHOLD = 4 * 1024 * 1024;
+
+    [[nodiscard]] vk::Buffer allocateDeviceBuffer(
+        VmaAllocator allocator, const vk::BufferCreateInfo& info, VmaAllocation* allocation,
+        AllocationStrategy strategy = AllocationStrategy::Dedicated);
+
     [[nodiscard]] vk::Buffer allocateTwoWayBuffer(VmaAllocator allocator, const vk::BufferCreateInfo& info, VmaAllocation* allocation, VmaAllocationInfo* allocationInfo);
     [[nodiscard]] vk::Buffer allocateMappedBuffer(VmaAllocator allocator, const vk::BufferCreateInfo& info, VmaAllocation* allocation, VmaAllocationInfo* allocationInfo);
 
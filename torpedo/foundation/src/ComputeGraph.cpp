@@ -0,0 +1,306 @@
+#include "torpedo/foundation/ComputeGraph.h"
+#include "torpedo/foundation/Allocation.h"
+
+#include <algorithm>
+#include <ranges>
+
+tpd::ComputeGraph::Resource tpd::ComputeGraph::Builder::transient(
+    const std::string_view name,
+    const vk::DeviceSize size,
+    const vk::BufferUsageFlags usage)
+{
+    // Zero-sized buffers are not allowed, a dummy size keeps descriptors pointing at something valid
+    _resources.push_back({ std::string{ name }, std::max<vk::DeviceSize>(size, 1), usage, true });
+    return static_cast<Resource>(_resources.size() - 1);
+}
+
+tpd::ComputeGraph::Resource tpd::ComputeGraph::Builder::import(const std::string_view name) {
+    _resources.push_back({ std::string{ name }, 0, vk::BufferUsageFlags{}, false });
+    return static_cast<Resource>(_resources.size() - 1);
+}
+
+tpd::ComputeGraph::Builder& tpd::ComputeGraph::Builder::pass(
+    const std::string_view name,
+    const PassType type,
+    const std::initializer_list<Resource> reads,
+    const std::initializer_list<Resource> writes,
+    RecordFunction&& record)
+{
+    const auto unknown = [this](const Resource r) { return r >= _resources.size(); };
+    if (std::ranges::any_of(reads, unknown) || std::ranges::any_of(writes, unknown)) [[unlikely]] {
+        throw std::invalid_argument("ComputeGraph::Builder - Unknown resource accessed by pass: " + std::string{ name });
+    }
+    _passes.push_back({ std::string{ name }, type, reads, writes, std::move(record) });
+    return *this;
+}
+
+namespace {
+    // What happened to a range of memory since the last barrier reaching each stage
+    struct AccessState {
+        vk::PipelineStageFlags2 writeStage;
+        vk::AccessFlags2 writeAccess;
+        int writePass;
+        vk::PipelineStageFlags2 visibleStages; // stages the last write has been made visible to
+        vk::PipelineStageFlags2 readStages;    // stages having read since the last write
+        int readPass;
+        vk::PipelineStageFlags2 syncedStages;  // stages ordered after all of those reads
+    };
+
+    struct Placement {
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+        uint32_t first; // lifetime as pass indices, inclusive
+        uint32_t last;
+    };
+
+    bool overlap(const Placement& a, const Placement& b) {
+        return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+    }
+
+    bool overlapLifetime(const Placement& a, const Placement& b) {
+        return a.first <= b.last && b.first <= a.last;
+    }
+} // namespace
+
+tpd::ComputeGraph tpd::ComputeGraph::Builder::build(const vk::Device device, VmaAllocator allocator) const {
+    if (_passes.empty()) [[unlikely]] {
+        throw std::runtime_error("ComputeGraph::Builder - No pass to record: did you forget to call Builder::pass()?");
+    }
+
+    const auto resourceCount = static_cast<uint32_t>(_resources.size());
+    const auto passCount = static_cast<uint32_t>(_passes.size());
+
+    auto graph = ComputeGraph{};
+    graph._buffers.resize(resourceCount);
+    graph._sizes.resize(resourceCount);
+    graph._statistics.passCount = passCount;
+
+    // Transients only need their memory from the first to the last pass touching them
+    auto placements = std::vector<Placement>(resourceCount);
+    for (auto& placement : placements) {
+        placement = { 0, 0, passCount, 0 };
+    }
+    for (uint32_t i = 0; i < passCount; ++i) {
+        for (const auto r : _passes[i].reads)  placements[r] = { 0, 0, std::min(placements[r].first, i), std::max(placements[r].last, i) };
+        for (const auto r : _passes[i].writes) placements[r] = { 0, 0, std::min(placements[r].first, i), std::max(placements[r].last, i) };
+    }
+
+    auto transients = std::vector<Resource>{};
+    auto alignment = vk::DeviceSize{ 1 };
+    auto memoryTypeBits = ~0u;
+    auto requirements = std::vector<vk::MemoryRequirements>(resourceCount);
+
+    for (Resource r = 0; r < resourceCount; ++r) {
+        const auto& [name, size, usage, transient] = _resources[r];
+        graph._sizes[r] = size;
+        if (!transient) continue;
+
+        // A transient that is never accessed still gets a valid buffer, alive throughout the graph
+        if (placements[r].first > placements[r].last) {
+            placements[r].first = 0;
+            placements[r].last = passCount - 1;
+        }
+
+        const auto bufferInfo = vk::BufferCreateInfo{}
+            .setSize(size)
+            .setUsage(usage | vk::BufferUsageFlagBits::eStorageBuffer)
+            .setSharingMode(vk::SharingMode::eExclusive);
+        graph._buffers[r] = device.createBuffer(bufferInfo);
+
+        requirements[r] = device.getBufferMemoryRequirements(graph._buffers[r]);
+        alignment = std::max(alignment, requirements[r].alignment);
+        memoryTypeBits &= requirements[r].memoryTypeBits;
+        placements[r].size = requirements[r].size;
+        graph._statistics.unaliasedBytes += alloc::alignUp(requirements[r].size, requirements[r].alignment);
+        transients.push_back(r);
+    }
+
+    // Greedy placement, largest first: each transient takes the lowest offset not colliding with any placed
+    // transient alive at the same time. Without aliasing, every transient is considered alive at the same time.
+    std::ranges::stable_sort(transients, std::greater{}, [&](const Resource r) { return placements[r].size; });
+    auto placed = std::vector<Resource>{};
+    for (const auto r : transients) {
+        auto& placement = placements[r];
+        const auto live = [&](const Resource other) { return !_aliasing || overlapLifetime(placement, placements[other]); };
+
+        auto candidates = std::vector<vk::DeviceSize>{ 0 };
+        for (const auto other : placed | std::views::filter(live)) {
+            const auto end = placements[other].offset + placements[other].size;
+            candidates.push_back(alloc::alignUp(end, requirements[r].alignment));
+        }
+        std::ranges::sort(candidates);
+
+        for (const auto offset : candidates) {
+            placement.offset = offset;
+            const auto collide = [&](const Resource other) { return overlap(placement, placements[other]); };
+            if (std::ranges::none_of(placed | std::views::filter(live), collide)) break;
+        }
+        graph._statistics.transientBytes = std::max(graph._statistics.transientBytes, placement.offset + placement.size);
+        placed.push_back(r);
+    }
+
+    if (!transients.empty()) {
+        if (memoryTypeBits == 0) [[unlikely]] {
+            graph.destroy(device, allocator);
+            throw std::runtime_error("ComputeGraph::Builder - Transient buffers have no memory type in common");
+        }
+
+        const auto memoryRequirements = VkMemoryRequirements{ graph._statistics.transientBytes, alignment, memoryTypeBits };
+        constexpr auto allocInfo = VmaAllocationCreateInfo{
+            .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+            .preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .priority = 1.0f,
+        };
+        if (vmaAllocateMemory(allocator, &memoryRequirements, &allocInfo, &graph._allocation, nullptr) != VK_SUCCESS) {
+            graph.destroy(device, allocator);
+            throw std::runtime_error("ComputeGraph::Builder - Failed to allocate transient memory");
+        }
+        for (const auto r : transients) {
+            vmaBindBufferMemory2(allocator, graph._allocation, placements[r].offset, graph._buffers[r], nullptr);
+        }
+    }
+
+    // Resources sharing memory share hazards, a resource always overlaps itself
+    auto aliases = std::vector<std::vector<Resource>>(resourceCount);
+    for (Resource r = 0; r < resourceCount; ++r) {
+        aliases[r].push_back(r);
+        if (!_resources[r].transient) continue;
+        for (const auto other : transients) {
+            if (other != r && overlap(placements[r], placements[other])) aliases[r].push_back(other);
+        }
+    }
+
+    // Everything is assumed to have been written and read by earlier submissions, typically the previous execution
+    using PipelineStage = vk::PipelineStageFlagBits2;
+    using AccessMask = vk::AccessFlagBits2;
+    constexpr auto anyStage = PipelineStage::eComputeShader | PipelineStage::eTransfer;
+    constexpr auto anyWrite = AccessMask::eShaderStorageWrite | AccessMask::eTransferWrite;
+    auto states = std::vector(resourceCount, AccessState{ anyStage, anyWrite, -1, {}, anyStage, -1, {} });
+
+    auto lastBarrier = -1;
+    for (uint32_t i = 0; i < passCount; ++i) {
+        const auto& [name, type, reads, writes, record] = _passes[i];
+        const auto stage = type == PassType::Compute ? PipelineStage::eComputeShader : PipelineStage::eTransfer;
+        const auto access = type == PassType::Compute
+            ? AccessMask::eShaderStorageRead | AccessMask::eShaderStorageWrite
+            : AccessMask::eTransferRead | AccessMask::eTransferWrite;
+
+        // A hazard whose source precedes the last emitted barrier is folded into that barrier rather than adding
+        // a new one, the dependency then reaches this pass because it comes later in submission order
+        auto pending = vk::MemoryBarrier2{};
+        const auto require = [&](const int producer, const vk::PipelineStageFlags2 srcStage, const vk::AccessFlags2 srcAccess) {
+            auto& barrier = producer < lastBarrier ? graph._passes[lastBarrier].memoryBarrier : pending;
+            barrier.srcStageMask |= srcStage;
+            barrier.srcAccessMask |= srcAccess;
+            barrier.dstStageMask |= stage;
+            barrier.dstAccessMask |= srcAccess ? access : vk::AccessFlags2{};
+        };
+
+        for (const auto r : reads) {
+            for (const auto alias : aliases[r]) {
+                auto& state = states[alias];
+                if (state.writeStage && !(state.visibleStages & stage)) { // read after write
+                    require(state.writePass, state.writeStage, state.writeAccess);
+                    state.visibleStages |= stage;
+                }
+            }
+        }
+        for (const auto r : writes) {
+            for (const auto alias : aliases[r]) {
+                auto& state = states[alias];
+                if (state.writeStage && !(state.visibleStages & stage)) { // write after write
+                    require(state.writePass, state.writeStage, state.writeAccess);
+                    state.visibleStages |= stage;
+                }
+                if (state.readStages && !(state.syncedStages & stage)) { // write after read
+                    require(state.readPass, state.readStages, {});
+                    state.syncedStages |= stage;
+                }
+            }
+        }
+
+        auto& pass = graph._passes.emplace_back(Pass{ name, record, false, vk::MemoryBarrier2{} });
+        if (pending.dstStageMask) {
+            pass.barrier = true;
+            pass.memoryBarrier = pending;
+            lastBarrier = static_cast<int>(i);
+            graph._statistics.barrierCount++;
+
+            // The new barrier also covers whatever else its source scope includes
+            for (auto& state : states) {
+                const auto written = (state.writeStage & pending.srcStageMask) == state.writeStage;
+                if (written && (state.writeAccess & pending.srcAccessMask) == state.writeAccess) {
+                    state.visibleStages |= pending.dstStageMask;
+                }
+                if ((state.readStages & pending.srcStageMask) == state.readStages) {
+                    state.syncedStages |= pending.dstStageMask;
+                }
+            }
+        }
+
+        for (const auto r : reads) {
+            for (const auto alias : aliases[r]) {
+                states[alias].readStages |= stage;
+                states[alias].readPass = static_cast<int>(i);
+                states[alias].syncedStages = {};
+            }
+        }
+        for (const auto r : writes) {
+            for (const auto alias : aliases[r]) {
+                const auto writeAccess = type == PassType::Compute ? AccessMask::eShaderStorageWrite : AccessMask::eTransferWrite;
+                states[alias] = { stage, writeAccess, static_cast<int>(i), {}, {}, -1, {} };
+            }
+        }
+    }
+
+    return graph;
+}
+
+tpd::ComputeGraph::ComputeGraph(ComputeGraph&& other) noexcept
+    : _passes{ std::move(other._passes) }
+    , _buffers{ std::move(other._buffers) }
+    , _sizes{ std::move(other._sizes) }
+    , _allocation{ other._allocation }
+    , _statistics{ other._statistics }
+{
+    other._allocation = nullptr;
+    other._statistics = {};
+}
+
+tpd::ComputeGraph& tpd::ComputeGraph::operator=(ComputeGraph&& other) noexcept {
+    if (this == &other || valid()) {
+        return *this;
+    }
+
+    _passes = std::move(other._passes);
+    _buffers = std::move(other._buffers);
+    _sizes = std::move(other._sizes);
+    _allocation = other._allocation;
+    _statistics = other._statistics;
+
+    other._allocation = nullptr;
+    other._statistics = {};
+    return *this;
+}
+
+void tpd::ComputeGraph::record(const vk::CommandBuffer cmd) const {
+    for (const auto& [name, record, barrier, memoryBarrier] : _passes) {
+        if (barrier) {
+            cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &memoryBarrier });
+        }
+        record(cmd);
+    }
+}
+
+void tpd::ComputeGraph::destroy(const vk::Device device, VmaAllocator allocator) noexcept {
+    std::ranges::for_each(_buffers, [device](const auto buffer) { if (buffer) device.destroyBuffer(buffer); });
+    if (_allocation) {
+        vmaFreeMemory(allocator, _allocation);
+    }
+
+    _passes.clear();
+    _buffers.clear();
+    _sizes.clear();
+    _allocation = nullptr;
+    _statistics = {};
+}
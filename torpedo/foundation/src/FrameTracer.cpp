@@ -0,0 +1,183 @@
+#include "torpedo/foundation/FrameTracer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Event {
+        const char* name;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // A single-producer single-consumer ring: the owning thread pushes events, the exporting thread drains them
+    struct ThreadBuffer {
+        static constexpr uint64_t CAPACITY = 16384;
+
+        std::array<Event, CAPACITY> events{};
+        std::atomic<uint64_t> head{ 0 }; // written by the owning thread only
+        std::atomic<uint64_t> tail{ 0 }; // written by the exporting thread only
+        std::atomic<uint64_t> dropped{ 0 };
+
+        uint32_t threadId{ 0 };
+        std::string threadName{}; // guarded by the registry mutex
+    };
+
+    struct GpuEvent {
+        std::string track;
+        std::string name;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct Registry {
+        std::mutex mutex{};
+        // Buffers are shared with their threads so events of exited threads can still be exported
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers{};
+        std::vector<GpuEvent> gpuEvents{};
+        const std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+    };
+
+    Registry& getRegistry() {
+        static auto registry = Registry{};
+        return registry;
+    }
+
+    ThreadBuffer& getThreadBuffer() {
+        thread_local const auto buffer = [] {
+            auto& registry = getRegistry();
+            const auto threadBuffer = std::make_shared<ThreadBuffer>();
+
+            std::lock_guard lock(registry.mutex);
+            threadBuffer->threadId = static_cast<uint32_t>(registry.buffers.size());
+            threadBuffer->threadName = "thread-" + std::to_string(threadBuffer->threadId);
+            registry.buffers.push_back(threadBuffer);
+            return threadBuffer;
+        }();
+        return *buffer;
+    }
+
+    void writeEscaped(std::ostream& out, const std::string_view text) {
+        for (const auto c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+    }
+
+    void writeZone(
+        std::ostream& out, const std::string_view name, const uint32_t pid, const uint32_t tid,
+        const uint64_t begin, const uint64_t end, bool& first)
+    {
+        // Chrome trace timestamps are in microseconds
+        out << (first ? "\n" : ",\n") << R"({"ph":"X","name":")";
+        writeEscaped(out, name);
+        out << R"(","pid":)" << pid << R"(,"tid":)" << tid
+            << R"(,"ts":)" << static_cast<double>(begin) * 1e-3
+            << R"(,"dur":)" << static_cast<double>(end - begin) * 1e-3 << "}";
+        first = false;
+    }
+
+    void writeThreadName(std::ostream& out, const std::string_view name, const uint32_t pid, const uint32_t tid, bool& first) {
+        out << (first ? "\n" : ",\n") << R"({"ph":"M","name":"thread_name","pid":)" << pid << R"(,"tid":)" << tid
+            << R"(,"args":{"name":")";
+        writeEscaped(out, name);
+        out << R"("}})";
+        first = false;
+    }
+} // namespace
+
+std::atomic<bool> tpd::FrameTracer::_enabled{ false };
+
+void tpd::FrameTracer::setThreadName(const std::string_view name) {
+    auto& buffer = getThreadBuffer();
+    std::lock_guard lock(getRegistry().mutex);
+    buffer.threadName = name;
+}
+
+uint64_t tpd::FrameTracer::now() noexcept {
+    const auto elapsed = std::chrono::steady_clock::now() - getRegistry().epoch;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void tpd::FrameTracer::recordZone(const char* name, const uint64_t begin, const uint64_t end) noexcept {
+    auto& buffer = getThreadBuffer();
+
+    const auto head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= ThreadBuffer::CAPACITY) [[unlikely]] {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[head % ThreadBuffer::CAPACITY] = { name, begin, end };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void tpd::FrameTracer::recordGpuZone(const std::string_view track, const std::string_view name, const uint64_t begin, const uint64_t end) {
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.gpuEvents.push_back({ std::string{ track }, std::string{ name }, begin, end });
+}
+
+bool tpd::FrameTracer::exportChromeTrace(const std::filesystem::path& file) {
+    auto out = std::ofstream{ file };
+    if (!out.is_open()) [[unlikely]] {
+        return false;
+    }
+
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+
+    // Nanosecond resolution on a microsecond scale, without switching to scientific notation for long captures
+    out << std::fixed << std::setprecision(3);
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    auto first = true;
+    auto dropped = uint64_t{ 0 };
+
+    // Host zones go to process 0, one track per thread
+    for (const auto& buffer : registry.buffers) {
+        writeThreadName(out, buffer->threadName, 0, buffer->threadId, first);
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+
+        const auto head = buffer->head.load(std::memory_order_acquire);
+        const auto tail = buffer->tail.load(std::memory_order_relaxed);
+        for (auto i = tail; i < head; ++i) {
+            const auto& [name, begin, end] = buffer->events[i % ThreadBuffer::CAPACITY];
+            writeZone(out, name, 0, buffer->threadId, begin, end, first);
+        }
+        buffer->tail.store(head, std::memory_order_release);
+    }
+
+    // GPU zones go to process 1, one track per profiler
+    auto gpuTracks = std::vector<std::string_view>{};
+    for (const auto& [track, name, begin, end] : registry.gpuEvents) {
+        const auto trackId = static_cast<uint32_t>(std::ranges::find(gpuTracks, track) - gpuTracks.begin());
+        if (trackId == gpuTracks.size()) {
+            gpuTracks.emplace_back(track);
+            writeThreadName(out, track, 1, trackId, first);
+        }
+        writeZone(out, name, 1, trackId, begin, end, first);
+    }
+    registry.gpuEvents.clear();
+
+    // Also report events that did not fit in their thread buffer since the last export
+    out << "\n]," << R"("otherData":{"droppedEvents":)" << dropped << "}}\n";
+    return out.good();
+}
+
+void tpd::FrameTracer::clear() {
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+
+    for (const auto& buffer : registry.buffers) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+    registry.gpuEvents.clear();
+}
@@ -0,0 +1,88 @@
+#include "torpedo/foundation/GpuPrefixScan.h"
+
+#include <torpedo_foundation_spirv.h>
+
+tpd::GpuPrefixScan tpd::GpuPrefixScan::Builder::build(const vk::Device device) const {
+    const auto slangFile = std::string{ _subgroupKernels ? "scan-subgroup.slang" : "scan.slang" };
+    const auto code = spirv::foundation(slangFile);
+    if (code.empty()) [[unlikely]] {
+        throw std::runtime_error("GpuPrefixScan::Builder - Missing SPIR-V code for " + slangFile);
+    }
+
+    auto scan = GpuPrefixScan{};
+    scan._device = device;
+
+    const auto pushConstantRange = vk::PushConstantRange{ vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants) };
+    scan._pipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{}.setPushConstantRanges(pushConstantRange));
+
+    const auto shaderModule = device.createShaderModule(vk::ShaderModuleCreateInfo{}
+        .setCodeSize(code.size_bytes())
+        .setPCode(code.data()));
+
+    // Subgroup kernels derive the subgroup index from the local index, which takes subgroups to be full
+    using enum vk::PipelineShaderStageCreateFlagBits;
+    const auto stageFlags = _subgroupKernels ? eRequireFullSubgroups : vk::PipelineShaderStageCreateFlags{};
+    const auto pipelineInfo = vk::ComputePipelineCreateInfo{}
+        .setStage({ stageFlags, vk::ShaderStageFlagBits::eCompute, shaderModule, "main" })
+        .setLayout(scan._pipelineLayout);
+    scan._pipeline = device.createComputePipeline(_pipelineCache, pipelineInfo).value;
+
+    device.destroyShaderModule(shaderModule);
+    return scan;
+}
+
+bool tpd::GpuPrefixScan::subgroupSupported(const vk::PhysicalDevice physicalDevice) {
+    auto subgroupProperties = vk::PhysicalDeviceSubgroupProperties{};
+    auto properties = vk::PhysicalDeviceProperties2{};
+    properties.pNext = &subgroupProperties;
+    physicalDevice.getProperties2(&properties);
+
+    using enum vk::SubgroupFeatureFlagBits;
+    constexpr auto operations = eBasic | eArithmetic | eBallot;
+    return (subgroupProperties.supportedStages & vk::ShaderStageFlagBits::eCompute)
+        && (subgroupProperties.supportedOperations & operations) == operations
+        && subgroupProperties.subgroupSize >= 4; // radix-shuffle.slang sizes shared memory for 4+ lanes
+}
+
+void tpd::GpuPrefixScan::record(const vk::CommandBuffer cmd, const Input& input) const {
+    if (input.count == 0) {
+        return;
+    }
+
+    // Workgroups pick their partitions from an atomic counter, which must start from zero for every scan
+    constexpr auto clearBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &clearBarrier });
+    cmd.fillBuffer(input.scratch, 0, sizeof(uint32_t), 0);
+
+    constexpr auto scanBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &scanBarrier });
+
+    const auto scratch = _device.getBufferAddress(vk::BufferDeviceAddressInfo{ input.scratch });
+    const auto pc = PushConstants{
+        _device.getBufferAddress(vk::BufferDeviceAddressInfo{ input.data }) + input.offset,
+        scratch,
+        scratch + sizeof(uint32_t),
+        input.total ? _device.getBufferAddress(vk::BufferDeviceAddressInfo{ input.total }) + input.totalOffset : 0,
+        input.count,
+        input.stride,
+    };
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _pipeline);
+    cmd.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants), &pc);
+    cmd.dispatch((input.count + PARTITION_SIZE - 1) / PARTITION_SIZE, 1, 1);
+}
+
+void tpd::GpuPrefixScan::destroy() noexcept {
+    if (_device) {
+        _device.destroyPipeline(_pipeline);
+        _device.destroyPipelineLayout(_pipelineLayout);
+    }
+    _pipeline = nullptr;
+    _pipelineLayout = nullptr;
+    _device = nullptr;
+}
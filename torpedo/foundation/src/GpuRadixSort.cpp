@@ -0,0 +1,225 @@
+#include "torpedo/foundation/GpuRadixSort.h"
+#include "torpedo/foundation/GpuPrefixScan.h"
+
+#include <torpedo_foundation_spirv.h>
+
+#include <algorithm>
+
+namespace {
+    vk::Pipeline createPipeline(
+        const vk::Device device, const vk::PipelineLayout layout, const vk::PipelineCache cache,
+        const std::string& slangFile, const vk::PipelineShaderStageCreateFlags stageFlags)
+    {
+        const auto code = tpd::spirv::foundation(slangFile);
+        if (code.empty()) [[unlikely]] {
+            throw std::runtime_error("GpuRadixSort::Builder - Missing SPIR-V code for " + slangFile);
+        }
+
+        const auto shaderModule = device.createShaderModule(vk::ShaderModuleCreateInfo{}
+            .setCodeSize(code.size_bytes())
+            .setPCode(code.data()));
+
+        const auto pipelineInfo = vk::ComputePipelineCreateInfo{}
+            .setStage({ stageFlags, vk::ShaderStageFlagBits::eCompute, shaderModule, "main" })
+            .setLayout(layout);
+        const auto pipeline = device.createComputePipeline(cache, pipelineInfo).value;
+
+        device.destroyShaderModule(shaderModule);
+        return pipeline;
+    }
+
+    // Every kernel of a pass reads what the previous one wrote, including the partition counters
+    constexpr auto KERNEL_BARRIER = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+        vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite };
+} // namespace
+
+tpd::GpuRadixSort tpd::GpuRadixSort::Builder::build(const vk::Device device) const {
+    auto sort = GpuRadixSort{};
+    sort._device = device;
+    sort._keyType = _keyType;
+
+    const auto pushConstantRange = vk::PushConstantRange{ vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants) };
+    sort._pipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{}.setPushConstantRanges(pushConstantRange));
+
+    // Only the shuffle and mapping kernels touch the keys, the prefix kernels work on per-block counts. The mapping
+    // kernel has no subgroup variant, it only moves keys around.
+    const auto key = std::string{ _keyType == KeyType::Uint32 ? "-32" : "" };
+    const auto subgroup = std::string{ _subgroupKernels ? "-subgroup" : "" };
+
+    // Subgroup kernels derive the subgroup index from the local index, which takes subgroups to be full
+    using enum vk::PipelineShaderStageCreateFlagBits;
+    const auto stageFlags = _subgroupKernels ? eRequireFullSubgroups : vk::PipelineShaderStageCreateFlags{};
+    const auto create = [&](const std::string& slangFile, const vk::PipelineShaderStageCreateFlags flags) {
+        return createPipeline(device, sort._pipelineLayout, _pipelineCache, slangFile, flags);
+    };
+
+    try {
+        sort._shufflePipeline = create("radix-shuffle" + key + subgroup + ".slang", stageFlags);
+        sort._prefixAPipeline = create("radix-prefixA" + subgroup + ".slang", stageFlags);
+        sort._prefixBPipeline = create("radix-prefixB" + subgroup + ".slang", stageFlags);
+        sort._mappingPipeline = create("radix-mapping" + key + ".slang", {});
+    } catch (...) {
+        sort.destroy();
+        throw;
+    }
+
+    return sort;
+}
+
+bool tpd::GpuRadixSort::subgroupSupported(const vk::PhysicalDevice physicalDevice) {
+    return GpuPrefixScan::subgroupSupported(physicalDevice);
+}
+
+tpd::GpuRadixSort::ScratchLayout tpd::GpuRadixSort::getScratchLayout(const uint32_t capacity) const noexcept {
+    const auto blockCount = std::max((capacity + BLOCK_SIZE - 1) / BLOCK_SIZE, 1u);
+    const auto descriptorCount = (blockCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const auto keySize = _keyType == KeyType::Uint32 ? sizeof(uint32_t) : sizeof(uint64_t);
+
+    // 2 partition counters and 3 radix totals, padded so that the 64-bit regions that follow stay aligned
+    constexpr vk::DeviceSize countersSize = 24;
+
+    auto layout = ScratchLayout{};
+    layout.prefixA = countersSize;
+    layout.prefixB = layout.prefixA + sizeof(uint64_t) * blockCount;
+    layout.descriptorA = layout.prefixB + sizeof(uint64_t) * blockCount;
+    layout.descriptorB = layout.descriptorA + sizeof(uint64_t) * descriptorCount;
+    layout.tempKeys = layout.descriptorB + sizeof(uint64_t) * descriptorCount;
+    layout.tempVals = layout.tempKeys + keySize * std::max(capacity, 1u);
+    layout.size = layout.tempVals + sizeof(uint32_t) * std::max(capacity, 1u);
+    return layout;
+}
+
+tpd::GpuRadixSort::PushConstants tpd::GpuRadixSort::getPushConstants(const Input& input, const uint32_t pass) const {
+    const auto address = [this](const vk::Buffer buffer) {
+        return buffer ? _device.getBufferAddress(vk::BufferDeviceAddressInfo{ buffer }) : vk::DeviceAddress{ 0 };
+    };
+
+    const auto layout = getScratchLayout(input.capacity);
+    const auto scratch = address(input.scratch);
+    const auto shift = input.beginBit + 2 * pass;
+
+    auto pc = PushConstants{};
+    pc.keys = address(input.keys);
+    pc.values = address(input.values);
+    pc.tempKeys = scratch + layout.tempKeys;
+    pc.tempVals = scratch + layout.tempVals;
+    pc.prefixA = scratch + layout.prefixA;
+    pc.prefixB = scratch + layout.prefixB;
+    pc.descriptorA = scratch + layout.descriptorA;
+    pc.descriptorB = scratch + layout.descriptorB;
+    pc.counters = scratch;
+    pc.shift = shift;
+    pc.bits = std::min(2u, input.endBit - shift);
+    return pc;
+}
+
+void tpd::GpuRadixSort::record(
+    const vk::CommandBuffer cmd,
+    const Input& input,
+    const uint32_t count,
+    const Profiling* const profiling) const
+{
+    if (count == 0) {
+        return;
+    }
+
+    const auto passCount = getPassCount(input.beginBit, input.endBit);
+    for (uint32_t pass = 0; pass < passCount; ++pass) {
+        if (pass > 0) {
+            cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &KERNEL_BARRIER });
+        }
+        recordPass(cmd, input, count, pass, profiling);
+    }
+}
+
+void tpd::GpuRadixSort::recordPass(
+    const vk::CommandBuffer cmd,
+    const Input& input,
+    const uint32_t count,
+    const uint32_t pass,
+    const Profiling* const profiling) const
+{
+    auto pc = getPushConstants(input, pass);
+    pc.count = count;
+    recordKernels(cmd, pc, getDispatch(count), nullptr, 0, pass, profiling);
+}
+
+void tpd::GpuRadixSort::recordPassIndirect(
+    const vk::CommandBuffer cmd,
+    const Input& input,
+    const uint32_t pass,
+    const vk::Buffer dispatchBuffer,
+    const vk::DeviceSize dispatchOffset,
+    const Profiling* const profiling) const
+{
+    auto pc = getPushConstants(input, pass);
+    pc.countAddress = _device.getBufferAddress(vk::BufferDeviceAddressInfo{ dispatchBuffer }) + dispatchOffset + offsetof(Dispatch, count);
+    recordKernels(cmd, pc, {}, dispatchBuffer, dispatchOffset, pass, profiling);
+}
+
+void tpd::GpuRadixSort::recordKernels(
+    const vk::CommandBuffer cmd,
+    const PushConstants& pc,
+    const Dispatch& dispatch,
+    const vk::Buffer dispatchBuffer,
+    const vk::DeviceSize dispatchOffset,
+    const uint32_t pass,
+    const Profiling* const profiling) const
+{
+    const auto dispatchSort = [&] {
+        if (dispatchBuffer) cmd.dispatchIndirect(dispatchBuffer, dispatchOffset + offsetof(Dispatch, sort));
+        else cmd.dispatch(dispatch.sort.x, 1, 1);
+    };
+    const auto dispatchPrefix = [&] {
+        if (dispatchBuffer) cmd.dispatchIndirect(dispatchBuffer, dispatchOffset + offsetof(Dispatch, prefix));
+        else cmd.dispatch(dispatch.prefix.x, 1, 1);
+    };
+    const auto begin = [&](uint32_t Profiling::* stage) {
+        if (profiling) profiling->profiler->recordBegin(cmd, profiling->frameIndex, profiling->*stage, pass);
+    };
+    const auto end = [&](uint32_t Profiling::* stage) {
+        if (profiling) profiling->profiler->recordEnd(cmd, profiling->frameIndex, profiling->*stage, pass);
+    };
+
+    // All kernels share the same layout, binding a pipeline keeps the pushed constants
+    cmd.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants), &pc);
+
+    // Local shuffling, also resets the partition counters of the prefix kernels
+    begin(&Profiling::shuffleStage);
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _shufflePipeline);
+    dispatchSort();
+    end(&Profiling::shuffleStage);
+    cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &KERNEL_BARRIER });
+
+    // Radix 0/1 and radix 2/3 prefixes are independent of each other
+    begin(&Profiling::prefixStage);
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _prefixAPipeline);
+    dispatchPrefix();
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _prefixBPipeline);
+    dispatchPrefix();
+    end(&Profiling::prefixStage);
+    cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &KERNEL_BARRIER });
+
+    // Coalesced mapping
+    begin(&Profiling::mappingStage);
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _mappingPipeline);
+    dispatchSort();
+    end(&Profiling::mappingStage);
+}
+
+void tpd::GpuRadixSort::destroy() noexcept {
+    if (_device) {
+        _device.destroyPipeline(_shufflePipeline);
+        _device.destroyPipeline(_prefixAPipeline);
+        _device.destroyPipeline(_prefixBPipeline);
+        _device.destroyPipeline(_mappingPipeline);
+        _device.destroyPipelineLayout(_pipelineLayout);
+    }
+    _shufflePipeline = nullptr;
+    _prefixAPipeline = nullptr;
+    _prefixBPipeline = nullptr;
+    _mappingPipeline = nullptr;
+    _pipelineLayout = nullptr;
+    _device = nullptr;
+}
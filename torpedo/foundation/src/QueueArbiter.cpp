@@ -0,0 +1,55 @@
+#include "torpedo/foundation/QueueArbiter.h"
+#include "torpedo/foundation/FrameTracer.h"
+
+#include <algorithm>
+
+tpd::QueueArbiter::QueueArbiter(const vk::Device device, const std::span<const uint32_t> queueFamilies) : _device{ device } {
+    for (const auto family : queueFamilies) {
+        const auto queue = device.getQueue(family, 0);
+        if (!std::ranges::contains(_entries, queue, &Entry::queue)) {
+            _entries.push_back({ queue, std::make_unique<TicketLock>() });
+        }
+    }
+}
+
+void tpd::QueueArbiter::submit(const vk::Queue queue, const vk::SubmitInfo2& submitInfo, const vk::Fence fence) {
+    auto& lock = getLock(queue);
+    TPD_TRACE_ZONE("QueueArbiter::submit"); // time spent waiting for other clients included
+    const auto guard = std::lock_guard{ lock };
+    queue.submit2(submitInfo, fence);
+}
+
+void tpd::QueueArbiter::waitIdle() {
+    exclusive([this] { _device.waitIdle(); });
+}
+
+tpd::QueueArbiter::TicketLock& tpd::QueueArbiter::getLock(const vk::Queue queue) {
+    const auto it = std::ranges::find(_entries, queue, &Entry::queue);
+    if (it == _entries.end()) [[unlikely]] {
+        throw std::invalid_argument("QueueArbiter - Unrecognized queue for submission");
+    }
+    return *it->lock;
+}
+
+void tpd::QueueArbiter::lockAll() {
+    // A single order for everyone taking more than one lock, submissions only ever take one
+    std::ranges::for_each(_entries, [](const Entry& entry) { entry.lock->lock(); });
+}
+
+void tpd::QueueArbiter::unlockAll() noexcept {
+    std::ranges::for_each(_entries, [](const Entry& entry) { entry.lock->unlock(); });
+}
+
+void tpd::QueueArbiter::TicketLock::lock() {
+    auto guard = std::unique_lock{ _mutex };
+    const auto ticket = _nextTicket++;
+    _served.wait(guard, [this, ticket] { return _nowServing == ticket; });
+}
+
+void tpd::QueueArbiter::TicketLock::unlock() noexcept {
+    {
+        const auto guard = std::lock_guard{ _mutex };
+        ++_nowServing;
+    }
+    _served.notify_all();
+}
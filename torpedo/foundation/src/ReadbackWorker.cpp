@@ -0,0 +1,264 @@
+#include "torpedo/foundation/ReadbackWorker.h"
+#include "torpedo/foundation/FrameTracer.h"
+
+#include <limits>
+#include <numeric>
+
+tpd::ReadbackWorker::ReadbackWorker(
+    const uint32_t queueFamily,
+    const vk::Device device,
+    VmaAllocator vmaAllocator,
+    const vk::DeviceSize stagingRingSize,
+    QueueArbiter* arbiter)
+    : _device{ device }
+    , _vmaAllocator{ vmaAllocator }
+    , _queue{ device.getQueue(queueFamily, 0) }
+    , _arbiter{ arbiter }
+    , _stagingRingSize{ stagingRingSize }
+{
+    // Command buffers are recycled once their batch completes, beginning one again resets it
+    _commandPool = device.createCommandPool({ vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queueFamily });
+
+    auto semaphoreTypeInfo = vk::SemaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, 0 };
+    auto semaphoreInfo = vk::SemaphoreCreateInfo{};
+    semaphoreInfo.pNext = &semaphoreTypeInfo;
+    _timeline = device.createSemaphore(semaphoreInfo);
+
+    // Random host access prefers host-cached memory, reading from write-combined memory is painfully slow
+    const auto ringInfo = vk::BufferCreateInfo{ {}, stagingRingSize, vk::BufferUsageFlagBits::eTransferDst, vk::SharingMode::eExclusive };
+    auto ringAllocation = VmaAllocation{};
+    auto ringAllocationInfo = VmaAllocationInfo{};
+    const auto ring = vma::allocateTwoWayBuffer(vmaAllocator, ringInfo, &ringAllocation, &ringAllocationInfo);
+    _stagingRing = OpaqueResource{ ring, ringAllocation };
+    _stagingData = static_cast<const std::byte*>(ringAllocationInfo.pMappedData);
+}
+
+void tpd::ReadbackWorker::enqueue(
+    const vk::Buffer buffer,
+    const vk::DeviceSize offset,
+    const vk::DeviceSize size,
+    const SyncPoint srcSync,
+    Callback&& callback)
+{
+    if (size == 0) {
+        callback({});
+        return;
+    }
+
+    // Aligned so that the host can read any scalar or vector type straight from the span
+    const auto ringOffset = reserveStaging(size, 16);
+    _bufferCopies.push_back({ buffer, vk::BufferCopy{ offset, ringOffset % _stagingRingSize, size } });
+    _readbacks.push_back({ ringOffset, size, std::move(callback) });
+
+    _srcSync.stage |= srcSync.stage;
+    _srcSync.access |= srcSync.access;
+}
+
+void tpd::ReadbackWorker::enqueue(const ImageRegion& region, const SyncPoint srcSync, Callback&& callback) {
+    const auto [width, height, depth] = region.extent;
+    const auto size = vk::DeviceSize{ region.texelSize } * width * height * depth * region.subresource.layerCount;
+    if (size == 0) {
+        callback({});
+        return;
+    }
+
+    // Buffer offsets of image copies must be a multiple of the texel size, and of 4 for depth/stencil formats
+    const auto ringOffset = reserveStaging(size, std::lcm(vk::DeviceSize{ 16 }, vk::DeviceSize{ region.texelSize }));
+    const auto copy = vk::BufferImageCopy{ ringOffset % _stagingRingSize, 0, 0, region.subresource, region.offset, region.extent };
+    _imageCopies.push_back({ region.image, region.layout, copy });
+    _readbacks.push_back({ ringOffset, size, std::move(callback) });
+
+    _srcSync.stage |= srcSync.stage;
+    _srcSync.access |= srcSync.access;
+}
+
+std::future<std::vector<std::byte>> tpd::ReadbackWorker::enqueue(
+    const vk::Buffer buffer,
+    const vk::DeviceSize offset,
+    const vk::DeviceSize size,
+    const SyncPoint srcSync)
+{
+    auto promise = std::promise<std::vector<std::byte>>{};
+    auto future = promise.get_future();
+    enqueue(buffer, offset, size, srcSync, [promise = std::move(promise)](const std::span<const std::byte> data) mutable {
+        promise.set_value({ data.begin(), data.end() });
+    });
+    return future;
+}
+
+std::future<std::vector<std::byte>> tpd::ReadbackWorker::enqueue(const ImageRegion& region, const SyncPoint srcSync) {
+    auto promise = std::promise<std::vector<std::byte>>{};
+    auto future = promise.get_future();
+    enqueue(region, srcSync, [promise = std::move(promise)](const std::span<const std::byte> data) mutable {
+        promise.set_value({ data.begin(), data.end() });
+    });
+    return future;
+}
+
+uint64_t tpd::ReadbackWorker::submit(const std::span<const vk::SemaphoreSubmitInfo> waitInfos, const vk::Fence fence) {
+    if (_readbacks.empty()) {
+        // Nothing to copy, though whoever waits on the fence still expects it to be signaled
+        if (fence) {
+            const auto submitInfo = vk::SubmitInfo2{}
+                .setWaitSemaphoreInfoCount(static_cast<uint32_t>(waitInfos.size()))
+                .setPWaitSemaphoreInfos(waitInfos.data());
+            submitToQueue(submitInfo, fence);
+        }
+        return _timelineValue;
+    }
+    TPD_TRACE_ZONE("ReadbackWorker::submit");
+
+    const auto command = getCommandBuffer();
+    command.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    // A single barrier covers the last writes to every region, when they were made earlier on the same queue
+    if (_srcSync.stage) {
+        const auto srcBarrier = vk::MemoryBarrier2{
+            _srcSync.stage, _srcSync.access, vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead };
+        command.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &srcBarrier });
+    }
+
+    for (const auto& [buffer, region] : _bufferCopies) {
+        command.copyBuffer(buffer, _stagingRing, region);
+    }
+    for (const auto& [image, layout, region] : _imageCopies) {
+        command.copyImageToBuffer(image, layout, _stagingRing, region);
+    }
+
+    // Signaling the timeline alone does not make the copies available to the host
+    constexpr auto hostBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead };
+    command.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &hostBarrier });
+    command.end();
+
+    const auto commandInfo = vk::CommandBufferSubmitInfo{ command, 0b1 }; // device mask is ignored by single-GPU setups
+    const auto signalInfo = vk::SemaphoreSubmitInfo{ _timeline, ++_timelineValue, vk::PipelineStageFlagBits2::eAllCommands, 0 };
+    const auto submitInfo = vk::SubmitInfo2{}
+        .setWaitSemaphoreInfoCount(static_cast<uint32_t>(waitInfos.size()))
+        .setPWaitSemaphoreInfos(waitInfos.data())
+        .setCommandBufferInfos(commandInfo)
+        .setSignalSemaphoreInfos(signalInfo);
+    submitToQueue(submitInfo, fence);
+
+    _batches.push_back({ _timelineValue, command, _ringHead, std::move(_readbacks) });
+    _readbacks.clear();
+    _bufferCopies.clear();
+    _imageCopies.clear();
+    _srcSync = {};
+
+    return _timelineValue;
+}
+
+void tpd::ReadbackWorker::poll() {
+    if (_batches.empty()) {
+        return;
+    }
+
+    const auto completedValue = _device.getSemaphoreCounterValue(_timeline);
+    while (!_batches.empty() && _batches.front().value <= completedValue) {
+        // Callbacks may enqueue more readbacks, so the batch leaves the queue before they are invoked
+        auto batch = std::move(_batches.front());
+        _batches.pop_front();
+        retireBatch(batch);
+    }
+}
+
+void tpd::ReadbackWorker::retireBatch(Batch& batch) {
+    TPD_TRACE_ZONE("ReadbackWorker::deliver");
+    for (auto& [ringOffset, size, callback] : batch.readbacks) {
+        const auto offset = ringOffset % _stagingRingSize;
+        vmaInvalidateAllocation(_vmaAllocator, _stagingRing.getAllocation(), offset, size);
+        callback(std::span{ _stagingData + offset, size });
+    }
+
+    _ringTail = batch.ringEnd;
+    _freeCommandBuffers.push_back(batch.command);
+}
+
+void tpd::ReadbackWorker::wait(const uint64_t value) {
+    if (value > _timelineValue) [[unlikely]] {
+        throw std::invalid_argument("ReadbackWorker - Cannot wait for a timeline value that has not been submitted");
+    }
+
+    {
+        using limits = std::numeric_limits<uint64_t>;
+        TPD_TRACE_ZONE("ReadbackWorker::wait");
+        const auto waitInfo = vk::SemaphoreWaitInfo{ {}, 1, &_timeline, &value };
+        [[maybe_unused]] const auto result = _device.waitSemaphores(waitInfo, limits::max());
+    }
+    poll();
+}
+
+void tpd::ReadbackWorker::waitIdle() {
+    wait(_timelineValue);
+}
+
+vk::DeviceSize tpd::ReadbackWorker::reserveStaging(const vk::DeviceSize size, const vk::DeviceSize alignment) {
+    if (size > _stagingRingSize) [[unlikely]] {
+        throw std::invalid_argument("ReadbackWorker - Region is larger than the staging ring");
+    }
+
+    const auto ringOffset = _ringHead % _stagingRingSize;
+    auto position = _ringHead - ringOffset + (ringOffset + alignment - 1) / alignment * alignment;
+
+    // Regions never wrap around the end of the ring, each gets delivered as a single span
+    if (position % _stagingRingSize + size > _stagingRingSize || position % _stagingRingSize < ringOffset) {
+        position = (_ringHead / _stagingRingSize + 1) * _stagingRingSize;
+    }
+
+    while (position + size - _ringTail > _stagingRingSize) {
+        if (_batches.empty()) [[unlikely]] {
+            throw std::runtime_error("ReadbackWorker - Staging ring is full of regions not yet submitted, submit more often or use a larger ring");
+        }
+        wait(_batches.front().value);
+    }
+
+    _ringHead = position + size;
+    return position;
+}
+
+vk::CommandBuffer tpd::ReadbackWorker::getCommandBuffer() {
+    if (!_freeCommandBuffers.empty()) {
+        const auto command = _freeCommandBuffers.back();
+        _freeCommandBuffers.pop_back();
+        return command;
+    }
+
+    const auto allocInfo = vk::CommandBufferAllocateInfo{}
+        .setCommandPool(_commandPool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(1);
+    return _device.allocateCommandBuffers(allocInfo)[0];
+}
+
+void tpd::ReadbackWorker::submitToQueue(const vk::SubmitInfo2& submitInfo, const vk::Fence fence) {
+    if (_arbiter) {
+        _arbiter->submit(_queue, submitInfo, fence);
+    } else {
+        _queue.submit2(submitInfo, fence);
+    }
+}
+
+void tpd::ReadbackWorker::destroy() noexcept {
+    if (!_timeline) {
+        return;
+    }
+    waitIdle();
+
+    // Readbacks never submitted are dropped, their futures report a broken promise
+    _readbacks.clear();
+    _bufferCopies.clear();
+    _imageCopies.clear();
+
+    _stagingRing.destroy(_vmaAllocator);
+    _stagingData = nullptr;
+
+    _device.destroySemaphore(_timeline);
+    _timeline = nullptr;
+
+    // Destroying the pool frees all of its command buffers
+    _freeCommandBuffers.clear();
+    _device.destroyCommandPool(_commandPool);
+    _commandPool = nullptr;
+}
@@ -7,7 +7,7 @@ tpd::StorageBuffer tpd::StorageBuffer::Builder::build(VmaAllocator allocator) co
     const auto bufferCreateInfo = vk::BufferCreateInfo{ {}, _allocSize, usage, vk::SharingMode::eExclusive };
 
     auto allocation = VmaAllocation{};
-    const auto buffer = vma::allocateDeviceBuffer(allocator, bufferCreateInfo, &allocation);
+    const auto buffer = vma::allocateDeviceBuffer(allocator, bufferCreateInfo, &allocation, _strategy);
 
     return StorageBuffer{ buffer, allocation };
 }
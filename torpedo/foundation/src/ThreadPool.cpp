@@ -0,0 +1,151 @@
+#include "torpedo/foundation/ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+tpd::ThreadPool::ThreadPool(const uint32_t workerCount) {
+    const auto hardwareCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto count = workerCount > 0 ? workerCount : hardwareCount - 1;
+
+    for (uint32_t i = 0; i <= count; ++i) {
+        _ranges.push_back(std::make_unique<Range>());
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        _workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+void tpd::ThreadPool::parallelFor(const uint32_t count, const std::function<void(uint32_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    // No worker touches the ranges between loops, the lock below publishes them
+    const auto participants = static_cast<uint32_t>(_ranges.size());
+    for (uint32_t p = 0, begin = 0; p < participants; ++p) {
+        const auto size = count / participants + (p < count % participants ? 1 : 0);
+        _ranges[p]->begin = begin;
+        _ranges[p]->end = begin + size;
+        begin += size;
+    }
+
+    {
+        const auto lock = std::lock_guard{ _mutex };
+        _task = &task;
+        _exception = nullptr;
+        _activeWorkers = static_cast<uint32_t>(_workers.size());
+        ++_generation;
+    }
+    _loopStarted.notify_all();
+
+    runLoop(participants - 1);
+
+    // Workers may still be running the last items they took, or looking for more
+    {
+        auto lock = std::unique_lock{ _mutex };
+        _loopDrained.wait(lock, [this] { return _activeWorkers == 0; });
+        _task = nullptr;
+    }
+
+    if (_exception) [[unlikely]] {
+        std::rethrow_exception(std::exchange(_exception, nullptr));
+    }
+}
+
+void tpd::ThreadPool::work(const uint32_t participant) {
+    auto generation = uint64_t{ 0 };
+    while (true) {
+        {
+            auto lock = std::unique_lock{ _mutex };
+            _loopStarted.wait(lock, [this, generation] { return _stopping || _generation != generation; });
+            if (_stopping) {
+                return;
+            }
+            generation = _generation;
+        }
+
+        runLoop(participant);
+
+        // The loop cannot return, and so the next one cannot start, before every worker has checked out of this one
+        auto lastOut = false;
+        {
+            const auto lock = std::lock_guard{ _mutex };
+            lastOut = --_activeWorkers == 0;
+        }
+        if (lastOut) {
+            _loopDrained.notify_one();
+        }
+    }
+}
+
+void tpd::ThreadPool::runLoop(const uint32_t participant) {
+    auto index = uint32_t{ 0 };
+    do {
+        while (takeOwn(participant, index)) {
+            try {
+                (*_task)(index);
+            } catch (...) {
+                {
+                    const auto lock = std::lock_guard{ _mutex };
+                    if (!_exception) _exception = std::current_exception();
+                }
+                abandon();
+            }
+        }
+    } while (steal(participant));
+}
+
+bool tpd::ThreadPool::takeOwn(const uint32_t participant, uint32_t& index) {
+    auto& range = *_ranges[participant];
+    const auto lock = std::lock_guard{ range.mutex };
+    if (range.begin == range.end) {
+        return false;
+    }
+    index = range.begin++;
+    return true;
+}
+
+bool tpd::ThreadPool::steal(const uint32_t participant) {
+    const auto participants = static_cast<uint32_t>(_ranges.size());
+
+    // Victims are visited starting from the next participant, spreading thieves over different ranges
+    for (uint32_t i = 1; i < participants; ++i) {
+        auto& victim = *_ranges[(participant + i) % participants];
+        auto begin = uint32_t{ 0 };
+        auto end = uint32_t{ 0 };
+        {
+            const auto lock = std::lock_guard{ victim.mutex };
+            const auto remaining = victim.end - victim.begin;
+            if (remaining == 0) {
+                continue;
+            }
+            // The victim keeps the front, which it is about to take next, and loses the back half
+            end = victim.end;
+            begin = end - (remaining + 1) / 2;
+            victim.end = begin;
+        }
+
+        auto& range = *_ranges[participant];
+        const auto lock = std::lock_guard{ range.mutex };
+        range.begin = begin;
+        range.end = end;
+        return true;
+    }
+    return false;
+}
+
+void tpd::ThreadPool::abandon() {
+    for (const auto& range : _ranges) {
+        const auto lock = std::lock_guard{ range->mutex };
+        range->begin = range->end;
+    }
+}
+
+tpd::ThreadPool::~ThreadPool() noexcept {
+    {
+        const auto lock = std::lock_guard{ _mutex };
+        _stopping = true;
+    }
+    _loopStarted.notify_all();
+    std::ranges::for_each(_workers, [](std::thread& worker) { worker.join(); });
+}
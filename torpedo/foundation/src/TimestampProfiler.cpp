@@ -0,0 +1,149 @@
+#include "torpedo/foundation/TimestampProfiler.h"
+#include "torpedo/foundation/FrameTracer.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+tpd::TimestampProfiler tpd::TimestampProfiler::Builder::build(const vk::PhysicalDevice physicalDevice, const vk::Device device) const {
+    if (_stages.empty()) [[unlikely]] {
+        throw std::runtime_error("TimestampProfiler::Builder - No stage to profile: did you forget to call Builder::stage()?");
+    }
+
+    auto profiler = TimestampProfiler{};
+    profiler._timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+    profiler._traceTrack = _traceTrack;
+
+    for (const auto& [name, instanceCount] : _stages) {
+        profiler._stages.push_back({ name, profiler._slotCount, instanceCount, std::vector(_historySize, 0.0f), 0, 0 });
+        profiler._slotCount += instanceCount;
+    }
+
+    // Each slot holds a begin and an end timestamp
+    const auto poolInfo = vk::QueryPoolCreateInfo{}
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(profiler._slotCount * 2);
+
+    for (uint32_t i = 0; i < _frameCount; ++i) {
+        profiler._queryPools.push_back(device.createQueryPool(poolInfo));
+    }
+    profiler._recorded.resize(_frameCount, false);
+
+    return profiler;
+}
+
+bool tpd::TimestampProfiler::supported(const vk::PhysicalDevice physicalDevice, const uint32_t queueFamilyIndex) {
+    const auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+    return queueFamilyIndex < queueFamilies.size() && queueFamilies[queueFamilyIndex].timestampValidBits > 0;
+}
+
+void tpd::TimestampProfiler::recordReset(const vk::CommandBuffer cmd, const uint32_t frameIndex) {
+    cmd.resetQueryPool(_queryPools[frameIndex], 0, _slotCount * 2);
+    _recorded[frameIndex] = true;
+}
+
+void tpd::TimestampProfiler::calibrate(const vk::Device device, const vk::Queue queue, const vk::CommandPool commandPool) {
+    const auto queryPool = device.createQueryPool({ {}, vk::QueryType::eTimestamp, 1 });
+    const auto cmd = device.allocateCommandBuffers({ commandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
+    const auto fence = device.createFence({});
+
+    cmd.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    cmd.resetQueryPool(queryPool, 0, 1);
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, 0);
+    cmd.end();
+
+    // The timestamp is written somewhere between submission and fence signal, take the midpoint as its host time
+    const auto cmdInfo = vk::CommandBufferSubmitInfo{ cmd, 0b1 };
+    const auto before = FrameTracer::now();
+    queue.submit2(vk::SubmitInfo2{}.setCommandBufferInfos(cmdInfo), fence);
+    [[maybe_unused]] const auto waitResult = device.waitForFences(fence, vk::True, std::numeric_limits<uint64_t>::max());
+    const auto after = FrameTracer::now();
+
+    using enum vk::QueryResultFlagBits;
+    [[maybe_unused]] const auto result = device.getQueryPoolResults(
+        queryPool, 0, 1, sizeof(uint64_t), &_calibrationTicks, sizeof(uint64_t), e64 | eWait);
+    _calibrationTime = before + (after - before) / 2;
+    _calibrated = true;
+
+    device.destroyFence(fence);
+    device.freeCommandBuffers(commandPool, cmd);
+    device.destroyQueryPool(queryPool);
+}
+
+void tpd::TimestampProfiler::collect(const vk::Device device, const uint32_t frameIndex) {
+    // Queries of a pool that has never been reset must not be read
+    if (!_recorded[frameIndex]) {
+        return;
+    }
+
+    // Each query is followed by its availability value
+    const auto queryCount = _slotCount * 2;
+    auto results = std::vector<uint64_t>(queryCount * 2);
+
+    using enum vk::QueryResultFlagBits;
+    [[maybe_unused]] const auto result = device.getQueryPoolResults(
+        _queryPools[frameIndex], 0, queryCount,
+        results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+        e64 | eWithAvailability);
+
+    // Ticks are signed relative to the calibration point since frames may have been recorded before it
+    const auto toTracerTime = [this](const uint64_t ticks) {
+        const auto delta = static_cast<double>(static_cast<int64_t>(ticks - _calibrationTicks)) * _timestampPeriod;
+        return static_cast<uint64_t>(static_cast<double>(_calibrationTime) + delta);
+    };
+    const auto trace = _calibrated && FrameTracer::enabled();
+
+    for (auto& stage : _stages) {
+        auto ticks = uint64_t{ 0 };
+        auto available = false;
+
+        for (auto slot = stage.firstSlot; slot < stage.firstSlot + stage.instanceCount; ++slot) {
+            const auto begin = slot * 4; // 2 queries per slot, 2 values per query
+            if (results[begin + 1] == 0 || results[begin + 3] == 0) continue;
+            ticks += results[begin + 2] - results[begin];
+            available = true;
+
+            if (trace) [[unlikely]] {
+                FrameTracer::recordGpuZone(_traceTrack, stage.name, toTracerTime(results[begin]), toTracerTime(results[begin + 2]));
+            }
+        }
+
+        if (!available) continue;
+        stage.history[stage.cursor] = static_cast<float>(ticks) * _timestampPeriod * 1e-6f;
+        stage.cursor = (stage.cursor + 1) % stage.history.size();
+        stage.sampleCount = std::min(stage.sampleCount + 1, static_cast<uint32_t>(stage.history.size()));
+    }
+}
+
+tpd::TimestampProfiler::Stats tpd::TimestampProfiler::getStats(const uint32_t stage) const {
+    const auto& [name, firstSlot, instanceCount, history, cursor, sampleCount] = _stages[stage];
+    if (sampleCount == 0) {
+        return { name };
+    }
+
+    // The history is not yet full until sampleCount reaches its size, in which case valid samples start at 0
+    auto samples = std::vector(history.begin(), history.begin() + sampleCount);
+    std::ranges::sort(samples);
+
+    const auto percentile = [&samples](const float p) {
+        return samples[static_cast<std::size_t>(p * static_cast<float>(samples.size() - 1) + 0.5f)];
+    };
+
+    return {
+        .name = name,
+        .average = std::accumulate(samples.begin(), samples.end(), 0.0f) / static_cast<float>(sampleCount),
+        .p50 = percentile(0.50f),
+        .p95 = percentile(0.95f),
+        .p99 = percentile(0.99f),
+        .sampleCount = sampleCount,
+    };
+}
+
+void tpd::TimestampProfiler::destroy(const vk::Device device) noexcept {
+    std::ranges::for_each(_queryPools, [device](const auto pool) { device.destroyQueryPool(pool); });
+    _queryPools.clear();
+    _recorded.clear();
+    _stages.clear();
+    _slotCount = 0;
+    _calibrated = false;
+}
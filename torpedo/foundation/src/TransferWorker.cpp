@@ -1,90 +1,10 @@
 #include "torpedo/foundation/TransferWorker.h"
+#include "torpedo/foundation/FrameTracer.h"
 #include "torpedo/foundation/StorageBuffer.h"
 #include "torpedo/foundation/Texture.h"
 
-tpd::DeletionWorker::DeletionWorker(const vk::Device device, VmaAllocator vmaAllocator)
-    : _device{ device }, _vmaAllocator{ vmaAllocator } {}
-
-void tpd::DeletionWorker::start() {
-    if (!_workerThread.joinable()) [[unlikely]] {
-        _workerThread = std::thread(&DeletionWorker::deletionWork, this);
-        _statusUpdateCallback("DeletionWorker - Launched 1 deletion thread");
-    }
-}
-
-void tpd::DeletionWorker::submit(
-    const vk::Fence fence,
-    const vk::Buffer buffer,
-    VmaAllocation allocation,
-    const vk::Semaphore semaphore,
-    std::vector<std::pair<vk::CommandPool, vk::CommandBuffer>>&& commandBuffers)
-{
-    {
-        std::lock_guard lock(_queueMutex);
-        auto resource = OpaqueResource{ buffer, allocation };
-        _statusUpdateCallback("DeletionWorker - Inserting a resource: " + resource.toString());
-        _tasks.emplace_back(fence, std::move(resource), semaphore, std::move(commandBuffers));
-    }
-    _queueCondition.notify_one();
-}
-
-void tpd::DeletionWorker::deletionWork() {
-    while (true) {
-        // Sleep until there a deletion task to work on, or we're shutting down
-        std::unique_lock lock(_queueMutex);
-        _queueCondition.wait(lock, [this] { return !_tasks.empty() || _stopWorker; });
-
-        if (_stopWorker && _tasks.empty()) break;
-
-        auto [fence, resource, semaphore, buffers] = std::move(_tasks.front());
-        _tasks.pop_front();
-        lock.unlock(); // shared-data has been read, we can unlock to let other threads add more tasks
-
-        // Wait until the GPU is done with the resource then destroy it
-        using limits = std::numeric_limits<uint64_t>;
-        // The fence has been submitted by the main thread prior to this point, so no sync needed
-        [[maybe_unused]] const auto result = _device.waitForFences(fence, vk::True, limits::max());
-        // VMA is thread-safe internally
-        const auto resName = resource.toString();
-        resource.destroy(_vmaAllocator);
-
-        // The destruction of semaphore and fence are thread-safe
-        _device.destroyFence(fence);
-        if (semaphore) _device.destroySemaphore(semaphore);
-
-        {
-            // VkCommandPool in vkFreeCommandBuffers must be synchronized externally
-            // The same is applied to buffers, but the main thread no longer uses them
-            std::lock_guard poolLock(_commandPoolMutex);
-            for (const auto [pool, buffer] : buffers) _device.freeCommandBuffers(pool, buffer);
-        }
-
-        _statusUpdateCallback("DeletionWorker - Destroyed a resource: " + resName);
-
-        // Notify the main thread who could potentially be waiting until all tasks are free
-        // If that's not the case, this signal can be lost without causing any issue
-        _queueCondition.notify_one();
-    }
-}
-
-void tpd::DeletionWorker::waitEmpty() {
-    if (_workerThread.joinable()) {
-        std::unique_lock lock(_queueMutex);
-        _queueCondition.wait(lock, [this] { return _tasks.empty(); });
-    }
-}
-
-void tpd::DeletionWorker::shutdown() noexcept {
-    if (_workerThread.joinable()) {
-        {
-            std::lock_guard lock(_queueMutex);
-            _stopWorker = true;
-        }
-        _queueCondition.notify_one();
-        _workerThread.join();
-        _statusUpdateCallback("DeletionWorker - Shut down 1 deletion thread");
-    }
-}
+#include <cstring>
+#include <limits>
 
 tpd::TransferWorker::TransferWorker(
     const uint32_t transferFamily,
@@ -92,20 +12,40 @@ tpd::TransferWorker::TransferWorker(
     const uint32_t computeFamily,
     const vk::PhysicalDevice physicalDevice,
     const vk::Device device,
-    VmaAllocator vmaAllocator)
+    VmaAllocator vmaAllocator,
+    const vk::DeviceSize stagingRingSize,
+    QueueArbiter* arbiter)
     : _physicalDevice{ physicalDevice }
-    , _deletionWorker{ device, vmaAllocator }
+    , _device{ device }
+    , _vmaAllocator{ vmaAllocator }
+    , _arbiter{ arbiter }
     , _transferFamily{ transferFamily }
     , _graphicsFamily{ graphicsFamily }
     , _computeFamily{ computeFamily }
+    , _stagingRingSize{ stagingRingSize }
 {
-    _transferQueue = device.getQueue(transferFamily, 0);
-    _graphicsQueue = device.getQueue(graphicsFamily, 0);
-    _computeQueue  = device.getQueue(computeFamily, 0);
+    // A queue family may serve more than one role, in which case its queue is shared, and so is its timeline
+    for (const auto family : { transferFamily, graphicsFamily, computeFamily }) {
+        if (std::ranges::contains(_timelines, family, &Timeline::family)) {
+            continue;
+        }
+        auto semaphoreTypeInfo = vk::SemaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, 0 };
+        auto semaphoreInfo = vk::SemaphoreCreateInfo{};
+        semaphoreInfo.pNext = &semaphoreTypeInfo;
+
+        _timelines.push_back({
+            family, device.getQueue(family, 0),
+            device.createCommandPool({ vk::CommandPoolCreateFlagBits::eTransient, family }),
+            device.createSemaphore(semaphoreInfo), 0, {} });
+    }
 
-    _releasePool = device.createCommandPool({ vk::CommandPoolCreateFlagBits::eTransient, transferFamily });
-    _computeAcquirePool  = device.createCommandPool({ vk::CommandPoolCreateFlagBits::eTransient, computeFamily  });
-    _graphicsAcquirePool = device.createCommandPool({ vk::CommandPoolCreateFlagBits::eTransient, graphicsFamily });
+    // Buffer transfers are staged through a single persistently mapped ring, instead of a staging buffer each
+    const auto ringInfo = vk::BufferCreateInfo{ {}, stagingRingSize, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive };
+    auto ringAllocation = VmaAllocation{};
+    auto ringAllocationInfo = VmaAllocationInfo{};
+    const auto ring = vma::allocateMappedBuffer(vmaAllocator, ringInfo, &ringAllocation, &ringAllocationInfo);
+    _stagingRing = OpaqueResource{ ring, ringAllocation };
+    _stagingData = static_cast<std::byte*>(ringAllocationInfo.pMappedData);
 }
 
 void tpd::TransferWorker::transfer(
@@ -115,45 +55,180 @@ void tpd::TransferWorker::transfer(
     const uint32_t dstFamily,
     const SyncPoint dstSync)
 {
+    if (_batching) {
+        enqueue(data, size, buffer, dstFamily, dstSync);
+        return;
+    }
+
+    beginBatch();
+    enqueue(data, size, buffer, dstFamily, dstSync);
+    flush();
+}
+
+void tpd::TransferWorker::beginBatch() {
+    if (_batching) [[unlikely]] {
+        throw std::runtime_error("TransferWorker - Cannot begin a batch before flushing the current one");
+    }
+    reclaim();
+    _batching = true;
+}
+
+void tpd::TransferWorker::enqueue(
+    const void* data,
+    const vk::DeviceSize size,
+    const StorageBuffer& buffer,
+    const uint32_t dstFamily,
+    const SyncPoint dstSync,
+    const vk::DeviceSize dstOffset)
+{
+    if (!_batching) [[unlikely]] {
+        throw std::runtime_error("TransferWorker - Cannot enqueue a transfer outside of a batch, call beginBatch first");
+    }
     if (size == 0) {
         return;
     }
+    TPD_TRACE_ZONE("TransferWorker::enqueue");
+
+    // Each buffer gets a single barrier once the batch is flushed, covering all transfers made to it
+    const auto pending = std::ranges::find(_pendingTransfers, static_cast<vk::Buffer>(buffer), &PendingTransfer::buffer);
+    if (pending == _pendingTransfers.end()) {
+        _pendingTransfers.push_back({ buffer, dstFamily, dstSync });
+    } else if (pending->dstFamily != dstFamily) [[unlikely]] {
+        throw std::invalid_argument("TransferWorker - A buffer can only be transferred to a single queue family per batch");
+    } else {
+        pending->dstSync.stage |= dstSync.stage;
+        pending->dstSync.access |= dstSync.access;
+    }
 
-    _deletionWorker.start();
-    // Ensure thread-safe access in case the deletion worker is deallocating with the command pool
-    // Actions required external synchronization: buffer allocation/deallocation/record/free
-    std::lock_guard lock(_deletionWorker._commandPoolMutex);
+    const auto bytes = static_cast<const std::byte*>(data);
+    for (vk::DeviceSize copied = 0; copied < size;) {
+        const auto chunk = reserveStaging(size - copied);
+        const auto offset = _ringHead % _stagingRingSize;
 
-    const auto [stagingBuffer, stagingAllocation] = vma::allocateStagingBuffer(_deletionWorker._vmaAllocator, size);
-    vma::copyStagingData(_deletionWorker._vmaAllocator, data, size, stagingAllocation);
+        // Host writes are made visible to the device by the queue submission, as long as they are flushed
+        std::memcpy(_stagingData + offset, bytes + copied, chunk);
+        vmaFlushAllocation(_vmaAllocator, _stagingRing.getAllocation(), offset, chunk);
 
-    const auto releaseCommand = beginTransfer(_transferFamily);
-    buffer.recordStagingCopy(releaseCommand, stagingBuffer, size);
+        if (!_batchCommand) {
+            _batchCommand = beginTransfer(_transferFamily);
+        }
+        _batchCommand.copyBuffer(_stagingRing, buffer, vk::BufferCopy{ offset, dstOffset + copied, chunk });
 
-    // Create a fence that will be signaled once all queued operations are completed.
-    // This allows the deletion worker thread to safely clean up resources after ensuring
-    // that no GPU operations are still using them.
-    const auto deletionFence = _deletionWorker._device.createFence(vk::FenceCreateInfo{});
+        _ringHead += chunk;
+        copied += chunk;
+    }
+}
 
-    if (_transferFamily != dstFamily) {
-        constexpr auto srcSync = SyncPoint{ vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite };
-        buffer.recordOwnershipRelease(releaseCommand, _transferFamily, dstFamily, srcSync);
+void tpd::TransferWorker::flush() {
+    if (!_batching) [[unlikely]] {
+        throw std::runtime_error("TransferWorker - Cannot flush without a batch, call beginBatch first");
+    }
+    _batching = false;
 
-        const auto ownershipSemaphoreInfo = createOwnershipSemaphoreInfo();
-        endRelease(releaseCommand, ownershipSemaphoreInfo);
+    if (_pendingTransfers.empty()) {
+        return;
+    }
+    TPD_TRACE_ZONE("TransferWorker::flush");
+
+    // All copies may have been submitted early while splitting, barriers still need a command buffer of their own
+    if (!_batchCommand) {
+        _batchCommand = beginTransfer(_transferFamily);
+    }
+
+    // Buffers going to another family are released, the others get a plain dependency on their copies. Either way,
+    // the barriers also cover copies submitted early, since those come before in submission order.
+    auto barriers = std::vector<vk::BufferMemoryBarrier2>{};
+    auto acquireFamilies = std::vector<uint32_t>{};
+    for (const auto& [buffer, dstFamily, dstSync] : _pendingTransfers) {
+        const auto release = dstFamily != _transferFamily;
+        auto barrier = vk::BufferMemoryBarrier2{};
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = vk::WholeSize;
+        barrier.srcQueueFamilyIndex = release ? _transferFamily : vk::QueueFamilyIgnored;
+        barrier.dstQueueFamilyIndex = release ? dstFamily : vk::QueueFamilyIgnored;
+        barrier.srcStageMask  = vk::PipelineStageFlagBits2::eTransfer;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.dstStageMask  = release ? vk::PipelineStageFlags2{} : dstSync.stage;
+        barrier.dstAccessMask = release ? vk::AccessFlags2{} : dstSync.access;
+        barriers.push_back(barrier);
+
+        if (release && !std::ranges::contains(acquireFamilies, dstFamily)) {
+            acquireFamilies.push_back(dstFamily);
+        }
+    }
+    _batchCommand.pipelineBarrier2(vk::DependencyInfo{}.setBufferMemoryBarriers(barriers));
+
+    // Acquiring families wait for the release's value on the transfer timeline, no semaphore of their own needed
+    const auto releaseValue = submit(_batchCommand, _transferFamily);
+    _stagingSegments.push_back({ releaseValue, _ringHead });
+    defer(_transferFamily, releaseValue, _batchCommand);
+    _batchCommand = nullptr;
+
+    for (const auto dstFamily : acquireFamilies) {
+        auto acquireBarriers = std::vector<vk::BufferMemoryBarrier2>{};
+        for (const auto& [buffer, family, dstSync] : _pendingTransfers) {
+            if (family != dstFamily) continue;
+            auto barrier = vk::BufferMemoryBarrier2{};
+            barrier.buffer = buffer;
+            barrier.offset = 0;
+            barrier.size = vk::WholeSize;
+            barrier.srcQueueFamilyIndex = _transferFamily;
+            barrier.dstQueueFamilyIndex = dstFamily;
+            barrier.dstStageMask  = dstSync.stage;
+            barrier.dstAccessMask = dstSync.access;
+            acquireBarriers.push_back(barrier);
+        }
 
         const auto acquireCommand = beginTransfer(dstFamily);
-        buffer.recordOwnershipAcquire(acquireCommand, _transferFamily, dstFamily, dstSync);
-        endAcquire(acquireCommand, ownershipSemaphoreInfo, dstFamily, deletionFence);
+        acquireCommand.pipelineBarrier2(vk::DependencyInfo{}.setBufferMemoryBarriers(acquireBarriers));
+        defer(dstFamily, submit(acquireCommand, dstFamily, releaseValue), acquireCommand);
+    }
 
-        _deletionWorker.submit(
-            deletionFence, stagingBuffer, stagingAllocation, ownershipSemaphoreInfo.semaphore,
-            { { getPool(dstFamily), acquireCommand }, { _releasePool, releaseCommand } });
-    } else {
-        // Ensure subsequent commands don't access the buffer during copy
-        buffer.recordTransferDstPoint(releaseCommand, dstSync);
-        endTransfer(releaseCommand, deletionFence);
-        _deletionWorker.submit(deletionFence, stagingBuffer, stagingAllocation, {}, {{ _releasePool, releaseCommand }});
+    _pendingTransfers.clear();
+}
+
+vk::DeviceSize tpd::TransferWorker::reserveStaging(const vk::DeviceSize size) {
+    // Free space may wrap around the end of the ring, only the part up to the end is contiguous
+    const auto contiguous = [this] {
+        return std::min(_stagingRingSize - (_ringHead - _ringTail), _stagingRingSize - _ringHead % _stagingRingSize);
+    };
+
+    retireSegments(false);
+    while (contiguous() == 0) {
+        // The ring is full, copies of the current batch are part of it and must be submitted to ever complete
+        if (_batchCommand) {
+            submitCopies();
+        }
+        retireSegments(true);
+    }
+    return std::min(size, contiguous());
+}
+
+void tpd::TransferWorker::submitCopies() {
+    const auto value = submit(_batchCommand, _transferFamily);
+    _stagingSegments.push_back({ value, _ringHead });
+    defer(_transferFamily, value, _batchCommand);
+    _batchCommand = nullptr;
+}
+
+void tpd::TransferWorker::retireSegments(const bool waitOldest) {
+    if (_stagingSegments.empty()) {
+        return;
+    }
+
+    const auto& transfer = getTimeline(_transferFamily);
+    if (waitOldest) {
+        using limits = std::numeric_limits<uint64_t>;
+        TPD_TRACE_ZONE("TransferWorker::waitStaging");
+        const auto waitInfo = vk::SemaphoreWaitInfo{ {}, 1, &transfer.semaphore, &_stagingSegments.front().value };
+        [[maybe_unused]] const auto result = _device.waitSemaphores(waitInfo, limits::max());
+    }
+
+    const auto completed = _device.getSemaphoreCounterValue(transfer.semaphore);
+    while (!_stagingSegments.empty() && _stagingSegments.front().value <= completed) {
+        _ringTail = _stagingSegments.front().ringEnd;
+        _stagingSegments.pop_front();
     }
 }
 
@@ -169,31 +244,26 @@ void tpd::TransferWorker::transfer(
     if (size == 0) {
         return;
     }
+    TPD_TRACE_ZONE("TransferWorker::transfer");
 
-    _deletionWorker.start();
-    // Ensure thread-safe access in case the deletion worker is deallocating with the command pool
-    // Actions required external synchronization: buffer allocation/deallocation/record/free
-    std::lock_guard lock(_deletionWorker._commandPoolMutex);
+    reclaim();
 
-    const auto [stagingBuffer, stagingAllocation] = vma::allocateStagingBuffer(_deletionWorker._vmaAllocator, size);
-    vma::copyStagingData(_deletionWorker._vmaAllocator, data, size, stagingAllocation);
+    const auto [stagingBuffer, stagingAllocation] = vma::allocateStagingBuffer(_vmaAllocator, size);
+    vma::copyStagingData(_vmaAllocator, data, size, stagingAllocation);
+    auto staging = OpaqueResource{ stagingBuffer, stagingAllocation };
 
     const auto releaseCommand = beginTransfer(_transferFamily);
     texture.recordLayoutTransition(releaseCommand, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevel, 1);
     texture.recordStagingCopy(releaseCommand, stagingBuffer, extent, mipLevel);
 
-    // Create a fence that will be signaled once all queued operations are completed.
-    // This allows the deletion worker thread to safely clean up resources after ensuring
-    // that no GPU operations are still using them.
-    const auto deletionFence = _deletionWorker._device.createFence(vk::FenceCreateInfo{});
-
     if (_transferFamily != dstFamily) {
         constexpr auto srcSync = SyncPoint{ vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite };
         texture.recordOwnershipRelease(
             releaseCommand, _transferFamily, dstFamily, srcSync, vk::ImageLayout::eTransferDstOptimal, dstLayout, mipLevel, 1);
 
-        const auto ownershipSemaphoreInfo = createOwnershipSemaphoreInfo();
-        endRelease(releaseCommand, ownershipSemaphoreInfo);
+        // The staging buffer is done with once the copy completes, regardless of the acquire
+        const auto releaseValue = submit(releaseCommand, _transferFamily);
+        defer(_transferFamily, releaseValue, releaseCommand, std::move(staging));
 
         const auto acquireCommand = beginTransfer(dstFamily);
 
@@ -201,15 +271,11 @@ void tpd::TransferWorker::transfer(
         texture.recordOwnershipAcquire(
             acquireCommand, _transferFamily, dstFamily, dstSync, vk::ImageLayout::eTransferDstOptimal, dstLayout, mipLevel, 1);
 
-        endAcquire(acquireCommand, ownershipSemaphoreInfo, dstFamily, deletionFence);
-        _deletionWorker.submit(
-            deletionFence, stagingBuffer, stagingAllocation, ownershipSemaphoreInfo.semaphore,
-            { { getPool(dstFamily), acquireCommand }, { _releasePool, releaseCommand } });
+        defer(dstFamily, submit(acquireCommand, dstFamily, releaseValue), acquireCommand);
 
     } else {
         texture.recordLayoutTransition(releaseCommand, vk::ImageLayout::eTransferDstOptimal, dstLayout, mipLevel, 1);
-        endTransfer(releaseCommand, deletionFence);
-        _deletionWorker.submit(deletionFence, stagingBuffer, stagingAllocation, {}, {{ _releasePool, releaseCommand }});
+        defer(_transferFamily, submit(releaseCommand, _transferFamily), releaseCommand, std::move(staging));
     }
 }
 
@@ -225,14 +291,13 @@ void tpd::TransferWorker::transfer(
     if (size == 0) {
         return;
     }
+    TPD_TRACE_ZONE("TransferWorker::transfer");
 
-    _deletionWorker.start();
-    // Ensure thread-safe access in case the deletion worker is deallocating with the command pool
-    // Actions required external synchronization: buffer allocation/deallocation/record/free
-    std::lock_guard lock(_deletionWorker._commandPoolMutex);
+    reclaim();
 
-    const auto [stagingBuffer, stagingAllocation] = vma::allocateStagingBuffer(_deletionWorker._vmaAllocator, size);
-    vma::copyStagingData(_deletionWorker._vmaAllocator, data, size, stagingAllocation);
+    const auto [stagingBuffer, stagingAllocation] = vma::allocateStagingBuffer(_vmaAllocator, size);
+    vma::copyStagingData(_vmaAllocator, data, size, stagingAllocation);
+    auto staging = OpaqueResource{ stagingBuffer, stagingAllocation };
 
     const auto releaseCommand = beginTransfer(_transferFamily);
     // Transition all mip levels to transfer dst, not just the base mip
@@ -240,38 +305,30 @@ void tpd::TransferWorker::transfer(
     // Copy data to the base mip
     texture.recordStagingCopy(releaseCommand, stagingBuffer, extent);
 
-    // Create a fence that will be signaled once all queued operations are completed.
-    // This allows the deletion worker thread to safely clean up resources after ensuring
-    // that no GPU operations are still using them.
-    const auto deletionFence = _deletionWorker._device.createFence(vk::FenceCreateInfo{});
-
     if (_transferFamily != dstFamily) {
         texture.recordReleaseForMipGen(releaseCommand, _transferFamily, _graphicsFamily);
 
-        const auto ownershipSemaphoreInfo = createOwnershipSemaphoreInfo();
-        endRelease(releaseCommand, ownershipSemaphoreInfo);
+        // The staging buffer is done with once the copy completes, regardless of the acquire
+        const auto releaseValue = submit(releaseCommand, _transferFamily);
+        defer(_transferFamily, releaseValue, releaseCommand, std::move(staging));
 
         const auto acquireCommand = beginTransfer(dstFamily);
         texture.recordAcquireForMipGen(acquireCommand, _transferFamily, _graphicsFamily);
         texture.recordMipGen(acquireCommand, _physicalDevice, { extent.width, extent.height }, mipCount, dstLayout);
 
-        endAcquire(acquireCommand, ownershipSemaphoreInfo, dstFamily, deletionFence);
-        _deletionWorker.submit(
-            deletionFence, stagingBuffer, stagingAllocation, ownershipSemaphoreInfo.semaphore,
-            { { getPool(dstFamily), acquireCommand }, { _releasePool, releaseCommand } });
+        defer(dstFamily, submit(acquireCommand, dstFamily, releaseValue), acquireCommand);
     } else {
         texture.recordMipGen(releaseCommand, _physicalDevice, { extent.width, extent.height }, mipCount, dstLayout);
-        endTransfer(releaseCommand, deletionFence);
-        _deletionWorker.submit(deletionFence, stagingBuffer, stagingAllocation, {}, {{ _releasePool, releaseCommand }});
+        defer(_transferFamily, submit(releaseCommand, _transferFamily), releaseCommand, std::move(staging));
     }
 }
 
-vk::CommandBuffer tpd::TransferWorker::beginTransfer(const uint32_t queueFamily) const {
+vk::CommandBuffer tpd::TransferWorker::beginTransfer(const uint32_t queueFamily) {
     const auto allocInfo = vk::CommandBufferAllocateInfo{}
-        .setCommandPool(getPool(queueFamily))
+        .setCommandPool(getTimeline(queueFamily).pool)
         .setLevel(vk::CommandBufferLevel::ePrimary)
         .setCommandBufferCount(1);
-    const auto buffer = _deletionWorker._device.allocateCommandBuffers(allocInfo)[0];
+    const auto buffer = _device.allocateCommandBuffers(allocInfo)[0];
 
     constexpr auto beginInfo = vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
     buffer.begin(beginInfo);
@@ -279,64 +336,94 @@ vk::CommandBuffer tpd::TransferWorker::beginTransfer(const uint32_t queueFamily)
     return buffer;
 }
 
-void tpd::TransferWorker::endTransfer(const vk::CommandBuffer buffer, const vk::Fence deletionFence) const {
+uint64_t tpd::TransferWorker::submit(const vk::CommandBuffer buffer, const uint32_t queueFamily, const uint64_t transferValue) {
     buffer.end();
-    _transferQueue.submit(vk::SubmitInfo{ {}, {}, {}, 1, &buffer }, deletionFence);
-}
-
-vk::SemaphoreSubmitInfo tpd::TransferWorker::createOwnershipSemaphoreInfo() const {
-    const auto ownershipTransferSemaphore = _deletionWorker._device.createSemaphore({});
-    auto semaphoreInfo = vk::SemaphoreSubmitInfo{};
-    semaphoreInfo.semaphore = ownershipTransferSemaphore;
-    // The only valid wait stage for ownership transfer is all-command
-    semaphoreInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
-    semaphoreInfo.deviceIndex = 0;
-    semaphoreInfo.value = 1;
-    return semaphoreInfo;
-}
 
-void tpd::TransferWorker::endRelease(const vk::CommandBuffer buffer, const vk::SemaphoreSubmitInfo& semaphoreInfo) const {
-    buffer.end();
+    auto& timeline = getTimeline(queueFamily);
+    const auto commandInfo = vk::CommandBufferSubmitInfo{ buffer, 0b1 }; // device mask is ignored by single-GPU setups
+    const auto signalInfo = vk::SemaphoreSubmitInfo{ timeline.semaphore, ++timeline.value, vk::PipelineStageFlagBits2::eAllCommands, 0 };
 
-    auto releaseInfo = vk::CommandBufferSubmitInfo{};
-    releaseInfo.commandBuffer = buffer;
-    releaseInfo.deviceMask = 0b1;  // ignored by single-GPU setups
+    // The only valid wait stage for ownership transfer is all-command
+    const auto waitInfo = vk::SemaphoreSubmitInfo{
+        getTimeline(_transferFamily).semaphore, transferValue, vk::PipelineStageFlagBits2::eAllCommands, 0 };
 
-    const auto releaseSubmitInfo = vk::SubmitInfo2{}
-        .setCommandBufferInfos(releaseInfo)
-        .setSignalSemaphoreInfos(semaphoreInfo);
-    _transferQueue.submit2(releaseSubmitInfo);
+    auto submitInfo = vk::SubmitInfo2{}.setCommandBufferInfos(commandInfo).setSignalSemaphoreInfos(signalInfo);
+    if (transferValue > 0) {
+        submitInfo.setWaitSemaphoreInfos(waitInfo);
+    }
+    if (_arbiter) {
+        _arbiter->submit(timeline.queue, submitInfo);
+    } else {
+        timeline.queue.submit2(submitInfo);
+    }
+    return timeline.value;
 }
 
-void tpd::TransferWorker::endAcquire(
+void tpd::TransferWorker::defer(
+    const uint32_t queueFamily,
+    const uint64_t value,
     const vk::CommandBuffer buffer,
-    const vk::SemaphoreSubmitInfo& semaphoreInfo,
-    const uint32_t dstFamily,
-    const vk::Fence deletionFence) const
+    OpaqueResource<vk::Buffer>&& staging)
 {
-    buffer.end();
+    if (_statusUpdateCallback && staging.valid()) [[unlikely]] {
+        _statusUpdateCallback("TransferWorker - Deferring a resource: " + staging.toString());
+    }
+    getTimeline(queueFamily).deletions.push_back({ value, buffer, std::move(staging) });
+}
 
-    auto acquireInfo = vk::CommandBufferSubmitInfo{};
-    acquireInfo.commandBuffer = buffer;
-    acquireInfo.deviceMask = 0b1; // ignored by single-GPU setups
+void tpd::TransferWorker::reclaim() {
+    TPD_TRACE_ZONE("TransferWorker::reclaim");
+    for (auto& timeline : _timelines) {
+        auto& deletions = timeline.deletions;
+        if (deletions.empty()) {
+            continue;
+        }
+
+        // Deletions are deferred in submission order, so they complete in the same order
+        const auto completed = _device.getSemaphoreCounterValue(timeline.semaphore);
+        while (!deletions.empty() && deletions.front().value <= completed) {
+            auto& deletion = deletions.front();
+            _device.freeCommandBuffers(timeline.pool, deletion.command);
+
+            if (deletion.staging.valid()) {
+                const auto resName = _statusUpdateCallback ? deletion.staging.toString() : std::string{};
+                deletion.staging.destroy(_vmaAllocator);
+                if (_statusUpdateCallback) [[unlikely]] {
+                    _statusUpdateCallback("TransferWorker - Destroyed a resource: " + resName);
+                }
+            }
+            deletions.pop_front();
+        }
+    }
+    retireSegments(false);
+}
 
-    const auto acquireSubmitInfo = vk::SubmitInfo2{}
-        .setCommandBufferInfos(acquireInfo)
-        .setWaitSemaphoreInfos(semaphoreInfo);
+void tpd::TransferWorker::waitIdle() {
+    auto semaphores = std::vector<vk::Semaphore>{};
+    auto values = std::vector<uint64_t>{};
+    for (const auto& timeline : _timelines) {
+        semaphores.push_back(timeline.semaphore);
+        values.push_back(timeline.value);
+    }
 
-    if (dstFamily == _graphicsFamily) {
-        _graphicsQueue.submit2(acquireSubmitInfo, deletionFence);
-    } else if (dstFamily == _computeFamily) {
-        _computeQueue.submit2(acquireSubmitInfo, deletionFence);
-    } else [[unlikely]] {
-        throw std::invalid_argument("TransferWorker - Acquire queue family must be either compute or graphics");
+    if (!semaphores.empty()) {
+        using limits = std::numeric_limits<uint64_t>;
+        TPD_TRACE_ZONE("TransferWorker::waitIdle");
+        const auto waitInfo = vk::SemaphoreWaitInfo{}.setSemaphores(semaphores).setValues(values);
+        [[maybe_unused]] const auto result = _device.waitSemaphores(waitInfo, limits::max());
     }
+    reclaim();
 }
 
 void tpd::TransferWorker::destroy() noexcept {
     waitIdle();
 
-    _deletionWorker._device.destroyCommandPool(_graphicsAcquirePool);
-    _deletionWorker._device.destroyCommandPool(_computeAcquirePool);
-    _deletionWorker._device.destroyCommandPool(_releasePool);
+    _stagingRing.destroy(_vmaAllocator);
+    _stagingData = nullptr;
+
+    for (const auto& timeline : _timelines) {
+        _device.destroySemaphore(timeline.semaphore);
+        _device.destroyCommandPool(timeline.pool);
+    }
+    _timelines.clear();
 }
@@ -45,18 +45,28 @@ void tpd::vma::deallocateImage(VmaAllocator allocator, const vk::Image image, Vm
     vmaDestroyImage(allocator, image, allocation);
 }
 
-vk::Buffer tpd::vma::allocateDeviceBuffer(VmaAllocator allocator, const vk::BufferCreateInfo& info, VmaAllocation* allocation) {
+vk::Buffer tpd::vma::allocateDeviceBuffer(
+    VmaAllocator allocator,
+    const vk::BufferCreateInfo& info,
+    VmaAllocation* allocation,
+    const AllocationStrategy strategy)
+{
     const auto bufferInfo = static_cast<VkBufferCreateInfo>(info);
 
-    constexpr auto allocInfo = VmaAllocationCreateInfo{
-        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+    const auto dedicated = strategy == AllocationStrategy::Dedicated ||
+        (strategy == AllocationStrategy::Auto && info.size >= DEDICATED_THRESHOLD);
+
+    const auto allocInfo = VmaAllocationCreateInfo{
+        .flags = dedicated ? VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT : VmaAllocationCreateFlags{ 0 },
         .usage = VMA_MEMORY_USAGE_AUTO,
         .priority = 1.0f,
     };
 
     auto buffer = VkBuffer{};
     if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer, allocation, nullptr) != VK_SUCCESS) {
-        throw std::runtime_error("VMA - Failed to allocate a dedicated device buffer");
+        throw std::runtime_error(dedicated
+            ? "VMA - Failed to allocate a dedicated device buffer"
+            : "VMA - Failed to sub-allocate a device buffer");
     }
     return buffer;
 }
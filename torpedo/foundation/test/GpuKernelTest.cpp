@@ -0,0 +1,472 @@
+#include <torpedo/bootstrap/DeviceBuilder.h>
+#include <torpedo/bootstrap/InstanceBuilder.h>
+#include <torpedo/bootstrap/PhysicalDeviceSelector.h>
+
+#include <torpedo/foundation/GpuPrefixScan.h>
+#include <torpedo/foundation/GpuRadixSort.h>
+#include <torpedo/foundation/RingBuffer.h>
+#include <torpedo/foundation/StorageBuffer.h>
+#include <torpedo/foundation/TwoWayBuffer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Checks GpuRadixSort against std::stable_sort and GpuPrefixScan against std::exclusive_scan on random inputs, with
+// both kernel sets if the device supports subgroup kernels. Every case is run on its own submission and read back.
+
+namespace {
+    constexpr int SKIP_CODE = 77; // must match SKIP_RETURN_CODE in CMakeLists.txt
+
+    // Makes all earlier device writes visible to all later device accesses
+    constexpr auto FULL_BARRIER = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryWrite,
+        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite };
+
+    // The least a device needs for the kernels: 64-bit keys, device addresses, and 64-bit atomics on block descriptors
+    vk::PhysicalDeviceFeatures getFeatures() {
+        auto features = vk::PhysicalDeviceFeatures{};
+        features.shaderInt64 = true;
+        return features;
+    }
+
+    vk::PhysicalDeviceVulkan12Features getVulkan12Features() {
+        auto features = vk::PhysicalDeviceVulkan12Features{};
+        features.shaderBufferInt64Atomics = true;
+        features.bufferDeviceAddress = true;
+        return features;
+    }
+
+    vk::PhysicalDeviceVulkan13Features getVulkan13Features() {
+        auto features = vk::PhysicalDeviceVulkan13Features{};
+        features.synchronization2 = true;
+        return features;
+    }
+
+    // A compute queue of the most capable device, submissions are waited for one at a time
+    class TestDevice {
+    public:
+        TestDevice();
+        ~TestDevice() noexcept;
+
+        TestDevice(const TestDevice&) = delete;
+        TestDevice& operator=(const TestDevice&) = delete;
+
+        void execute(const std::function<void(vk::CommandBuffer)>& record) const;
+
+        [[nodiscard]] tpd::StorageBuffer createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage = {}) const;
+        [[nodiscard]] tpd::StorageBuffer upload(const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage = {}) const;
+        void download(vk::Buffer buffer, void* data, vk::DeviceSize size) const;
+        void destroy(tpd::StorageBuffer& buffer) const noexcept;
+
+        template<typename T>
+        [[nodiscard]] tpd::StorageBuffer upload(const std::vector<T>& data, vk::BufferUsageFlags usage = {}) const;
+
+        template<typename T>
+        [[nodiscard]] std::vector<T> download(vk::Buffer buffer, std::size_t count) const;
+
+        [[nodiscard]] vk::Device getDevice() const noexcept { return _device; }
+        [[nodiscard]] std::string getDeviceName() const { return _physicalDevice.getProperties().deviceName.data(); }
+        [[nodiscard]] bool subgroupKernels() const noexcept { return _subgroupKernels; }
+
+    private:
+        void release() noexcept;
+
+        vk::Instance _instance{};
+        vk::PhysicalDevice _physicalDevice{};
+        vk::Device _device{};
+        VmaAllocator _allocator{};
+
+        vk::Queue _queue{};
+        vk::CommandPool _commandPool{};
+        vk::CommandBuffer _commandBuffer{};
+        vk::Fence _fence{};
+
+        bool _subgroupKernels{ false };
+    };
+
+    TestDevice::TestDevice() {
+        auto instanceFlags = vk::InstanceCreateFlags{};
+        auto instanceExtensions = std::vector<const char*>{};
+#ifdef __APPLE__
+        instanceExtensions.push_back(vk::KHRPortabilityEnumerationExtensionName);
+        instanceFlags |= vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR;
+#endif
+        _instance = tpd::InstanceBuilder()
+            .apiVersion(1, 3, 0)
+            .extensions(std::move(instanceExtensions))
+            .build(instanceFlags);
+
+        try {
+            const auto selection = tpd::PhysicalDeviceSelector()
+                .features(getFeatures())
+                .featuresVulkan12(getVulkan12Features())
+                .featuresVulkan13(getVulkan13Features())
+                .select(_instance);
+            _physicalDevice = selection.physicalDevice;
+
+            // Subgroup kernels are only tested where they would be enabled by the engines
+            auto supportedVulkan13 = vk::PhysicalDeviceVulkan13Features{};
+            auto supported = vk::PhysicalDeviceFeatures2{};
+            supported.pNext = &supportedVulkan13;
+            _physicalDevice.getFeatures2(&supported);
+            _subgroupKernels = supportedVulkan13.computeFullSubgroups && tpd::GpuRadixSort::subgroupSupported(_physicalDevice);
+
+            auto deviceFeatures = vk::PhysicalDeviceFeatures2{};
+            deviceFeatures.features = getFeatures();
+            auto featuresVulkan12 = getVulkan12Features();
+            deviceFeatures.pNext = &featuresVulkan12;
+            auto featuresVulkan13 = getVulkan13Features();
+            featuresVulkan13.computeFullSubgroups = _subgroupKernels;
+            featuresVulkan12.pNext = &featuresVulkan13;
+
+            _device = tpd::DeviceBuilder()
+                .deviceFeatures(&deviceFeatures)
+                .queueFamilyIndices({ selection.computeQueueFamilyIndex })
+                .build(_physicalDevice);
+
+            _allocator = tpd::vma::Builder()
+                .flags(VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT)
+                .vulkanApiVersion(VK_API_VERSION_1_3)
+                .build(_instance, _physicalDevice, _device);
+
+            _queue = _device.getQueue(selection.computeQueueFamilyIndex, 0);
+            _commandPool = _device.createCommandPool(vk::CommandPoolCreateInfo{}
+                .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+                .setQueueFamilyIndex(selection.computeQueueFamilyIndex));
+            _commandBuffer = _device.allocateCommandBuffers(vk::CommandBufferAllocateInfo{}
+                .setCommandPool(_commandPool)
+                .setLevel(vk::CommandBufferLevel::ePrimary)
+                .setCommandBufferCount(1))[0];
+            _fence = _device.createFence(vk::FenceCreateInfo{});
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    TestDevice::~TestDevice() noexcept {
+        release();
+    }
+
+    void TestDevice::release() noexcept {
+        if (_device) {
+            _device.destroyFence(_fence);
+            _device.destroyCommandPool(_commandPool);
+            if (_allocator) tpd::vma::destroy(_allocator);
+            _device.destroy();
+        }
+        _fence = nullptr;
+        _commandPool = nullptr;
+        _allocator = nullptr;
+        _device = nullptr;
+
+        if (_instance) _instance.destroy();
+        _instance = nullptr;
+    }
+
+    void TestDevice::execute(const std::function<void(vk::CommandBuffer)>& record) const {
+        _commandBuffer.reset();
+        _commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+        // Waiting for the fence on the host does not make what the previous submission wrote visible to this one
+        _commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(FULL_BARRIER));
+        record(_commandBuffer);
+        _commandBuffer.end();
+
+        const auto cmdInfo = vk::CommandBufferSubmitInfo{ _commandBuffer };
+        _queue.submit2(vk::SubmitInfo2{}.setCommandBufferInfos(cmdInfo), _fence);
+
+        // Software implementations take a while on the larger cases, never time out
+        using limits = std::numeric_limits<uint64_t>;
+        [[maybe_unused]] const auto result = _device.waitForFences(_fence, vk::True, limits::max());
+        _device.resetFences(_fence);
+    }
+
+    tpd::StorageBuffer TestDevice::createBuffer(const vk::DeviceSize size, const vk::BufferUsageFlags usage) const {
+        using enum vk::BufferUsageFlagBits;
+        return tpd::StorageBuffer::Builder()
+            .usage(usage | eShaderDeviceAddress | eTransferSrc | eTransferDst)
+            .alloc(size)
+            .build(_allocator);
+    }
+
+    tpd::StorageBuffer TestDevice::upload(const void* data, const vk::DeviceSize size, const vk::BufferUsageFlags usage) const {
+        auto buffer = createBuffer(size, usage);
+        auto staging = tpd::RingBuffer::Builder()
+            .count(1)
+            .usage(vk::BufferUsageFlagBits::eTransferSrc)
+            .alloc(size)
+            .build(_allocator);
+
+        staging.update(data, size);
+        vmaFlushAllocation(_allocator, staging.getAllocation(), 0, vk::WholeSize);
+        execute([&](const vk::CommandBuffer cmd) { buffer.recordStagingCopy(cmd, staging, size); });
+
+        staging.destroy(_allocator);
+        return buffer;
+    }
+
+    void TestDevice::download(const vk::Buffer buffer, void* data, const vk::DeviceSize size) const {
+        auto readback = tpd::TwoWayBuffer::Builder()
+            .usage(vk::BufferUsageFlagBits::eTransferDst)
+            .alloc(size)
+            .build(_allocator);
+
+        execute([&](const vk::CommandBuffer cmd) {
+            cmd.copyBuffer(buffer, readback, vk::BufferCopy{ 0, 0, size });
+            const auto barrier = vk::MemoryBarrier2{
+                vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+                vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead };
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(barrier));
+        });
+
+        vmaInvalidateAllocation(_allocator, readback.getAllocation(), 0, vk::WholeSize);
+        std::memcpy(data, readback.data<std::byte>(), size);
+        readback.destroy(_allocator);
+    }
+
+    void TestDevice::destroy(tpd::StorageBuffer& buffer) const noexcept {
+        buffer.destroy(_allocator);
+    }
+
+    template<typename T>
+    tpd::StorageBuffer TestDevice::upload(const std::vector<T>& data, const vk::BufferUsageFlags usage) const {
+        return upload(data.data(), sizeof(T) * data.size(), usage);
+    }
+
+    template<typename T>
+    std::vector<T> TestDevice::download(const vk::Buffer buffer, const std::size_t count) const {
+        auto data = std::vector<T>(count);
+        download(buffer, data.data(), sizeof(T) * count);
+        return data;
+    }
+
+    struct SortCase {
+        uint32_t count;
+        uint32_t beginBit;
+        uint32_t endBit;
+        bool values;
+        bool indirect; // recorded pass by pass with recordPassIndirect
+    };
+
+    std::ostream& operator<<(std::ostream& out, const SortCase& sortCase) {
+        return out << "count " << sortCase.count << ", bits [" << sortCase.beginBit << ", " << sortCase.endBit << ")"
+            << (sortCase.values ? ", values" : "") << (sortCase.indirect ? ", indirect" : "");
+    }
+
+    // Keys that tie on the sorted bits must keep their input order, which partial bit ranges expose as the ignored
+    // bits of tying keys still tell them apart
+    template<typename Key>
+    bool checkSort(const TestDevice& gpu, const tpd::GpuRadixSort& sort, std::mt19937_64& rng, const SortCase& sortCase) {
+        const auto [count, beginBit, endBit, withValues, indirect] = sortCase;
+
+        auto keys = std::vector<Key>(count);
+        std::ranges::generate(keys, [&rng] { return static_cast<Key>(rng()); });
+        auto values = std::vector<uint32_t>(count);
+        std::iota(values.begin(), values.end(), 0u);
+
+        const auto width = endBit - beginBit;
+        const auto mask = width >= 8 * sizeof(Key) ? ~Key{ 0 } : (Key{ 1 } << width) - 1;
+        const auto radix = [&](const uint32_t i) { return (keys[i] >> beginBit) & mask; };
+
+        auto expected = values;
+        std::ranges::stable_sort(expected, {}, radix);
+
+        auto keyBuffer = gpu.upload(keys);
+        auto valueBuffer = withValues ? gpu.upload(values) : tpd::StorageBuffer{};
+        auto scratch = gpu.createBuffer(sort.getScratchSize(count));
+        const auto input = tpd::GpuRadixSort::Input{ keyBuffer, valueBuffer, scratch, count, beginBit, endBit };
+
+        if (indirect) {
+            const auto dispatch = std::vector{ tpd::GpuRadixSort::getDispatch(count) };
+            auto dispatchBuffer = gpu.upload(dispatch, vk::BufferUsageFlagBits::eIndirectBuffer);
+            gpu.execute([&](const vk::CommandBuffer cmd) {
+                for (uint32_t pass = 0; pass < tpd::GpuRadixSort::getPassCount(beginBit, endBit); ++pass) {
+                    if (pass > 0) cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(FULL_BARRIER));
+                    sort.recordPassIndirect(cmd, input, pass, dispatchBuffer);
+                }
+            });
+            gpu.destroy(dispatchBuffer);
+        } else {
+            gpu.execute([&](const vk::CommandBuffer cmd) { sort.record(cmd, input, count); });
+        }
+
+        const auto sortedKeys = gpu.download<Key>(keyBuffer, count);
+        const auto sortedValues = withValues ? gpu.download<uint32_t>(valueBuffer, count) : std::vector<uint32_t>{};
+
+        gpu.destroy(keyBuffer);
+        gpu.destroy(valueBuffer);
+        gpu.destroy(scratch);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (sortedKeys[i] != keys[expected[i]]) {
+                std::cerr << "  key " << i << " is " << sortedKeys[i] << ", expected " << keys[expected[i]] << '\n';
+                return false;
+            }
+            if (withValues && sortedValues[i] != expected[i]) {
+                std::cerr << "  value " << i << " is " << sortedValues[i] << ", expected " << expected[i] << '\n';
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct ScanCase {
+        uint32_t count;
+        uint32_t stride;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const ScanCase& scanCase) {
+        return out << "count " << scanCase.count << ", stride " << scanCase.stride;
+    }
+
+    // Words between strided items must be left untouched, the total is checked along with the scanned items
+    bool checkScan(const TestDevice& gpu, const tpd::GpuPrefixScan& scan, std::mt19937_64& rng, const ScanCase& scanCase) {
+        const auto [count, stride] = scanCase;
+
+        // Items and their sum must fit in 30 bits
+        auto data = std::vector<uint32_t>(static_cast<std::size_t>(count) * stride);
+        std::ranges::generate(data, [&rng] { return static_cast<uint32_t>(rng() % 64); });
+
+        auto items = std::vector<uint32_t>(count);
+        for (uint32_t i = 0; i < count; ++i) items[i] = data[i * stride];
+        auto expected = data;
+        auto scanned = std::vector<uint32_t>(count);
+        std::exclusive_scan(items.begin(), items.end(), scanned.begin(), 0u);
+        for (uint32_t i = 0; i < count; ++i) expected[i * stride] = scanned[i];
+        const auto expectedTotal = std::reduce(items.begin(), items.end(), 0u);
+
+        auto dataBuffer = gpu.upload(data);
+        auto scratch = gpu.createBuffer(tpd::GpuPrefixScan::getScratchSize(count));
+        auto total = gpu.createBuffer(sizeof(uint32_t));
+
+        const auto input = tpd::GpuPrefixScan::Input{ dataBuffer, 0, count, stride, scratch, total, 0 };
+        gpu.execute([&](const vk::CommandBuffer cmd) { scan.record(cmd, input); });
+
+        const auto result = gpu.download<uint32_t>(dataBuffer, data.size());
+        const auto resultTotal = gpu.download<uint32_t>(total, 1)[0];
+
+        gpu.destroy(dataBuffer);
+        gpu.destroy(scratch);
+        gpu.destroy(total);
+
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            if (result[i] != expected[i]) {
+                std::cerr << "  word " << i << " is " << result[i] << ", expected " << expected[i] << '\n';
+                return false;
+            }
+        }
+        if (resultTotal != expectedTotal) {
+            std::cerr << "  total is " << resultTotal << ", expected " << expectedTotal << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    // Counts around block and partition boundaries, and enough keys for the look-back to span many blocks
+    constexpr uint32_t COUNTS[] = { 1, 255, 256, 257, 4099, 65536, 300001 };
+
+    // Ranges starting at 0, ranges with an odd width ending on a 1-bit pass, and ranges with a nonzero beginBit
+    constexpr std::pair<uint32_t, uint32_t> BIT_RANGES_32[] = { { 0, 32 }, { 0, 17 }, { 5, 21 }, { 30, 32 } };
+    constexpr std::pair<uint32_t, uint32_t> BIT_RANGES_64[] = { { 0, 64 }, { 0, 33 }, { 13, 40 }, { 32, 64 } };
+
+    uint32_t runSortCases(const TestDevice& gpu, const bool subgroupKernels, std::mt19937_64& rng) {
+        auto failedCount = 0u;
+
+        for (const auto keyType : { tpd::GpuRadixSort::KeyType::Uint32, tpd::GpuRadixSort::KeyType::Uint64 }) {
+            auto sort = tpd::GpuRadixSort::Builder()
+                .keyType(keyType)
+                .subgroupKernels(subgroupKernels)
+                .build(gpu.getDevice());
+
+            const auto is32 = keyType == tpd::GpuRadixSort::KeyType::Uint32;
+            const auto bitRanges = is32 ? std::span{ BIT_RANGES_32 } : std::span{ BIT_RANGES_64 };
+            for (const auto [beginBit, endBit] : bitRanges) {
+                for (const auto count : COUNTS) {
+                    for (const auto values : { false, true }) {
+                        // Indirect dispatches only once per range, they share everything else with direct ones
+                        const auto sortCase = SortCase{ count, beginBit, endBit, values, values && count == COUNTS[4] };
+                        const auto passed = is32
+                            ? checkSort<uint32_t>(gpu, sort, rng, sortCase)
+                            : checkSort<uint64_t>(gpu, sort, rng, sortCase);
+
+                        std::cout << (passed ? "[PASS] " : "[FAIL] ") << "radix-sort " << (is32 ? "uint32" : "uint64")
+                            << (subgroupKernels ? " subgroup: " : ": ") << sortCase << '\n';
+                        failedCount += passed ? 0 : 1;
+                    }
+                }
+            }
+
+            sort.destroy();
+        }
+
+        return failedCount;
+    }
+
+    uint32_t runScanCases(const TestDevice& gpu, const bool subgroupKernels, std::mt19937_64& rng) {
+        auto failedCount = 0u;
+
+        auto scan = tpd::GpuPrefixScan::Builder()
+            .subgroupKernels(subgroupKernels)
+            .build(gpu.getDevice());
+
+        for (const auto count : COUNTS) {
+            for (const auto stride : { 1u, 3u }) {
+                const auto scanCase = ScanCase{ count, stride };
+                const auto passed = checkScan(gpu, scan, rng, scanCase);
+
+                std::cout << (passed ? "[PASS] " : "[FAIL] ") << "prefix-scan"
+                    << (subgroupKernels ? " subgroup: " : ": ") << scanCase << '\n';
+                failedCount += passed ? 0 : 1;
+            }
+        }
+
+        scan.destroy();
+        return failedCount;
+    }
+} // namespace
+
+int main(const int argc, char** argv) {
+    // A fixed seed by default so that failures reproduce, pass one to try other inputs
+    const auto seed = argc > 1 ? std::stoull(argv[1]) : 1234ull;
+    auto rng = std::mt19937_64{ seed };
+
+    auto gpu = std::unique_ptr<TestDevice>{};
+    try {
+        gpu = std::make_unique<TestDevice>();
+    } catch (const std::exception& e) {
+        std::cout << "No suitable device to run the kernels on, skipping: " << e.what() << '\n';
+        return SKIP_CODE;
+    }
+
+    std::cout << "Testing on " << gpu->getDeviceName() << " with seed " << seed << '\n';
+    if (!gpu->subgroupKernels()) {
+        std::cout << "Subgroup kernels are not supported, only testing the shared memory ones\n";
+    }
+
+    auto failedCount = 0u;
+    try {
+        for (const auto subgroupKernels : { false, true }) {
+            if (subgroupKernels && !gpu->subgroupKernels()) continue;
+            failedCount += runScanCases(*gpu, subgroupKernels, rng);
+            failedCount += runSortCases(*gpu, subgroupKernels, rng);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Aborted: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::cout << (failedCount == 0 ? "All cases passed" : std::to_string(failedCount) + " case(s) failed") << '\n';
+    return failedCount == 0 ? 0 : 1;
+}
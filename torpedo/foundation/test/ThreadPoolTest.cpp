@@ -0,0 +1,103 @@
+#include <torpedo/foundation/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks that ThreadPool::parallelFor runs every index exactly once, that idle threads steal from a range whose items
+// are much slower than the others, and that an exception thrown by a task abandons the loop and reaches the caller.
+
+namespace {
+    using namespace std::chrono_literals;
+
+    bool check(const bool passed, const std::string& name) {
+        std::cout << (passed ? "[PASS] " : "[FAIL] ") << name << '\n';
+        return passed;
+    }
+
+    bool checkCoverage(tpd::ThreadPool& pool, const uint32_t count) {
+        const auto visits = std::make_unique<std::atomic_uint32_t[]>(count);
+        pool.parallelFor(count, [&visits](const uint32_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (const auto visitCount = visits[i].load(); visitCount != 1) {
+                std::cerr << "  index " << i << " ran " << visitCount << " times\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The first worker's range starts at index 0 and holds every slow item, the rest of the loop is instant. Without
+    // stealing, the thread that took index 0 would run every slow item on its own.
+    bool checkStealing(tpd::ThreadPool& pool) {
+        const auto participants = pool.getThreadCount();
+        const auto count = participants * 16;
+        const auto slowCount = count / participants;
+
+        auto threads = std::vector<std::thread::id>(count);
+        pool.parallelFor(count, [&threads, slowCount](const uint32_t i) {
+            threads[i] = std::this_thread::get_id();
+            if (i < slowCount) std::this_thread::sleep_for(2ms);
+        });
+
+        const auto slowThreads = std::set(threads.begin(), threads.begin() + slowCount);
+        if (slowThreads.size() < 2) {
+            std::cerr << "  all " << slowCount << " slow items ran on a single thread\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Every task throws after a short while, which must skip most of the loop, rethrow the first exception only, and
+    // leave the pool usable for the next loop
+    bool checkException(tpd::ThreadPool& pool) {
+        constexpr auto count = 100'000u;
+        auto ranCount = std::atomic_uint32_t{ 0 };
+
+        auto message = std::string{};
+        try {
+            pool.parallelFor(count, [&ranCount](const uint32_t i) {
+                ranCount.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::sleep_for(10us);
+                if (i % 1000 == 7) throw std::runtime_error("task " + std::to_string(i));
+            });
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+
+        if (!message.starts_with("task ")) {
+            std::cerr << "  the loop did not rethrow the task's exception\n";
+            return false;
+        }
+        if (ranCount.load() == count) {
+            std::cerr << "  every index ran, nothing was abandoned\n";
+            return false;
+        }
+        return checkCoverage(pool, 1000);
+    }
+} // namespace
+
+int main() {
+    auto failedCount = 0u;
+
+    for (const auto workerCount : { 1u, 3u, 8u }) {
+        auto pool = tpd::ThreadPool{ workerCount };
+        const auto suffix = " (" + std::to_string(pool.getThreadCount()) + " threads)";
+
+        for (const auto count : { 0u, 1u, 7u, 1000u, 100'003u }) {
+            failedCount += check(checkCoverage(pool, count), "coverage of " + std::to_string(count) + " indices" + suffix) ? 0 : 1;
+        }
+        failedCount += check(checkStealing(pool), "stealing uneven work" + suffix) ? 0 : 1;
+        failedCount += check(checkException(pool), "exception propagation" + suffix) ? 0 : 1;
+    }
+
+    std::cout << (failedCount == 0 ? "All checks passed" : std::to_string(failedCount) + " check(s) failed") << '\n';
+    return failedCount == 0 ? 0 : 1;
+}
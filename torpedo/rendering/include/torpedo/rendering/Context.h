@@ -26,6 +26,12 @@ namespace tpd {
         template<EngineImpl E>
         [[nodiscard]] std::unique_ptr<E, Deleter<E>> bindEngine();
 
+        // Binds an engine with a headless renderer of its own, on a device shared with all other engines bound this
+        // way. Unlike bindEngine, any number of them may be alive at once, each on a thread of its own if need be.
+        template<EngineImpl E>
+        [[nodiscard]] std::unique_ptr<E, Deleter<E>> bindSharedEngine(uint32_t frameWidth, uint32_t frameHeight)
+            requires std::is_same_v<R, HeadlessRenderer>;
+
         template<EngineImpl E>
         void destroyEngine(std::unique_ptr<E, Deleter<E>> engine) noexcept;
 
@@ -52,8 +58,15 @@ namespace tpd {
         vk::DebugUtilsMessengerEXT _debugMessenger{};
 #endif
 
-        void engineInitRenderer() const;
+        static void engineInitRenderer(R* renderer, Engine* engine);
         Engine* _engine{ nullptr };
+
+        struct SharedBinding {
+            R* renderer;
+            Engine* engine;
+        };
+        std::vector<SharedBinding> _sharedBindings{};
+        std::shared_ptr<SharedDevice> _sharedDevice{};
     };
 }
 
@@ -161,7 +174,7 @@ R* tpd::Context<R>::initRenderer(const uint32_t frameWidth, const uint32_t frame
     _renderer->init(frameWidth, frameHeight);
 
     if (_engine) [[unlikely]] {
-        engineInitRenderer();
+        engineInitRenderer(_renderer, _engine);
     }
     return _renderer;
 }
@@ -184,7 +197,7 @@ R* tpd::Context<R>::initRenderer(const bool fullscreen) {
     _renderer->init(fullscreen);
 
     if (_engine) [[unlikely]] {
-        engineInitRenderer();
+        engineInitRenderer(_renderer, _engine);
     }
     return _renderer;
 }
@@ -225,7 +238,7 @@ std::unique_ptr<E, tpd::Deleter<E>> tpd::Context<R>::bindEngine() {
     // the last minute when the Engine is ready to draw. Therefore, we skip Renderer's initialization here and leave it 
     // to initRenderer. This only ever happens for renderers without surface rendering support.
     if (_renderer->initialized()) {
-        engineInitRenderer();
+        engineInitRenderer(_renderer, _engine);
     }
 
     // Tell Engine's implementations to init their resources. This step should be called after Renderer::engineInit()
@@ -239,20 +252,60 @@ std::unique_ptr<E, tpd::Deleter<E>> tpd::Context<R>::bindEngine() {
 }
 
 template<tpd::RendererImpl R>
-void tpd::Context<R>::engineInitRenderer() const {
+template<tpd::EngineImpl E>
+std::unique_ptr<E, tpd::Deleter<E>> tpd::Context<R>::bindSharedEngine(const uint32_t frameWidth, const uint32_t frameHeight)
+    requires std::is_same_v<R, HeadlessRenderer>
+{
+    // The device was created with the extensions and features of the first engine, others may need more
+    if (_sharedDevice && _sharedDevice->getEngineType() != typeid(E)) [[unlikely]] {
+        PLOGE << "Context - Engines sharing a device must be of the same type: the device was created for "
+              << _sharedDevice->getEngineType().name() << ", not " << typeid(E).name();
+        throw std::runtime_error("Context - Failed to bind an Engine to the shared device");
+    }
+
+    // Frame syncs and targets are per engine, so is the renderer
+    void* alloc = _contextResource.allocate(sizeof(R), alignof(R));
+    R* renderer = new (alloc) R{};
+    renderer->_instance = _instance;
+    renderer->init(frameWidth, frameHeight);
+
+    void* mem = _contextResource.allocate(sizeof(E), alignof(E));
+    E* engine = new (mem) E{};
+    engine->_renderer = renderer;
+    _sharedBindings.push_back({ renderer, engine });
+
+    // Only the first engine picks the physical device and creates the logical one
+    if (!_sharedDevice) {
+        engine->init(_instance, renderer->getVulkanSurface(), renderer->getDeviceExtensions());
+        _sharedDevice = std::make_shared<SharedDevice>(
+            engine->_physicalDevice, engine->_device, engine->_vmaAllocator,
+            engine->_graphicsFamilyIndex, engine->_transferFamilyIndex, engine->_computeFamilyIndex,
+            engine->_presentFamilyIndex, typeid(E));
+    }
+    engine->init(_sharedDevice);
+
+    engineInitRenderer(renderer, engine);
+    engine->onInitialized();
+    engine->_initialized = true;
+
+    return std::unique_ptr<E, Deleter<E>>(engine, Deleter<E>{ &_contextResource });
+}
+
+template<tpd::RendererImpl R>
+void tpd::Context<R>::engineInitRenderer(R* renderer, Engine* engine) {
     // Inform the renderer about the selected Vulkan resources
-    _renderer->_physicalDevice = _engine->_physicalDevice;
-    _renderer->_device = _engine->_device;
+    renderer->_physicalDevice = engine->_physicalDevice;
+    renderer->_device = engine->_device;
 
     // It's the Renderer's turn to initialize its own rendering resources (e.g. swap chain)
     if constexpr (std::is_same_v<R, SurfaceRenderer>) {
-        _renderer->engineInit(_engine->_graphicsFamilyIndex, _engine->_presentFamilyIndex, _engine->getFrameResource());
+        renderer->engineInit(engine->_graphicsFamilyIndex, engine->_presentFamilyIndex, engine->getFrameResource());
     } else if constexpr (std::is_same_v<R, HeadlessRenderer>) {
-        _renderer->engineInit(_engine->_graphicsFamilyIndex, _engine->_transferFamilyIndex, _engine->getFrameResource());
+        renderer->engineInit(engine->_graphicsFamilyIndex, engine->_transferFamilyIndex, engine->getFrameResource());
     } else {
         throw std::runtime_error("Context - Unrecognized Renderer implementation!");
     }
-    _renderer->_engineInitialized = true;
+    renderer->_engineInitialized = true;
 }
 
 template<tpd::RendererImpl R>
@@ -262,6 +315,14 @@ void tpd::Context<R>::destroyEngine(std::unique_ptr<E, Deleter<E>> engine) noexc
         PLOGW << "Context - Destroying an Engine that has already been destroyed: haha?";
         return;
     }
+    if (const auto binding = std::ranges::find(_sharedBindings, engine.get(), &SharedBinding::engine); binding != _sharedBindings.end()) {
+        const auto renderer = binding->renderer;
+        _sharedBindings.erase(binding);
+        engine.reset();
+        renderer->destroy();
+        _contextResource.deallocate(renderer, sizeof(R), alignof(R));
+        return;
+    }
     if (!_engine || _engine != engine.get()) [[unlikely]] {
         PLOGW << "Context - Destroying an Engine that has not been bound to this Context: "
                  "a Context can only destroy an Engine that was previously bound to it";
@@ -304,6 +365,13 @@ void tpd::Context<R>::destroyCamera(std::unique_ptr<C, Deleter<C>> camera) noexc
 
 template<tpd::RendererImpl R>
 tpd::Context<R>::~Context() noexcept {
+    for (const auto& [renderer, engine] : _sharedBindings) {
+        renderer->destroy();
+        _contextResource.deallocate(renderer, sizeof(R), alignof(R));
+    }
+    _sharedBindings.clear();
+    _sharedDevice.reset(); // must go before the instance
+
     _renderer->destroy(); // don't call delete here
     _contextResource.deallocate(_renderer, sizeof(R), alignof(R));
     _renderer = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "torpedo/rendering/Renderer.h"
+#include "torpedo/rendering/SharedDevice.h"
 
 #include <torpedo/foundation/VmaUsage.h>
 
@@ -18,11 +19,25 @@ namespace tpd {
 
         void waitIdle() const noexcept;
 
+        struct MemoryUsage {
+            vk::DeviceSize allocationBytes{ 0 }; // bound to buffers and images
+            vk::DeviceSize blockBytes{ 0 };      // of the device memory blocks those are placed in
+            vk::DeviceSize usageBytes{ 0 };      // of the whole process, as reported by the driver
+            vk::DeviceSize budgetBytes{ 0 };
+        };
+
+        // Summed over all memory heaps. Engines on a shared device also share the allocator these are counted by.
+        [[nodiscard]] MemoryUsage getMemoryUsage() const;
+
         virtual ~Engine() noexcept { Engine::destroy(); }
 
     protected:
         Engine() = default;
         void init(vk::Instance instance, vk::SurfaceKHR surface, std::vector<const char*>&& rendererDeviceExtensions);
+        void init(const std::shared_ptr<SharedDevice>& sharedDevice);
+
+        // Submissions of engines on a shared device must go through here, the queues are shared with other engines
+        void submit(vk::Queue queue, const vk::SubmitInfo2& submitInfo, vk::Fence fence = {}) const;
 
         [[nodiscard]] virtual std::vector<const char*> getDeviceExtensions() const;
 
@@ -36,6 +51,7 @@ namespace tpd {
 
         [[nodiscard]] virtual const char* getName() const noexcept;
         [[nodiscard]] virtual std::pmr::memory_resource* getFrameResource() noexcept;
+        [[nodiscard]] virtual VmaAllocatorCreateFlags getAllocatorFlags() const noexcept;
 
         virtual void onInitialized() {} // called by Context, not Engine base
         virtual void destroy() noexcept;
@@ -53,6 +69,10 @@ namespace tpd {
         uint32_t _computeFamilyIndex{};
         uint32_t _presentFamilyIndex{};
 
+        // Set when the device is shared with other engines, in which case it is no longer the Engine's to destroy
+        std::shared_ptr<SharedDevice> _sharedDevice{};
+        QueueArbiter* _queueArbiter{ nullptr };
+
         /*--------------------*/
 
         template<RendererImpl R>
@@ -61,7 +81,19 @@ namespace tpd {
 } // namespace tpd
 
 inline void tpd::Engine::waitIdle() const noexcept {
-    _device.waitIdle();
+    if (_queueArbiter) {
+        _queueArbiter->waitIdle();
+    } else {
+        _device.waitIdle();
+    }
+}
+
+inline void tpd::Engine::submit(const vk::Queue queue, const vk::SubmitInfo2& submitInfo, const vk::Fence fence) const {
+    if (_queueArbiter) {
+        _queueArbiter->submit(queue, submitInfo, fence);
+    } else {
+        queue.submit2(submitInfo, fence);
+    }
 }
 
 inline const char* tpd::Engine::getName() const noexcept {
@@ -71,3 +103,7 @@ inline const char* tpd::Engine::getName() const noexcept {
 inline std::pmr::memory_resource* tpd::Engine::getFrameResource() noexcept {
     return std::pmr::get_default_resource();
 }
+
+inline VmaAllocatorCreateFlags tpd::Engine::getAllocatorFlags() const noexcept {
+    return VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT | VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
+}
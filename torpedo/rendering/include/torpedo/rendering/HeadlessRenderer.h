@@ -5,13 +5,22 @@
 namespace tpd {
     class HeadlessRenderer final : public Renderer {
     public:
+        // Waits until the frame about to be rendered is no longer in use by the GPU. Without a swap chain, the
+        // engine signals the frame's fence with the last submission that reads its target, see FrameSync.
+        void launchFrame();
+        void submitFrame() noexcept;
+
         [[nodiscard]] vk::Extent2D getFramebufferSize() const noexcept override;
         [[nodiscard]] uint32_t getInFlightFrameCount() const noexcept override;
 
         [[nodiscard]] uint32_t getCurrentFrameIndex() const noexcept override;
         [[nodiscard]] FrameSync getCurrentFrameSync() const noexcept override;
 
-        static constexpr uint32_t IN_FLIGHT_FRAME_COUNT{ 1 };
+        void resetEngine() noexcept override;
+        ~HeadlessRenderer() noexcept override;
+
+        // Offscreen targets are never presented, so more frames in flight only cost memory
+        static constexpr uint32_t IN_FLIGHT_FRAME_COUNT{ 3 };
 
     private:
         HeadlessRenderer() = default;
@@ -20,8 +29,10 @@ namespace tpd {
         bool initialized() const noexcept override;
         void engineInit(uint32_t graphicsFamily, uint32_t transferFamily, std::pmr::memory_resource* frameResource) override;
 
+        void destroy() noexcept override;
+
         vk::Extent2D _framebufferSize{};
-        std::array<FrameSync, IN_FLIGHT_FRAME_COUNT> _frameSyncs{};
+        std::pmr::vector<FrameSync> _frameSyncs{}; // only fences, there is no image to acquire or present
         uint32_t _currentFrame{ 0 };
 
         template<RendererImpl R>
@@ -38,12 +49,17 @@ inline vk::Extent2D tpd::HeadlessRenderer::getFramebufferSize() const noexcept {
 }
 
 inline uint32_t tpd::HeadlessRenderer::getInFlightFrameCount() const noexcept {
-    return 1;
+    return IN_FLIGHT_FRAME_COUNT;
 }
 
 inline uint32_t tpd::HeadlessRenderer::getCurrentFrameIndex() const noexcept {
     return _currentFrame;
 }
+
 inline tpd::Renderer::FrameSync tpd::HeadlessRenderer::getCurrentFrameSync() const noexcept {
     return _frameSyncs[_currentFrame];
 }
+
+inline void tpd::HeadlessRenderer::submitFrame() noexcept {
+    _currentFrame = (_currentFrame + 1) % IN_FLIGHT_FRAME_COUNT;
+}
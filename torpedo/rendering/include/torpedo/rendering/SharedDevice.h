@@ -0,0 +1,60 @@
+#pragma once
+
+#include <torpedo/foundation/QueueArbiter.h>
+#include <torpedo/foundation/VmaUsage.h>
+
+#include <typeindex>
+
+namespace tpd {
+    // A logical device with its allocator and pipeline cache, shared by the engines a Context binds with
+    // bindSharedEngine. The first of them creates the device with the extensions and features it needs, the others
+    // adopt it as is, which is why they must all be of the same type. Each engine still owns its resources, command
+    // pools and synchronization objects, only submissions meet at the shared queues, serialized by the arbiter.
+    class SharedDevice final {
+    public:
+        SharedDevice(
+            vk::PhysicalDevice physicalDevice, vk::Device device, VmaAllocator vmaAllocator,
+            uint32_t graphicsFamily, uint32_t transferFamily, uint32_t computeFamily, uint32_t presentFamily,
+            std::type_index engineType);
+
+        SharedDevice(const SharedDevice&) = delete;
+        SharedDevice& operator=(const SharedDevice&) = delete;
+
+        [[nodiscard]] QueueArbiter& getQueueArbiter() noexcept;
+        [[nodiscard]] std::type_index getEngineType() const noexcept;
+
+        // Null until an engine publishes the one it has created, the device takes ownership of it
+        [[nodiscard]] vk::PipelineCache getPipelineCache() const noexcept;
+        void setPipelineCache(vk::PipelineCache pipelineCache);
+
+        ~SharedDevice() noexcept;
+
+    private:
+        vk::PhysicalDevice _physicalDevice;
+        vk::Device _device;
+        VmaAllocator _vmaAllocator;
+
+        uint32_t _graphicsFamilyIndex;
+        uint32_t _transferFamilyIndex;
+        uint32_t _computeFamilyIndex;
+        uint32_t _presentFamilyIndex;
+
+        QueueArbiter _queueArbiter;
+        vk::PipelineCache _pipelineCache{};
+        std::type_index _engineType;
+
+        friend class Engine;
+    };
+} // namespace tpd
+
+inline tpd::QueueArbiter& tpd::SharedDevice::getQueueArbiter() noexcept {
+    return _queueArbiter;
+}
+
+inline std::type_index tpd::SharedDevice::getEngineType() const noexcept {
+    return _engineType;
+}
+
+inline vk::PipelineCache tpd::SharedDevice::getPipelineCache() const noexcept {
+    return _pipelineCache;
+}
@@ -4,6 +4,9 @@
 #include <torpedo/bootstrap/DeviceBuilder.h>
 #include <torpedo/bootstrap/PhysicalDeviceSelector.h>
 
+#include <array>
+#include <bit>
+
 void tpd::Engine::init(
     const vk::Instance instance,
     const vk::SurfaceKHR surface,
@@ -22,15 +25,23 @@ void tpd::Engine::init(
     PLOGI << "Found a suitable device for " << getName() << ": " << _physicalDevice.getProperties().deviceName.data();
 
     // Create a device allocator
+    const auto allocatorFlags = getAllocatorFlags();
     _vmaAllocator = vma::Builder()
-        .flags(VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT | VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT)
+        .flags(allocatorFlags)
         .vulkanApiVersion(VK_API_VERSION_1_3)
         .build(instance, _physicalDevice, _device);
 
     PLOGI << "Using VMA API version: 1.3";
-    PLOGD << "VMA created with the following flags (2):";
-    PLOGD << " - VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT";
-    PLOGD << " - VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT";
+    PLOGD << "VMA created with the following flags (" << std::popcount(allocatorFlags) << "):";
+    if (allocatorFlags & VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT) {
+        PLOGD << " - VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT";
+    }
+    if (allocatorFlags & VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT) {
+        PLOGD << " - VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT";
+    }
+    if (allocatorFlags & VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT) {
+        PLOGD << " - VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT";
+    }
 
     // Init all queue-related info
     _graphicsFamilyIndex = graphicsIndex;
@@ -39,6 +50,21 @@ void tpd::Engine::init(
     _presentFamilyIndex  = presentIndex;
 }
 
+void tpd::Engine::init(const std::shared_ptr<SharedDevice>& sharedDevice) {
+    _physicalDevice = sharedDevice->_physicalDevice;
+    _device = sharedDevice->_device;
+    _vmaAllocator = sharedDevice->_vmaAllocator;
+
+    _graphicsFamilyIndex = sharedDevice->_graphicsFamilyIndex;
+    _transferFamilyIndex = sharedDevice->_transferFamilyIndex;
+    _computeFamilyIndex  = sharedDevice->_computeFamilyIndex;
+    _presentFamilyIndex  = sharedDevice->_presentFamilyIndex;
+
+    _sharedDevice = sharedDevice;
+    _queueArbiter = &sharedDevice->getQueueArbiter();
+    PLOGI << "Sharing a device with other engines for " << getName() << ": " << _physicalDevice.getProperties().deviceName.data();
+}
+
 std::vector<const char*> tpd::Engine::getDeviceExtensions() const {
     auto extensions = std::vector{
         vk::EXTMemoryBudgetExtensionName,    // help VMA estimate memory budget more accurately
@@ -80,7 +106,40 @@ vk::Device tpd::Engine::createDevice(
         .build(_physicalDevice, deviceExtensions);
 }
 
+tpd::Engine::MemoryUsage tpd::Engine::getMemoryUsage() const {
+    const VkPhysicalDeviceMemoryProperties* properties;
+    vmaGetMemoryProperties(_vmaAllocator, &properties);
+
+    auto budgets = std::array<VmaBudget, VK_MAX_MEMORY_HEAPS>{};
+    vmaGetHeapBudgets(_vmaAllocator, budgets.data());
+
+    auto usage = MemoryUsage{};
+    for (uint32_t heap = 0; heap < properties->memoryHeapCount; ++heap) {
+        usage.allocationBytes += budgets[heap].statistics.allocationBytes;
+        usage.blockBytes += budgets[heap].statistics.blockBytes;
+        usage.usageBytes += budgets[heap].usage;
+        usage.budgetBytes += budgets[heap].budget;
+    }
+    return usage;
+}
+
 void tpd::Engine::destroy() noexcept {
+    if (_initialized && _sharedDevice) {
+        _initialized = false;
+
+        // The renderer waits for the device to idle, which must not race with submissions of other engines
+        if (_renderer) {
+            _queueArbiter->exclusive([this] { _renderer->resetEngine(); });
+            _renderer = nullptr;
+        }
+
+        // Whoever lets go of the shared device last destroys it
+        _queueArbiter = nullptr;
+        _sharedDevice.reset();
+        _device = nullptr;
+        _physicalDevice = nullptr;
+    }
+
     if (_initialized) {
         _initialized = false;
         vma::destroy(_vmaAllocator);
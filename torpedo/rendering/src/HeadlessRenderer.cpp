@@ -1,6 +1,10 @@
 #include "torpedo/rendering/HeadlessRenderer.h"
 #include "torpedo/rendering/LogUtils.h"
 
+#include <torpedo/foundation/FrameTracer.h>
+
+#include <algorithm>
+
 void tpd::HeadlessRenderer::init(const uint32_t frameWidth, const uint32_t frameHeight) {
     if (initialized()) [[unlikely]] {
         PLOGI << "Skipping already initialized renderer: tpd::HeadlessRenderer";
@@ -11,8 +15,47 @@ void tpd::HeadlessRenderer::init(const uint32_t frameWidth, const uint32_t frame
 }
 
 void tpd::HeadlessRenderer::engineInit(
-    const uint32_t graphicsFamily,
-    const uint32_t transferFamily,
+    [[maybe_unused]] const uint32_t graphicsFamily,
+    [[maybe_unused]] const uint32_t transferFamily,
     std::pmr::memory_resource* frameResource)
 {
+    _frameSyncs = std::pmr::vector<FrameSync>{ frameResource };
+    _frameSyncs.reserve(IN_FLIGHT_FRAME_COUNT);
+    _frameSyncs.resize(IN_FLIGHT_FRAME_COUNT);
+
+    for (auto& [imageReady, renderDone, frameDrawFence] : _frameSyncs) {
+        frameDrawFence = _device.createFence({ vk::FenceCreateFlagBits::eSignaled });
+    }
+    _currentFrame = 0;
+}
+
+void tpd::HeadlessRenderer::launchFrame() {
+    TPD_TRACE_ZONE("HeadlessRenderer::launchFrame");
+    const auto frameDrawFence = _frameSyncs[_currentFrame].frameDrawFence;
+    {
+        TPD_TRACE_ZONE("HeadlessRenderer::waitFrameDrawFence");
+        using limits = std::numeric_limits<uint64_t>;
+        [[maybe_unused]] const auto result = _device.waitForFences(frameDrawFence, vk::True, limits::max());
+    }
+    _device.resetFences(frameDrawFence);
+}
+
+void tpd::HeadlessRenderer::resetEngine() noexcept {
+    if (_engineInitialized) {
+        // Make sure the GPU has stopped doing its things
+        _device.waitIdle();
+
+        std::ranges::for_each(_frameSyncs, [this](const auto& frame) { _device.destroyFence(frame.frameDrawFence); });
+        _frameSyncs.clear();
+    }
+    Renderer::resetEngine();
+}
+
+void tpd::HeadlessRenderer::destroy() noexcept {
+    resetEngine();
+    Renderer::destroy();
+}
+
+tpd::HeadlessRenderer::~HeadlessRenderer() noexcept {
+    destroy();
 }
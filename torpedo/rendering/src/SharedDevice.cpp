@@ -0,0 +1,38 @@
+#include "torpedo/rendering/SharedDevice.h"
+
+#include <array>
+
+tpd::SharedDevice::SharedDevice(
+    const vk::PhysicalDevice physicalDevice,
+    const vk::Device device,
+    VmaAllocator vmaAllocator,
+    const uint32_t graphicsFamily,
+    const uint32_t transferFamily,
+    const uint32_t computeFamily,
+    const uint32_t presentFamily,
+    const std::type_index engineType)
+    : _physicalDevice{ physicalDevice }
+    , _device{ device }
+    , _vmaAllocator{ vmaAllocator }
+    , _graphicsFamilyIndex{ graphicsFamily }
+    , _transferFamilyIndex{ transferFamily }
+    , _computeFamilyIndex{ computeFamily }
+    , _presentFamilyIndex{ presentFamily }
+    , _queueArbiter{ device, std::array{ graphicsFamily, transferFamily, computeFamily, presentFamily } }
+    , _engineType{ engineType }
+{
+}
+
+void tpd::SharedDevice::setPipelineCache(const vk::PipelineCache pipelineCache) {
+    if (_pipelineCache) [[unlikely]] {
+        throw std::runtime_error("SharedDevice - A pipeline cache has already been set for this device");
+    }
+    _pipelineCache = pipelineCache;
+}
+
+tpd::SharedDevice::~SharedDevice() noexcept {
+    // Engines sharing the device have all been destroyed by now, the last of them has waited for it to idle
+    _device.destroyPipelineCache(_pipelineCache);
+    vma::destroy(_vmaAllocator);
+    _device.destroy();
+}
@@ -4,6 +4,7 @@
 #include <torpedo/bootstrap/SwapChainBuilder.h>
 #include <torpedo/bootstrap/DebugUtils.h>
 
+#include <torpedo/foundation/FrameTracer.h>
 #include <torpedo/foundation/Image.h>
 #include <torpedo/foundation/ImageUtils.h>
 
@@ -252,8 +253,12 @@ void tpd::SurfaceRenderer::createFrameSyncPrimitives(std::pmr::memory_resource*
 }
 
 tpd::SwapImage tpd::SurfaceRenderer::launchFrame() {
-    using limits = std::numeric_limits<uint64_t>;
-    [[maybe_unused]] const auto result = _device.waitForFences(_frameSyncs[_currentFrame].frameDrawFence, vk::True, limits::max());
+    TPD_TRACE_ZONE("SurfaceRenderer::launchFrame");
+    {
+        TPD_TRACE_ZONE("SurfaceRenderer::waitFrameDrawFence");
+        using limits = std::numeric_limits<uint64_t>;
+        [[maybe_unused]] const auto result = _device.waitForFences(_frameSyncs[_currentFrame].frameDrawFence, vk::True, limits::max());
+    }
 
     uint32_t imageIndex;
     if (!acquireSwapChainImage(_frameSyncs[_currentFrame].imageReady, &imageIndex)) [[unlikely]] {
@@ -291,6 +296,7 @@ bool tpd::SurfaceRenderer::acquireSwapChainImage(const vk::Semaphore semaphore,
 }
 
 void tpd::SurfaceRenderer::submitFrame(const uint32_t imageIndex) {
+    TPD_TRACE_ZONE("SurfaceRenderer::submitFrame");
     presentSwapChainImage(imageIndex, _frameSyncs[_currentFrame].renderDone);
     _currentFrame = (_currentFrame + 1) % IN_FLIGHT_FRAME_COUNT;
 }
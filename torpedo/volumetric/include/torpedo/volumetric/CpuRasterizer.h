@@ -0,0 +1,89 @@
+#pragma once
+
+#include "torpedo/volumetric/GaussianEngine.h"
+#include "torpedo/volumetric/GaussianGeometry.h"
+
+#include <torpedo/foundation/ThreadPool.h>
+
+namespace tpd {
+    // Renders Gaussian points on the CPU with the math of the project, keygen and blend passes of GaussianEngine,
+    // so that GPU frames have a golden reference to be compared against, and scenes can be rendered on machines
+    // without a capable GPU. Splats are binned to tiles of the same size as the GPU's, each tile is then depth sorted
+    // and blended front to back by a task of its own on a work-stealing pool. Blending evaluates the conic of a splat
+    // over a row of pixels at once with AVX2 or NEON where available. Only full-precision splats are reproduced, the
+    // packed layout of Settings::halfPrecisionSplats rounds conics and colors which the rasterizer does not emulate.
+    class CpuRasterizer final {
+    public:
+        struct Settings {
+            uint32_t sphericalHarmonicsDegree{ 3 };
+            uint32_t blockX{ 16 }; // tiles decide which splats reach a pixel, match the GPU's for identical frames
+            uint32_t blockY{ 16 };
+            uint32_t workerCount{ 0 }; // zero leaves one thread per core, the caller included
+            bool simdKernels{ true };  // scalar blending otherwise, which then serves as a reference for the kernels
+
+            [[nodiscard]] static constexpr Settings getDefault() { return {}; };
+        };
+
+        explicit CpuRasterizer(const Settings& settings = Settings::getDefault());
+
+        CpuRasterizer(const CpuRasterizer&) = delete;
+        CpuRasterizer& operator=(const CpuRasterizer&) = delete;
+
+        struct Frame {
+            vk::Extent2D extent{};
+            std::vector<std::byte> pixels{}; // tightly packed R8G8B8A8 rows, the same as GaussianEngine::HostFrame
+            GaussianEngine::FrameStatistics statistics{};
+        };
+
+        // The model matrix applies to every point, as the transform of a single entity would on the GPU
+        [[nodiscard]] Frame render(
+            std::span<const GaussianPoint> points, const Camera& camera,
+            uint32_t width, uint32_t height, const mat4& model = mat4{ 1.0f });
+
+        // Name of the blending kernel render runs with: "avx2", "neon" or "scalar"
+        [[nodiscard]] const char* getKernelName() const noexcept;
+
+    private:
+        // Mirrors Splat of splat.slang, plus the tile rectangle recomputed by keygen
+        struct Splat {
+            float x;
+            float y;
+            float depth;
+            float conicA;
+            float conicB;
+            float conicC;
+            float opacity;
+            float r;
+            float g;
+            float b;
+            uint32_t rectMinX;
+            uint32_t rectMinY;
+            uint32_t rectMaxX;
+            uint32_t rectMaxY;
+            uint32_t tiles; // zero for culled splats
+        };
+
+        struct View {
+            mat4 viewModel;
+            mat4 projModel; // world to clip space followed by the model matrix
+            float viewRotation[3][3];
+            float cameraPosition[3];
+            float focalX;
+            float focalY;
+        };
+
+        // Returns whether the point survives frustum culling, the splat may still be culled afterward
+        [[nodiscard]] bool project(const GaussianPoint& point, const View& view, uint32_t width, uint32_t height, Splat& splat) const noexcept;
+        void binTiles(uint32_t gridX, uint32_t gridY);
+        [[nodiscard]] uint32_t blendTile(uint32_t tile, uint32_t gridX, Frame& frame); // sorts the keys of the tile in place
+
+        Settings _settings;
+        ThreadPool _threadPool;
+        bool _simd{ false };
+
+        // Kept across frames to save allocations
+        std::vector<Splat> _splats{};
+        std::vector<uint32_t> _tileOffsets{}; // exclusive prefix of splats per tile, one more entry than tiles
+        std::vector<uint64_t> _tileKeys{};    // depth bits | splat index, grouped by tile
+    };
+} // namespace tpd
@@ -4,18 +4,33 @@
 #include <torpedo/rendering/Camera.h>
 #include <torpedo/rendering/TransformHost.h>
 
+#include <torpedo/foundation/ComputeGraph.h>
+#include <torpedo/foundation/GpuPrefixScan.h>
+#include <torpedo/foundation/GpuRadixSort.h>
+#include <torpedo/foundation/ReadbackWorker.h>
 #include <torpedo/foundation/RingBuffer.h>
 #include <torpedo/foundation/ShaderLayout.h>
 #include <torpedo/foundation/StorageBuffer.h>
 #include <torpedo/foundation/TwoWayBuffer.h>
 #include <torpedo/foundation/Target.h>
+#include <torpedo/foundation/TimestampProfiler.h>
 #include <torpedo/foundation/TransferWorker.h>
 
+#include "torpedo/volumetric/KernelTuning.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+
 namespace tpd {
     class GaussianEngine final : public Engine {
     public:
         struct Settings {
             uint32_t sphericalHarmonicsDegree{ 3 };
+            bool halfPrecisionSplats{ false }; // store splats in a packed 32-byte fp16 layout, see splat.slang
+            bool gpuProfiling{ false }; // time each pass with GPU timestamps, see getPassTimings()
+            bool frameStatistics{ false }; // count culling and blending work on the GPU, see getFrameStatistics()
+            bool autotune{ false }; // benchmark kernel launch parameters once per device, see getKernelTuning()
 
             [[nodiscard]] static constexpr Settings getDefault() { return {}; };
         };
@@ -24,7 +39,67 @@ namespace tpd {
         [[nodiscard]] const std::unique_ptr<TransformHost>& getTransformHost() const noexcept;
 
         void rasterFrame(const Camera& camera);
-        void draw(SwapImage image) const;
+        void draw(SwapImage image);
+
+        // Renders several views of the scene in two submissions: the project and prefix passes of every view go first,
+        // so that a single readback sizes the sort of all of them, then their blend chains follow back to back. Each
+        // view renders to a target of its own, outside the frames in flight, see renderToHost for reading them back.
+        void rasterFrames(std::span<const Camera* const> cameras);
+
+        // Pixels of a frame rendered by renderToHost, tightly packed rows of R8G8B8A8 texels only valid during the callback
+        struct HostFrame {
+            uint64_t number{ 0 }; // counts renderToHost calls, starting from 0
+            vk::Extent2D extent{};
+            std::span<const std::byte> pixels{};
+        };
+        using HostFrameCallback = std::move_only_function<void(const HostFrame&)>;
+
+        // Renders offscreen with a HeadlessRenderer and reads the target back without waiting for it, so that as many
+        // frames as there are in flight get rendered and copied in the meantime. Callbacks run on this thread, in the
+        // order frames were rendered, from a later renderToHost or waitHostFrames once their frame has reached the host.
+        void renderToHost(const Camera& camera, HostFrameCallback&& callback);
+
+        // Renders a batch of views with rasterFrames and reads them back, invoking the callback once per view in the
+        // order of the cameras. Batches are not pipelined: the previous one is delivered before this one is rendered.
+        void renderToHost(std::span<const Camera* const> cameras, HostFrameCallback&& callback);
+        void waitHostFrames(); // delivers every frame still in flight
+
+        // Launch parameters the pipelines were built with: tuned for this device if it has ever been autotuned,
+        // defaults otherwise. Tuning results are persisted and picked up again on later runs.
+        [[nodiscard]] const KernelTuning& getKernelTuning() const noexcept;
+
+        // Rolling GPU timings of each pass, empty unless Settings::gpuProfiling is enabled
+        [[nodiscard]] std::vector<TimestampProfiler::Stats> getPassTimings() const;
+
+        struct FrameStatistics {
+            uint32_t visibleGaussians{ 0 };      // Gaussians surviving frustum culling
+            uint32_t tilesRendered{ 0 };         // total number of (tile, splat) pairs
+            uint32_t activeTiles{ 0 };           // tiles with at least one splat to blend
+            uint32_t maxSplatsPerTile{ 0 };
+            float meanSplatsPerTile{ 0.0f };     // averaged over active tiles
+            uint32_t earlyTerminatedPixels{ 0 }; // pixels whose transmittance saturated in the blend pass
+        };
+
+        struct TileWorkload {
+            uint32_t tilesX{ 0 };
+            uint32_t tilesY{ 0 };
+            std::vector<uint32_t> splatCounts{}; // row-major, tilesX * tilesY entries
+        };
+
+        // Counters of the latest frame read back from the GPU, lagging behind by the number of in-flight frames.
+        // These remain zero unless Settings::frameStatistics is enabled.
+        [[nodiscard]] const FrameStatistics& getFrameStatistics() const noexcept;
+        [[nodiscard]] const TileWorkload& getTileWorkload() const noexcept;
+
+        struct SortBufferStatistics {
+            uint32_t capacity{ 0 };          // in (tile, splat) pairs
+            vk::DeviceSize bytes{ 0 };       // transient memory of the sort and blend passes, ranges included
+            uint32_t growCount{ 0 };         // reallocations on the critical path, tilesRendered overflowed capacity
+            uint32_t deferredGrowCount{ 0 }; // reallocations made ahead of time at the start of a frame
+            uint32_t shrinkCount{ 0 };
+        };
+
+        [[nodiscard]] SortBufferStatistics getSortBufferStatistics() const noexcept;
 
         ~GaussianEngine() noexcept override { destroy(); }
 
@@ -43,6 +118,7 @@ namespace tpd {
 
         [[nodiscard]] const char* getName() const noexcept override;
         [[nodiscard]] std::pmr::memory_resource* getFrameResource() noexcept override;
+        [[nodiscard]] VmaAllocatorCreateFlags getAllocatorFlags() const noexcept override;
         [[nodiscard]] bool asyncCompute() const noexcept;
 
         void onInitialized() override;
@@ -55,9 +131,42 @@ namespace tpd {
         void createComputeCommandPool(); // only called if async compute is being used
 
         void createGaussianLayout();
-        [[nodiscard]] vk::Pipeline createPipeline(const std::string& slangFile, vk::PipelineLayout layout, uint32_t subgroupSize) const;
-
-        void createFrames();
+        [[nodiscard]] vk::Pipeline createPipeline(
+            const std::string& slangFile, vk::PipelineLayout layout,
+            const KernelTuning& tuning, bool collectStats,
+            vk::PipelineCreationFeedback* feedback = nullptr) const;
+        void createPipelines(const std::vector<std::pair<vk::Pipeline*, std::string>>& pipelines);
+        void createSplatPipelines(); // pipelines whose shaders depend on the splat layout
+        void destroySplatPipelines() const noexcept;
+
+        void createProfilers();
+        void destroyProfilers() noexcept;
+        void calibrateProfiler(TimestampProfiler& profiler, vk::Queue queue, vk::CommandPool pool) const;
+
+        enum class Pass : uint32_t { Project, Prefix, Keygen, RadixShuffle, RadixPrefix, RadixMapping, Range, Blend };
+        [[nodiscard]] bool timingPasses() const noexcept;
+        void recordPassBegin(vk::CommandBuffer cmd, Pass pass, uint32_t instance = 0) const noexcept;
+        void recordPassEnd(vk::CommandBuffer cmd, Pass pass, uint32_t instance = 0) const noexcept;
+
+        void createStatisticsBuffers(uint32_t firstFrame = 0);
+        void createWorkloadBuffers(uint32_t width, uint32_t height);
+        void destroyWorkloadBuffers() noexcept;
+        void collectFrameStatistics(uint32_t frameIndex);
+        void recordWorkloadCopy(vk::CommandBuffer cmd, vk::Buffer rangeBuffer, uint32_t frameIndex) const noexcept;
+
+        void createPipelineCache();
+        void savePipelineCache() const;
+        [[nodiscard]] static std::filesystem::path getPipelineCacheDirectory();
+
+        void loadKernelTuning();
+        void autotune(const Settings& settings);
+        void applyKernelTuning(const KernelTuning& tuning);
+        [[nodiscard]] float measureFrameTime(const Camera& camera);
+        [[nodiscard]] static std::filesystem::path getKernelTuningDirectory();
+
+        void createFrames(uint32_t firstFrame = 0);
+        void createViews(uint32_t viewCount);
+        void createViewSplatBuffers(uint32_t gaussianCount);
 
         void createRenderTargets(uint32_t width, uint32_t height);
         void createCameraBuffer();
@@ -65,21 +174,19 @@ namespace tpd {
         void cleanupRenderTargets() noexcept;
         void updateRadixPassCount(uint32_t width, uint32_t height) noexcept;
 
-        void createSplatKeyBuffers(uint32_t frameIndex);
-        void createSplatIndexBuffers(uint32_t frameIndex);
-        void createGlobalPrefixBuffers(uint32_t frameIndex);
-        void createTempKeyBuffers(uint32_t frameIndex);
-        void createTempValBuffers(uint32_t frameIndex);
-        void createBlockCountBuffers();
-        void createBlockDescriptorBuffers(uint32_t frameIndex);
-        void createGlobalSumBuffers();
-        void createRangeBuffers(uint32_t width, uint32_t height);
+        void createBlendGraph(); // passes from keygen to blend, along with the sort and range buffers they need
+        [[nodiscard]] vk::DeviceAddress getBufferAddress(vk::Buffer buffer) const;
+
+        void createSortDispatchBuffers(uint32_t firstFrame = 0);
+        void updateSortDispatch(uint32_t frameIndex, uint32_t tilesRendered) const;
+        void recordBlendCommands(uint32_t frameIndex);
+        void pushRasterInfo(vk::CommandBuffer cmd, uint32_t frameIndex) const;
+        void invalidateBlendCommands() noexcept;
 
         void createGaussianBuffer(const std::vector<std::byte>& bytes);
         void createSplatBuffer(uint32_t gaussianCount);
         void createTilesRenderedBuffer();
-        void createPartitionCountBuffer();
-        void createPartitionDescriptorBuffer(uint32_t gaussianCount);
+        void createScanScratchBuffer(uint32_t gaussianCount);
 
         void createTransformHandleBuffer(uint32_t entityCount);
         void createTransformIndexBuffer(const std::vector<uint32_t>& indices);
@@ -90,11 +197,15 @@ namespace tpd {
             vk::DescriptorType descriptorType,
             uint32_t binding, uint32_t set = 0) const;
 
-        void updateCameraBuffer(const Camera& camera) const;
-        void recordSplat(vk::CommandBuffer cmd) const noexcept;
-        void reallocateBuffers(uint32_t frameIndex);
-        void recordBlend(vk::CommandBuffer cmd, uint32_t tilesRendered, uint32_t frameIndex) const noexcept;
+        void rasterFrame(const Camera& camera, bool releaseTarget); // not released when autotuning or rendering to host
+        void updateCameraBuffer(const Camera& camera, const RingBuffer& buffer, uint32_t bufferIndex = 0) const;
+        void recordSplat(vk::CommandBuffer cmd, vk::Buffer splats, vk::Buffer tilesRendered, vk::DeviceSize tilesRenderedOffset) const noexcept;
+        void applyPendingSortCapacity(uint32_t frameIndex);
+        void reallocateBuffers(uint32_t frameIndex, uint32_t capacity);
+        void updateSortCapacity(uint32_t tilesRendered);
+        [[nodiscard]] static constexpr uint32_t getGrownCapacity(uint32_t tilesRendered) noexcept;
         void recordTargetCopy(vk::CommandBuffer cmd, SwapImage swapImage, uint32_t frameIndex) const noexcept;
+        void createReadbackWorker();
 
         void destroy() noexcept override;
 
@@ -103,25 +214,39 @@ namespace tpd {
             ShaderInstance<DESCRIPTOR_SET_COUNT> instance{};
             vk::CommandBuffer drawing{};
             vk::CommandBuffer compute{};
+            vk::CommandBuffer blend{}; // secondary, replayed by compute until invalidated, see recordBlendCommands
             vk::Semaphore ownership{}; // only initialize if async compute is being used
             vk::Fence preFrameFence{};
             vk::Fence readBackFence{};
-            uint32_t maxTilesRendered{};
-            StorageBuffer rangeBuffer{}; // put this here to remind us that range buffer depends on image size
+            uint32_t tilesRendered{}; // of the last submission, reported along with the GPU counters
+            bool statsPending{};      // the last submission wrote counters that have not been read back
+            bool blendRecorded{};     // cleared whenever something baked into the blend commands changes
             Target outputImage{};
         };
 
-        // This is the immutable part of the RasterInfo struct in splat.slang during frame drawing. This separation is
-        // due to the fact that the tilesRendered member could change half-way through the pre-frame compute pass.
+        // This is the immutable part of the RasterInfo struct in splat.slang during frame drawing. The number of tiles
+        // rendered is only known half-way through the pre-frame compute pass, so it is read from the sort dispatch instead.
         struct PointCloud {
             uint32_t count{ 0 };
             uint32_t shDegree{ 0 };
         };
 
-        static constexpr uint32_t WORKGROUP_SIZE = 256; // number of local threads per workgroup in scan passes
-        static constexpr uint32_t BLOCK_X = 16; // tile size in x-dimension
-        static constexpr uint32_t BLOCK_Y = 16; // tile size in y-dimension
         static constexpr uint32_t SPLAT_SIZE = 48; // check splat.slang
+        static constexpr uint32_t PACKED_SPLAT_SIZE = 32; // check splat.slang
+        static constexpr uint32_t SPLAT_TILES_OFFSET = 12; // same in both splat layouts, check splat.slang
+        static constexpr uint32_t TARGET_TEXEL_SIZE = 4; // R8G8B8A8 render targets, see createRenderTargets
+        static constexpr uint32_t CAMERA_SIZE = sizeof(mat4) * 2 + sizeof(float) * 2; // check Camera in splat.slang
+        static constexpr uint32_t MAX_RADIX_PASSES = 32; // 64-bit keys sorted 2 bits at a time
+
+        // Sort buffers grow by half again what is needed, and shrink after a few seconds of using less than a quarter
+        static constexpr uint32_t SORT_GROWTH_NUMERATOR = 3;
+        static constexpr uint32_t SORT_GROWTH_DENOMINATOR = 2;
+        static constexpr uint32_t SORT_SHRINK_DELAY_FRAMES = 240;
+
+        // Autotuning renders a synthetic scene a few times with each candidate configuration
+        static constexpr uint32_t TUNING_GAUSSIAN_COUNT = 262144;
+        static constexpr uint32_t TUNING_WARMUP_FRAMES = 2;
+        static constexpr uint32_t TUNING_FRAMES = 8;
 
         /*--------------------*/
 
@@ -134,8 +259,9 @@ namespace tpd {
 
         vk::Queue _graphicsQueue;
         vk::Queue _computeQueue;
-        std::pmr::vector<Frame> _frames{ &_frameResource };
+        std::pmr::vector<Frame> _frames{ &_frameResource }; // frames in flight, followed by the views of rasterFrames
         vk::PipelineLayout _gaussianLayout{};
+        uint32_t _recordingFrame{ 0 }; // frame whose passes are being recorded, read by the blend graph and profiler
 
         /*--------------------*/
 
@@ -143,72 +269,77 @@ namespace tpd {
         RingBuffer _cameraBuffer{};
         TwoWayBuffer _tilesRenderedBuffer{};
 
+        // Views of a batch are all projected before any is blended, so each has a camera, splats, and a tiles rendered
+        // counter of its own. Their frames share the first view's command buffer and fences, see rasterFrames.
+        uint32_t _viewCount{ 0 };
+        RingBuffer _viewCameraBuffer{};
+        TwoWayBuffer _viewTilesRenderedBuffer{};
+        std::vector<StorageBuffer> _viewSplatBuffers{};
+        uint64_t _viewReadbackValue{ 0 }; // readback worker timeline value of the last batch rendered to host
+
         /*--------------------*/
 
         vk::Pipeline _projectPipeline{};
-        vk::Pipeline _prefixPipeline{};
         vk::Pipeline _keygenPipeline{};
-        vk::Pipeline _radixShufflePipeline{};
-        vk::Pipeline _radixPrefixAPipeline{};
-        vk::Pipeline _radixPrefixBPipeline{};
-        vk::Pipeline _radixMappingPipeline{};
         vk::Pipeline _rangePipeline{};
         vk::Pipeline _blendPipeline{};
+        GpuPrefixScan _tileScan{};
+        GpuRadixSort _keySort{};
+        uint32_t _sortKeyBits{ 0 };
         uint32_t _radixPassCount{ 0 };
+        vk::PipelineCache _pipelineCache{};
+        uint32_t _subgroupSize{ 0 };
+        KernelTuning _tuning{};
+        bool _kernelsTuned{ false }; // whether _tuning was measured on this device, in this run or an earlier one
+        bool _halfPrecisionSplats{ false };
+        bool _collectStats{ false };
 
         /*--------------------*/
 
         ShaderLayout<DESCRIPTOR_SET_COUNT> _shaderLayout{};
         std::unique_ptr<TransferWorker> _transferWorker{};
+        std::unique_ptr<ReadbackWorker> _readbackWorker{}; // created on the first renderToHost
+        uint64_t _hostFrameCount{ 0 };
         std::unique_ptr<TransformHost> _transformHost{};
+        TimestampProfiler _passProfiler{}; // compute passes, submitted by rasterFrame
+        TimestampProfiler _copyProfiler{}; // target copy, submitted by draw
 
         StorageBuffer _gaussianBuffer{};
         StorageBuffer _splatBuffer{};
-        StorageBuffer _partitionCountBuffer{};
-        StorageBuffer _partitionDescriptorBuffer{};
+        StorageBuffer _scanScratchBuffer{}; // see GpuPrefixScan::getScratchSize
         StorageBuffer _transformHandleBuffer{};
         StorageBuffer _transformIndexBuffer{};
         RingBuffer _bindlessTransformBuffer{};
 
-        std::vector<StorageBuffer> _splatKeyBuffers{};
-        std::vector<StorageBuffer> _splatIndexBuffers{};
-        std::vector<StorageBuffer> _tempKeyBuffers{};
-        std::vector<StorageBuffer> _tempValBuffers{};
-        std::vector<StorageBuffer> _globalPrefixABuffers{};
-        std::vector<StorageBuffer> _globalPrefixBBuffers{};
-        std::vector<StorageBuffer> _blockCountABuffers{};
-        std::vector<StorageBuffer> _blockCountBBuffers{};
-        std::vector<StorageBuffer> _blockDescriptorABuffers{};
-        std::vector<StorageBuffer> _blockDescriptorBBuffers{};
-        std::vector<StorageBuffer> _globalSumBuffers{};
-
-        using PipelineStage = vk::PipelineStageFlagBits2;
-        using AccessMask = vk::AccessFlagBits2;
-
-        static constexpr auto RAW_BARRIER = vk::MemoryBarrier2{
-            PipelineStage::eComputeShader,   // src stage
-            AccessMask::eShaderStorageWrite, // src access
-            PipelineStage::eComputeShader,   // dst stage
-            AccessMask::eShaderStorageRead,  // dst access
+        // Sort and range buffers are transients of the blend graph, shared by all in-flight frames: the readback fence
+        // serializes the CPU side of each frame, and the barrier the graph starts with serializes the GPU side
+        ComputeGraph _blendGraph{};
+        // Device addresses of the sort and range buffers, pushed along with RasterInfo so that reallocating them only
+        // takes a new set of pointers instead of descriptor writes. Must match SortBuffers in splat.slang
+        struct SortBuffers {
+            vk::DeviceAddress splatKeys;
+            vk::DeviceAddress splatIndices;
+            vk::DeviceAddress ranges;
+            vk::DeviceAddress tilesRendered; // per frame, points into the sort dispatch
         };
+        SortBuffers _sortBuffers{};
 
-        static constexpr auto WAW_BARRIER = vk::MemoryBarrier2{
-            PipelineStage::eComputeShader,
-            AccessMask::eShaderStorageWrite,
-            PipelineStage::eComputeShader,
-            AccessMask::eShaderStorageRead | AccessMask::eShaderStorageWrite,
-        };
+        // The only per-frame variables of the blend commands, written by the host after the tiles rendered readback.
+        // Each holds a GpuRadixSort::Dispatch, the range pass shares the sort's one workgroup per BLOCK_SIZE keys.
+        std::vector<TwoWayBuffer> _sortDispatchBuffers{};
+        uint32_t _sortCapacity{ 1 };        // in (tile, splat) pairs, initialize to 1 so we can render an empty scene
+        uint32_t _pendingSortCapacity{ 1 }; // applied at the start of the next frame, off the critical path
+        uint32_t _lowUsageFrames{ 0 };      // consecutive frames using less than a quarter of the capacity
 
-        static constexpr auto WAT_BARRIER = vk::MemoryBarrier2{
-            PipelineStage::eComputeShader | PipelineStage::eTransfer,
-            AccessMask::eShaderStorageWrite | AccessMask::eTransferWrite,
-            PipelineStage::eComputeShader,
-            AccessMask::eShaderStorageRead | AccessMask::eShaderStorageWrite,
-        };
+        std::vector<TwoWayBuffer> _statsBuffers{};    // FrameStats in splat.slang, always bound
+        std::vector<TwoWayBuffer> _workloadBuffers{}; // host copies of range buffers, only when collecting stats
+        FrameStatistics _frameStatistics{};
+        TileWorkload _tileWorkload{};
+        SortBufferStatistics _sortBufferStatistics{}; // only counters are kept up to date, see getSortBufferStatistics()
+
+        using PipelineStage = vk::PipelineStageFlagBits2;
+        using AccessMask = vk::AccessFlagBits2;
 
-        static constexpr auto RAW_DEPENDENCY = vk::DependencyInfo{ {}, 1, &RAW_BARRIER };
-        static constexpr auto WAW_DEPENDENCY = vk::DependencyInfo{ {}, 1, &WAW_BARRIER };
-        static constexpr auto WAT_DEPENDENCY = vk::DependencyInfo{ {}, 1, &WAT_BARRIER };
         static constexpr auto DST_READ_POINT = SyncPoint{ PipelineStage::eComputeShader, AccessMask::eShaderStorageRead };
 
         [[nodiscard]] static constexpr uint32_t getHigherMSB(uint32_t n) noexcept;
@@ -219,6 +350,18 @@ inline const std::unique_ptr<tpd::TransformHost>& tpd::GaussianEngine::getTransf
     return _transformHost;
 }
 
+inline const tpd::GaussianEngine::FrameStatistics& tpd::GaussianEngine::getFrameStatistics() const noexcept {
+    return _frameStatistics;
+}
+
+inline const tpd::GaussianEngine::TileWorkload& tpd::GaussianEngine::getTileWorkload() const noexcept {
+    return _tileWorkload;
+}
+
+inline const tpd::KernelTuning& tpd::GaussianEngine::getKernelTuning() const noexcept {
+    return _tuning;
+}
+
 inline const char* tpd::GaussianEngine::getName() const noexcept {
     return "tpd::GaussianEngine";
 }
@@ -227,10 +370,19 @@ inline std::pmr::memory_resource* tpd::GaussianEngine::getFrameResource() noexce
     return &_frameResource;
 }
 
+inline VmaAllocatorCreateFlags tpd::GaussianEngine::getAllocatorFlags() const noexcept {
+    return Engine::getAllocatorFlags() | VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+}
+
 inline bool tpd::GaussianEngine::asyncCompute() const noexcept {
     return _graphicsFamilyIndex != _computeFamilyIndex;
 }
 
+constexpr uint32_t tpd::GaussianEngine::getGrownCapacity(const uint32_t tilesRendered) noexcept {
+    const auto capacity = uint64_t{ tilesRendered } * SORT_GROWTH_NUMERATOR / SORT_GROWTH_DENOMINATOR;
+    return static_cast<uint32_t>(std::clamp<uint64_t>(capacity, 1, std::numeric_limits<uint32_t>::max()));
+}
+
 constexpr uint32_t tpd::GaussianEngine::getHigherMSB(const uint32_t n) noexcept {
     uint32_t msb= sizeof(n) * 4;
     auto step = msb;
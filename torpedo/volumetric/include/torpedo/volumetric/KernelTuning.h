@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <filesystem>
+#include <optional>
+
+namespace tpd {
+    // Launch parameters of the Gaussian splatting kernels, baked into their pipelines as specialization constants.
+    // The best values differ from one GPU to another, see GaussianEngine::Settings::autotune.
+    struct KernelTuning {
+        uint32_t workgroupSize{ 256 }; // Gaussians per workgroup in the project and keygen passes
+        uint32_t itemsPerThread{ 8 };  // Gaussians projected by each thread
+        uint32_t blockX{ 16 };         // tile size in x-dimension
+        uint32_t blockY{ 16 };         // tile size in y-dimension
+
+        static constexpr uint32_t MAX_BLOCK_SIZE = 512; // must match splat.slang
+
+        // One subgroup per projecting workgroup, the configuration kernels were originally written for
+        [[nodiscard]] static KernelTuning getDefault(uint32_t subgroupSize) noexcept;
+
+        [[nodiscard]] uint32_t getProjectThreads() const noexcept;
+        [[nodiscard]] bool supported(const vk::PhysicalDeviceLimits& limits) const noexcept;
+
+        bool operator==(const KernelTuning&) const noexcept = default;
+    };
+
+    namespace utils {
+        // Tuning is only meaningful for the device it was measured on, which is identified by its UUID
+        [[nodiscard]] std::filesystem::path getKernelTuningFile(const std::filesystem::path& directory, vk::PhysicalDevice physicalDevice);
+
+        // Returns nothing if there is no readable tuning file for the device under the directory
+        [[nodiscard]] std::optional<KernelTuning> loadKernelTuning(const std::filesystem::path& directory, vk::PhysicalDevice physicalDevice);
+
+        // Returns false if the tuning could not be written, which is never fatal
+        bool saveKernelTuning(const KernelTuning& tuning, const std::filesystem::path& directory, vk::PhysicalDevice physicalDevice);
+    } // namespace utils
+} // namespace tpd
+
+inline tpd::KernelTuning tpd::KernelTuning::getDefault(const uint32_t subgroupSize) noexcept {
+    auto tuning = KernelTuning{};
+    tuning.itemsPerThread = subgroupSize > 0 && subgroupSize <= tuning.workgroupSize ? tuning.workgroupSize / subgroupSize : 1;
+    return tuning;
+}
+
+inline uint32_t tpd::KernelTuning::getProjectThreads() const noexcept {
+    return workgroupSize / itemsPerThread;
+}
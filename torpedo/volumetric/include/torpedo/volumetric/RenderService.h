@@ -0,0 +1,120 @@
+#pragma once
+
+#include "torpedo/volumetric/GaussianEngine.h"
+
+#include <torpedo/foundation/MpscQueue.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+
+namespace tpd {
+    // Serves renders of a compiled scene to any number of threads. Requests are pushed to a lock-free queue by render,
+    // which never blocks, and drained by a render thread owned by the service: each batch of requests is rendered with
+    // a single GaussianEngine::renderToHost, whose callbacks run on that thread once the pixels have reached the host.
+    // A batch closes when it is full or when its oldest request has waited for the batch window, which bounds how long
+    // a request may be held back for others to join it. A batch the engine fails to render fails its own requests only,
+    // the service logs the error and keeps serving. The engine must be bound to a HeadlessRenderer, and must not be
+    // used by anyone else for as long as the service runs.
+    class RenderService final {
+    public:
+        struct Settings {
+            std::chrono::microseconds batchWindow{ 2000 };
+            uint32_t maxBatchSize{ 8 }; // the engine keeps a render target for each view of the largest batch
+
+            [[nodiscard]] static constexpr Settings getDefault() { return {}; };
+        };
+
+        using Callback = GaussianEngine::HostFrameCallback;
+
+        explicit RenderService(GaussianEngine* engine, const Settings& settings = Settings::getDefault());
+
+        RenderService(const RenderService&) = delete;
+        RenderService& operator=(const RenderService&) = delete;
+
+        // Safe to call from any thread. The camera is copied, so it may be changed or destroyed once this returns.
+        void render(const Camera& camera, Callback&& callback);
+
+        struct Metrics {
+            uint32_t queueDepth{ 0 };      // requests waiting to join a batch
+            uint64_t requestCount{ 0 };    // accepted by render so far
+            uint64_t deliveredCount{ 0 };  // whose callback has been invoked
+            uint64_t failedCount{ 0 };     // whose batch failed to render, their callbacks are dropped
+            uint64_t batchCount{ 0 };
+            float meanBatchSize{ 0.0f };
+            float latencyAverage{ 0.0f };  // from render to callback over the most recent requests, in milliseconds
+            float latencyP50{ 0.0f };
+            float latencyP95{ 0.0f };
+            float latencyP99{ 0.0f };
+        };
+
+        [[nodiscard]] Metrics getMetrics() const; // safe to call from any thread
+
+        // Delivers every request accepted so far, then joins the render thread. Requests made afterward are rejected.
+        void stop();
+
+        ~RenderService() noexcept;
+
+    private:
+        // Keeps the matrices of a camera, whose type is unknown to the service and which may not outlive the request
+        class CameraSnapshot final : public Camera {
+        public:
+            explicit CameraSnapshot(const Camera& camera);
+
+            [[nodiscard]] const float* getProjectionData() const noexcept override;
+            [[nodiscard]] uint32_t getProjectionByteSize() const noexcept override;
+
+        private:
+            std::array<float, 16> _projection{};
+            uint32_t _projectionByteSize;
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Request {
+            CameraSnapshot camera;
+            Callback callback;
+            Clock::time_point time; // when render accepted it
+        };
+
+        void run();
+
+        // Returns nothing once the service is stopping and no request is left
+        [[nodiscard]] std::optional<Request> popRequest();
+        void renderBatch(std::vector<Request>& batch);
+        void recordLatency(Clock::duration latency);
+
+        GaussianEngine* _engine;
+        Settings _settings;
+
+        MpscQueue<Request> _requests{};
+        std::counting_semaphore<> _pending{ 0 }; // released after each push, and once more by stop
+        std::atomic_bool _stopping{ false };
+
+        std::atomic_uint32_t _queueDepth{ 0 };
+        std::atomic_uint64_t _requestCount{ 0 };
+        std::atomic_uint64_t _deliveredCount{ 0 };
+        std::atomic_uint64_t _failedCount{ 0 };
+        std::atomic_uint64_t _batchCount{ 0 };
+        std::atomic_uint64_t _batchedRequestCount{ 0 };
+
+        static constexpr uint32_t LATENCY_HISTORY_SIZE{ 1024 };
+        mutable std::mutex _latencyMutex{};
+        std::array<float, LATENCY_HISTORY_SIZE> _latencyHistory{};
+        uint32_t _latencyCursor{ 0 };
+        uint32_t _latencySampleCount{ 0 };
+
+        std::thread _renderThread{}; // started last, once everything it touches has been initialized
+    };
+} // namespace tpd
+
+inline const float* tpd::RenderService::CameraSnapshot::getProjectionData() const noexcept {
+    return _projection.data();
+}
+
+inline uint32_t tpd::RenderService::CameraSnapshot::getProjectionByteSize() const noexcept {
+    return _projectionByteSize;
+}
@@ -0,0 +1,633 @@
+#include "torpedo/volumetric/CpuRasterizer.h"
+
+#include <torpedo/foundation/FrameTracer.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define TPD_CPU_RASTER_AVX2
+#if defined(__GNUC__) || defined(__clang__)
+#define TPD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TPD_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define TPD_CPU_RASTER_NEON
+#endif
+
+namespace {
+    // Points projected by each task, fine enough to balance and coarse enough to amortize taking the task
+    constexpr uint32_t PROJECT_CHUNK_SIZE = 4096;
+
+    // Blending constants of blend.slang
+    constexpr float MAX_ALPHA = 0.99f;
+    constexpr float MIN_ALPHA = 1.0f / 255.0f;
+    constexpr float MIN_TRANSMITTANCE = 0.0001f;
+
+    // Only what blending reads, gathered per tile in depth order
+    struct BlendSplat {
+        float x;
+        float y;
+        float conicA;
+        float conicB;
+        float conicC;
+        float opacity;
+        float r;
+        float g;
+        float b;
+    };
+
+    // Blends the splats over laneCount consecutive pixels of a row starting at (x, y), writing an RGB triple per pixel,
+    // and returns how many of them saturated. Each kernel handles at most its own width of pixels per call.
+    using BlendKernel = uint32_t(*)(const BlendSplat*, uint32_t, uint32_t, uint32_t, uint32_t, float*);
+
+    constexpr uint32_t SCALAR_WIDTH = 8;
+
+    uint32_t blendScalar(
+        const BlendSplat* splats, const uint32_t count,
+        const uint32_t x, const uint32_t y, const uint32_t laneCount, float* rgb)
+    {
+        auto terminatedCount = 0u;
+        for (uint32_t lane = 0; lane < laneCount; ++lane) {
+            const auto px = static_cast<float>(x + lane);
+            const auto py = static_cast<float>(y);
+
+            auto T = 1.0f;
+            auto color = std::array{ 0.0f, 0.0f, 0.0f };
+            for (uint32_t j = 0; j < count; ++j) {
+                const auto& splat = splats[j];
+
+                // Resample using conic matrix
+                const auto dx = splat.x - px;
+                const auto dy = splat.y - py;
+                const auto power = -0.5f * (splat.conicA * dx * dx + splat.conicC * dy * dy) - splat.conicB * dx * dy;
+                if (power > 0.0f) continue;
+
+                const auto alpha = std::min(MAX_ALPHA, splat.opacity * std::exp(power));
+                if (alpha < MIN_ALPHA) continue;
+
+                const auto test = T * (1.0f - alpha);
+                if (test < MIN_TRANSMITTANCE) {
+                    ++terminatedCount;
+                    break;
+                }
+
+                color[0] += splat.r * alpha * T;
+                color[1] += splat.g * alpha * T;
+                color[2] += splat.b * alpha * T;
+                T = test;
+            }
+            std::ranges::copy(color, rgb + lane * 3);
+        }
+        return terminatedCount;
+    }
+
+#ifdef TPD_CPU_RASTER_AVX2
+    constexpr uint32_t AVX2_WIDTH = 8;
+
+    bool avx2Supported() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+#elif defined(__AVX2__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Cephes' single precision exponential, within 2 ulp of std::exp over the range blending evaluates
+    TPD_TARGET_AVX2 __m256 exp256(__m256 x) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f)), _mm256_set1_ps(88.3762626647949f));
+
+        // exp(x) = 2^n * exp(r), with n = round(x / ln2) and r = x - n * ln2 split in two for precision
+        auto fx = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)), _mm256_set1_ps(0.5f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(0.693359375f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(-2.12194440e-4f)));
+
+        auto y = _mm256_set1_ps(1.9875691500e-4f);
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.3981999507e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(8.3334519073e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(4.1665795894e-2f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.6666665459e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(5.0000001201e-1f));
+        y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, _mm256_mul_ps(x, x)), x), _mm256_set1_ps(1.0f));
+
+        // Builds 2^n from its exponent bits, n = -127 at the lower clamp flushes the result to zero
+        const auto n = _mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127));
+        return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(n, 23)));
+    }
+
+    TPD_TARGET_AVX2 uint32_t blendAvx2(
+        const BlendSplat* splats, const uint32_t count,
+        const uint32_t x, const uint32_t y, const uint32_t laneCount, float* rgb)
+    {
+        const auto lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const auto px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lanes);
+        const auto py = _mm256_set1_ps(static_cast<float>(y));
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.0f);
+
+        // Lanes past the end of the row start out done, as threads of pixels outside the image do
+        auto done = _mm256_cmp_ps(lanes, _mm256_set1_ps(static_cast<float>(laneCount)), _CMP_GE_OQ);
+        auto terminated = zero;
+        auto T = one;
+        auto r = zero;
+        auto g = zero;
+        auto b = zero;
+
+        for (uint32_t j = 0; j < count && _mm256_movemask_ps(done) != 0xFF; ++j) {
+            const auto& splat = splats[j];
+
+            const auto dx = _mm256_sub_ps(_mm256_set1_ps(splat.x), px);
+            const auto dy = _mm256_sub_ps(_mm256_set1_ps(splat.y), py);
+            const auto quadratic = _mm256_add_ps(
+                _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(splat.conicA), dx), dx),
+                _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(splat.conicC), dy), dy));
+            const auto power = _mm256_sub_ps(
+                _mm256_mul_ps(_mm256_set1_ps(-0.5f), quadratic),
+                _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(splat.conicB), dx), dy));
+
+            // Comparisons are negated where blend.slang skips, so that NaNs are blended there as well
+            auto valid = _mm256_andnot_ps(done, _mm256_cmp_ps(power, zero, _CMP_NGT_UQ));
+            const auto alpha = _mm256_min_ps(_mm256_set1_ps(MAX_ALPHA), _mm256_mul_ps(_mm256_set1_ps(splat.opacity), exp256(power)));
+            valid = _mm256_and_ps(valid, _mm256_cmp_ps(alpha, _mm256_set1_ps(MIN_ALPHA), _CMP_NLT_UQ));
+
+            const auto test = _mm256_mul_ps(T, _mm256_sub_ps(one, alpha));
+            const auto saturated = _mm256_and_ps(valid, _mm256_cmp_ps(test, _mm256_set1_ps(MIN_TRANSMITTANCE), _CMP_LT_OQ));
+            done = _mm256_or_ps(done, saturated);
+            terminated = _mm256_or_ps(terminated, saturated);
+
+            const auto blended = _mm256_andnot_ps(saturated, valid);
+            const auto weight = _mm256_and_ps(blended, _mm256_mul_ps(alpha, T));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_set1_ps(splat.r), weight));
+            g = _mm256_add_ps(g, _mm256_mul_ps(_mm256_set1_ps(splat.g), weight));
+            b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_set1_ps(splat.b), weight));
+            T = _mm256_blendv_ps(T, test, blended);
+        }
+
+        alignas(32) float channels[3][AVX2_WIDTH];
+        _mm256_store_ps(channels[0], r);
+        _mm256_store_ps(channels[1], g);
+        _mm256_store_ps(channels[2], b);
+        for (uint32_t lane = 0; lane < laneCount; ++lane) {
+            rgb[lane * 3 + 0] = channels[0][lane];
+            rgb[lane * 3 + 1] = channels[1][lane];
+            rgb[lane * 3 + 2] = channels[2][lane];
+        }
+        return static_cast<uint32_t>(std::popcount(static_cast<uint32_t>(_mm256_movemask_ps(terminated))));
+    }
+#endif // TPD_CPU_RASTER_AVX2
+
+#ifdef TPD_CPU_RASTER_NEON
+    constexpr uint32_t NEON_WIDTH = 4;
+
+    // Same approximation as exp256, see there
+    float32x4_t exp128(float32x4_t x) {
+        x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f)), vdupq_n_f32(88.3762626647949f));
+
+        // Rounds down by truncating, then subtracting one where truncation went up
+        auto fx = vaddq_f32(vmulq_f32(x, vdupq_n_f32(1.44269504088896341f)), vdupq_n_f32(0.5f));
+        const auto truncated = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+        const auto above = vcgtq_f32(truncated, fx);
+        fx = vsubq_f32(truncated, vreinterpretq_f32_u32(vandq_u32(above, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+
+        x = vsubq_f32(x, vmulq_f32(fx, vdupq_n_f32(0.693359375f)));
+        x = vsubq_f32(x, vmulq_f32(fx, vdupq_n_f32(-2.12194440e-4f)));
+
+        auto y = vdupq_n_f32(1.9875691500e-4f);
+        y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.3981999507e-3f));
+        y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(8.3334519073e-3f));
+        y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(4.1665795894e-2f));
+        y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.6666665459e-1f));
+        y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(5.0000001201e-1f));
+        y = vaddq_f32(vaddq_f32(vmulq_f32(y, vmulq_f32(x, x)), x), vdupq_n_f32(1.0f));
+
+        const auto n = vaddq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(127));
+        return vmulq_f32(y, vreinterpretq_f32_s32(vshlq_n_s32(n, 23)));
+    }
+
+    uint32_t blendNeon(
+        const BlendSplat* splats, const uint32_t count,
+        const uint32_t x, const uint32_t y, const uint32_t laneCount, float* rgb)
+    {
+        constexpr float laneOffsets[NEON_WIDTH] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        const auto lanes = vld1q_f32(laneOffsets);
+        const auto px = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), lanes);
+        const auto py = vdupq_n_f32(static_cast<float>(y));
+        const auto zero = vdupq_n_f32(0.0f);
+        const auto one = vdupq_n_f32(1.0f);
+
+        auto done = vcgeq_f32(lanes, vdupq_n_f32(static_cast<float>(laneCount)));
+        auto terminated = vdupq_n_u32(0);
+        auto T = one;
+        auto r = zero;
+        auto g = zero;
+        auto b = zero;
+
+        for (uint32_t j = 0; j < count && vminvq_u32(done) == 0; ++j) {
+            const auto& splat = splats[j];
+
+            const auto dx = vsubq_f32(vdupq_n_f32(splat.x), px);
+            const auto dy = vsubq_f32(vdupq_n_f32(splat.y), py);
+            const auto quadratic = vaddq_f32(
+                vmulq_f32(vmulq_f32(vdupq_n_f32(splat.conicA), dx), dx),
+                vmulq_f32(vmulq_f32(vdupq_n_f32(splat.conicC), dy), dy));
+            const auto power = vsubq_f32(
+                vmulq_f32(vdupq_n_f32(-0.5f), quadratic),
+                vmulq_f32(vmulq_f32(vdupq_n_f32(splat.conicB), dx), dy));
+
+            auto valid = vbicq_u32(vmvnq_u32(vcgtq_f32(power, zero)), done);
+            const auto alpha = vminq_f32(vdupq_n_f32(MAX_ALPHA), vmulq_f32(vdupq_n_f32(splat.opacity), exp128(power)));
+            valid = vbicq_u32(valid, vcltq_f32(alpha, vdupq_n_f32(MIN_ALPHA)));
+
+            const auto test = vmulq_f32(T, vsubq_f32(one, alpha));
+            const auto saturated = vandq_u32(valid, vcltq_f32(test, vdupq_n_f32(MIN_TRANSMITTANCE)));
+            done = vorrq_u32(done, saturated);
+            terminated = vorrq_u32(terminated, saturated);
+
+            const auto blended = vbicq_u32(valid, saturated);
+            const auto weight = vreinterpretq_f32_u32(vandq_u32(blended, vreinterpretq_u32_f32(vmulq_f32(alpha, T))));
+            r = vaddq_f32(r, vmulq_f32(vdupq_n_f32(splat.r), weight));
+            g = vaddq_f32(g, vmulq_f32(vdupq_n_f32(splat.g), weight));
+            b = vaddq_f32(b, vmulq_f32(vdupq_n_f32(splat.b), weight));
+            T = vbslq_f32(blended, test, T);
+        }
+
+        float channels[3][NEON_WIDTH];
+        vst1q_f32(channels[0], r);
+        vst1q_f32(channels[1], g);
+        vst1q_f32(channels[2], b);
+        for (uint32_t lane = 0; lane < laneCount; ++lane) {
+            rgb[lane * 3 + 0] = channels[0][lane];
+            rgb[lane * 3 + 1] = channels[1][lane];
+            rgb[lane * 3 + 2] = channels[2][lane];
+        }
+        return vaddvq_u32(vshrq_n_u32(terminated, 31));
+    }
+#endif // TPD_CPU_RASTER_NEON
+
+    struct KernelChoice {
+        BlendKernel kernel;
+        uint32_t width;
+        const char* name;
+    };
+
+    KernelChoice chooseKernel(const bool simd) noexcept {
+#ifdef TPD_CPU_RASTER_AVX2
+        if (simd && avx2Supported()) return { blendAvx2, AVX2_WIDTH, "avx2" };
+#endif
+#ifdef TPD_CPU_RASTER_NEON
+        if (simd) return { blendNeon, NEON_WIDTH, "neon" };
+#endif
+        return { blendScalar, SCALAR_WIDTH, "scalar" };
+    }
+
+    // Constants and layout of splat/common.slang
+    constexpr float SH_C0 = 0.28209479177387814f;
+    constexpr float SH_C1 = 0.4886025119029199f;
+    constexpr float SH_C2[] = { 1.0925484305920792f, -1.0925484305920792f, 0.31539156525252005f, -1.0925484305920792f, 0.5462742152960396f };
+    constexpr float SH_C3[] = {
+        -0.5900435899266435f, 2.890611442640554f, -0.4570457994644658f, 0.3731763325901154f,
+        -0.4570457994644658f, 1.445305721320277f, -0.5900435899266435f };
+    constexpr uint32_t EXTRA_SH_COEFFS = 15;
+
+    float getFeature(const std::array<float, tpd::GaussianPoint::MAX_SH_FLOATS>& sh, const uint32_t idx, const uint32_t channel) {
+        return sh[(idx - 1) + channel * EXTRA_SH_COEFFS + 3];
+    }
+
+    float evaluateSphericalHarmonics(
+        const std::array<float, tpd::GaussianPoint::MAX_SH_FLOATS>& sh, const float dir[3],
+        const uint32_t degree, const uint32_t c)
+    {
+        auto result = SH_C0 * sh[c]; // DC components are laid out contiguously
+        if (degree > 0) {
+            const auto x = dir[0];
+            const auto y = dir[1];
+            const auto z = dir[2];
+            result = result - SH_C1 * y * getFeature(sh, 1, c) + SH_C1 * z * getFeature(sh, 2, c) - SH_C1 * x * getFeature(sh, 3, c);
+
+            if (degree > 1) {
+                const auto xx = x * x, yy = y * y, zz = z * z;
+                const auto xy = x * y, yz = y * z, zx = z * x;
+                result = result +
+                    SH_C2[0] * xy * getFeature(sh, 4, c) +
+                    SH_C2[1] * yz * getFeature(sh, 5, c) +
+                    SH_C2[2] * (2.0f * zz - xx - yy) * getFeature(sh, 6, c) +
+                    SH_C2[3] * zx * getFeature(sh, 7, c) +
+                    SH_C2[4] * (xx - yy) * getFeature(sh, 8, c);
+
+                if (degree > 2) {
+                    result = result +
+                        SH_C3[0] * y * (3.0f * xx - yy) * getFeature(sh, 9, c) +
+                        SH_C3[1] * xy * z * getFeature(sh, 10, c) +
+                        SH_C3[2] * y * (4.0f * zz - xx - yy) * getFeature(sh, 11, c) +
+                        SH_C3[3] * z * (2.0f * zz - 3.0f * xx - 3.0f * yy) * getFeature(sh, 12, c) +
+                        SH_C3[4] * x * (4.0f * zz - xx - yy) * getFeature(sh, 13, c) +
+                        SH_C3[5] * z * (xx - yy) * getFeature(sh, 14, c) +
+                        SH_C3[6] * x * (xx - 3.0f * yy) * getFeature(sh, 15, c);
+                }
+            }
+        }
+        return std::max(result + 0.5f, 0.0f);
+    }
+
+    std::array<float, 4> transform(const tpd::mat4& m, const tpd::vec3& p) noexcept {
+        auto result = std::array<float, 4>{};
+        for (uint32_t row = 0; row < 4; ++row) {
+            result[row] = m[row, 0] * p.x + m[row, 1] * p.y + m[row, 2] * p.z + m[row, 3];
+        }
+        return result;
+    }
+
+    std::byte toUnorm8(const float value) noexcept {
+        // Written so that NaNs store as zero, as they do on the GPU
+        const auto clamped = value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+        return static_cast<std::byte>(std::lround(clamped * 255.0f));
+    }
+} // namespace
+
+tpd::CpuRasterizer::CpuRasterizer(const Settings& settings)
+    : _settings{ settings }
+    , _threadPool{ settings.workerCount }
+{
+    if (_settings.blockX == 0 || _settings.blockY == 0) [[unlikely]] {
+        throw std::invalid_argument("CpuRasterizer - Tiles must be at least one pixel wide and high");
+    }
+    _settings.sphericalHarmonicsDegree = std::min(_settings.sphericalHarmonicsDegree, 3u);
+    _simd = std::string_view{ chooseKernel(_settings.simdKernels).name } != "scalar";
+}
+
+const char* tpd::CpuRasterizer::getKernelName() const noexcept {
+    return chooseKernel(_simd).name;
+}
+
+tpd::CpuRasterizer::Frame tpd::CpuRasterizer::render(
+    const std::span<const GaussianPoint> points,
+    const tpd::Camera& camera,
+    const uint32_t width,
+    const uint32_t height,
+    const mat4& model)
+{
+    TPD_TRACE_ZONE("CpuRasterizer::render");
+    if (width == 0 || height == 0) [[unlikely]] {
+        throw std::invalid_argument("CpuRasterizer - Cannot render to an empty image");
+    }
+
+    // Camera data as GaussianEngine::updateCameraBuffer uploads it, see Camera of splat.slang
+    const auto& viewMatrix = camera.getViewMatrix();
+    const auto projection = mat4{ camera.getProjectionData() };
+
+    auto view = View{};
+    view.viewModel = math::mul(viewMatrix, model);
+    view.projModel = math::mul(math::mul(projection, viewMatrix), model);
+    view.focalX = 0.5f * static_cast<float>(width) * projection[0, 0];
+    view.focalY = 0.5f * static_cast<float>(height) * projection[1, 1];
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t col = 0; col < 3; ++col) {
+            view.viewRotation[row][col] = viewMatrix[row, col];
+        }
+    }
+    // The 4th column of the view matrix is -R^T * t
+    for (uint32_t i = 0; i < 3; ++i) {
+        view.cameraPosition[i] = -(viewMatrix[0, i] * viewMatrix[0, 3] + viewMatrix[1, i] * viewMatrix[1, 3] + viewMatrix[2, i] * viewMatrix[2, 3]);
+    }
+
+    auto frame = Frame{};
+    frame.extent = vk::Extent2D{ width, height };
+    frame.pixels.resize(std::size_t{ width } * height * 4);
+
+    // Project pass
+    _splats.resize(points.size());
+    auto visibleCount = std::atomic_uint32_t{ 0 };
+    {
+        TPD_TRACE_ZONE("CpuRasterizer::project");
+        const auto chunkCount = static_cast<uint32_t>((points.size() + PROJECT_CHUNK_SIZE - 1) / PROJECT_CHUNK_SIZE);
+        _threadPool.parallelFor(chunkCount, [&](const uint32_t chunk) {
+            const auto begin = chunk * PROJECT_CHUNK_SIZE;
+            const auto end = std::min(begin + PROJECT_CHUNK_SIZE, static_cast<uint32_t>(points.size()));
+            auto visible = 0u;
+            for (auto i = begin; i < end; ++i) {
+                visible += project(points[i], view, width, height, _splats[i]) ? 1 : 0;
+            }
+            visibleCount.fetch_add(visible, std::memory_order_relaxed);
+        });
+    }
+
+    // Keygen and sort, grouped by tile right away instead of sorting all keys at once
+    const auto gridX = (width + _settings.blockX - 1) / _settings.blockX;
+    const auto gridY = (height + _settings.blockY - 1) / _settings.blockY;
+    {
+        TPD_TRACE_ZONE("CpuRasterizer::binTiles");
+        binTiles(gridX, gridY);
+    }
+
+    // Blend pass, each tile sorts its own keys first
+    auto terminatedCount = std::atomic_uint32_t{ 0 };
+    {
+        TPD_TRACE_ZONE("CpuRasterizer::blend");
+        _threadPool.parallelFor(gridX * gridY, [&](const uint32_t tile) {
+            terminatedCount.fetch_add(blendTile(tile, gridX, frame), std::memory_order_relaxed);
+        });
+    }
+
+    auto& statistics = frame.statistics;
+    statistics.visibleGaussians = visibleCount.load();
+    statistics.tilesRendered = _tileOffsets.back();
+    statistics.earlyTerminatedPixels = terminatedCount.load();
+    for (uint32_t tile = 0; tile < gridX * gridY; ++tile) {
+        const auto splatCount = _tileOffsets[tile + 1] - _tileOffsets[tile];
+        statistics.activeTiles += splatCount > 0 ? 1 : 0;
+        statistics.maxSplatsPerTile = std::max(statistics.maxSplatsPerTile, splatCount);
+    }
+    statistics.meanSplatsPerTile = statistics.activeTiles > 0
+        ? static_cast<float>(statistics.tilesRendered) / static_cast<float>(statistics.activeTiles) : 0.0f;
+
+    return frame;
+}
+
+bool tpd::CpuRasterizer::project(
+    const GaussianPoint& point,
+    const View& view,
+    const uint32_t width,
+    const uint32_t height,
+    Splat& splat) const noexcept
+{
+    splat.tiles = 0;
+
+    // Frustum clipping, see passFrustumClipping
+    const auto [vx, vy, vz, vw] = transform(view.viewModel, point.position);
+    if (vz <= 0.0f) return false; // behind the camera
+
+    const auto clip = transform(view.projModel, point.position);
+    if (clip[0] < -1.3f * clip[3] || clip[0] > 1.3f * clip[3]) return false;
+    if (clip[1] < -1.3f * clip[3] || clip[1] > 1.3f * clip[3]) return false;
+    if (clip[2] < 0.0f || clip[2] > clip[3]) return false; // reversed z
+
+    const auto invW = 1.0f / clip[3];
+    const auto ndcX = clip[0] * invW;
+    const auto ndcY = clip[1] * invW;
+
+    // World space covariance from rotation and scale, see computeCovariance
+    const auto [qx, qy, qz, qw] = point.quaternion.data;
+    const float scale[3] = { point.scale.x * point.scale.w, point.scale.y * point.scale.w, point.scale.z * point.scale.w };
+    const float R[3][3] = {
+        { 1.0f - 2.0f * (qy * qy + qz * qz), 2.0f * (qx * qy - qw * qz), 2.0f * (qx * qz + qw * qy) },
+        { 2.0f * (qx * qy + qw * qz), 1.0f - 2.0f * (qx * qx + qz * qz), 2.0f * (qy * qz - qw * qx) },
+        { 2.0f * (qx * qz - qw * qy), 2.0f * (qy * qz + qw * qx), 1.0f - 2.0f * (qx * qx + qy * qy) },
+    };
+    float cov3D[3][3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        for (uint32_t j = 0; j < 3; ++j) {
+            cov3D[i][j] = 0.0f;
+            for (uint32_t k = 0; k < 3; ++k) cov3D[i][j] += R[i][k] * scale[k] * R[j][k] * scale[k];
+        }
+    }
+
+    // Image space covariance through the local affine approximation of the projection, see projectCovariance
+    const auto fx = view.focalX / vz;
+    const auto fy = view.focalY / vz;
+    const float J[2][3] = {
+        { fx, 0.0f, -fx * (vx / vz) },
+        { 0.0f, fy, -fy * (vy / vz) },
+    };
+    float T[2][3];
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < 3; ++j) {
+            T[i][j] = J[i][0] * view.viewRotation[0][j] + J[i][1] * view.viewRotation[1][j] + J[i][2] * view.viewRotation[2][j];
+        }
+    }
+    float cov2D[2][2];
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < 2; ++j) {
+            cov2D[i][j] = 0.0f;
+            for (uint32_t k = 0; k < 3; ++k) {
+                cov2D[i][j] += T[i][k] * (cov3D[k][0] * T[j][0] + cov3D[k][1] * T[j][1] + cov3D[k][2] * T[j][2]);
+            }
+        }
+    }
+
+    // Low-pass filter, then invert (EWA algorithm)
+    const auto covA = cov2D[0][0] + 0.3f;
+    const auto covB = cov2D[1][0];
+    const auto covC = cov2D[1][1] + 0.3f;
+    const auto det = covA * covC - covB * covB;
+    if (det == 0.0f) return true; // singular, though still counted as visible by the GPU
+    const auto detInv = 1.0f / det;
+
+    // Extent in pixels from the eigenvalues of the covariance
+    const auto mid = 0.5f * (covA + covC);
+    const auto lambda1 = mid + std::sqrt(std::max(0.1f, mid * mid - det));
+    const auto lambda2 = mid - std::sqrt(std::max(0.1f, mid * mid - det));
+    const auto radius = std::ceil(3.0f * std::sqrt(std::max(lambda1, lambda2)));
+
+    // Tiles overlapped by the bounding square, see ndc2pix and getBoundingRect
+    const auto x = ((ndcX + 1.0f) * static_cast<float>(width) - 1.0f) * 0.5f;
+    const auto y = ((ndcY + 1.0f) * static_cast<float>(height) - 1.0f) * 0.5f;
+    const auto gridX = static_cast<int>((width + _settings.blockX - 1) / _settings.blockX);
+    const auto gridY = static_cast<int>((height + _settings.blockY - 1) / _settings.blockY);
+    const auto blockX = static_cast<float>(_settings.blockX);
+    const auto blockY = static_cast<float>(_settings.blockY);
+    splat.rectMinX = static_cast<uint32_t>(std::clamp(static_cast<int>((x - radius) / blockX), 0, gridX));
+    splat.rectMinY = static_cast<uint32_t>(std::clamp(static_cast<int>((y - radius) / blockY), 0, gridY));
+    splat.rectMaxX = static_cast<uint32_t>(std::clamp(static_cast<int>((x + radius + blockX - 1.0f) / blockX), 0, gridX));
+    splat.rectMaxY = static_cast<uint32_t>(std::clamp(static_cast<int>((y + radius + blockY - 1.0f) / blockY), 0, gridY));
+    const auto tiles = (splat.rectMaxX - splat.rectMinX) * (splat.rectMaxY - splat.rectMinY);
+    if (tiles == 0) return true;
+
+    // View dependent color, the direction is taken from the untransformed position as the GPU does
+    auto direction = std::array{
+        point.position.x - view.cameraPosition[0],
+        point.position.y - view.cameraPosition[1],
+        point.position.z - view.cameraPosition[2] };
+    const auto length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    std::ranges::for_each(direction, [length](float& d) { d /= length; });
+
+    splat.x = x;
+    splat.y = y;
+    splat.depth = vz;
+    splat.conicA = covC * detInv;
+    splat.conicB = -covB * detInv;
+    splat.conicC = covA * detInv;
+    splat.opacity = point.opacity;
+    splat.r = evaluateSphericalHarmonics(point.sh, direction.data(), _settings.sphericalHarmonicsDegree, 0);
+    splat.g = evaluateSphericalHarmonics(point.sh, direction.data(), _settings.sphericalHarmonicsDegree, 1);
+    splat.b = evaluateSphericalHarmonics(point.sh, direction.data(), _settings.sphericalHarmonicsDegree, 2);
+    splat.tiles = tiles;
+    return true;
+}
+
+void tpd::CpuRasterizer::binTiles(const uint32_t gridX, const uint32_t gridY) {
+    // Count splats per tile, then scan in place into offsets
+    _tileOffsets.assign(gridX * gridY + 1, 0);
+    for (const auto& splat : _splats) {
+        if (splat.tiles == 0) continue;
+        for (auto y = splat.rectMinY; y < splat.rectMaxY; ++y) {
+            for (auto x = splat.rectMinX; x < splat.rectMaxX; ++x) {
+                ++_tileOffsets[y * gridX + x + 1];
+            }
+        }
+    }
+    std::inclusive_scan(_tileOffsets.begin(), _tileOffsets.end(), _tileOffsets.begin());
+
+    // Keys are emitted in splat order, depth bits first, so that sorting them within a tile orders splats exactly as
+    // the stable radix sort of the GPU does
+    _tileKeys.resize(_tileOffsets.back());
+    auto cursors = std::vector(_tileOffsets.begin(), _tileOffsets.end() - 1);
+    for (uint32_t i = 0; i < _splats.size(); ++i) {
+        const auto& splat = _splats[i];
+        if (splat.tiles == 0) continue;
+        const auto key = uint64_t{ std::bit_cast<uint32_t>(splat.depth) } << 32 | i;
+        for (auto y = splat.rectMinY; y < splat.rectMaxY; ++y) {
+            for (auto x = splat.rectMinX; x < splat.rectMaxX; ++x) {
+                _tileKeys[cursors[y * gridX + x]++] = key;
+            }
+        }
+    }
+}
+
+uint32_t tpd::CpuRasterizer::blendTile(const uint32_t tile, const uint32_t gridX, Frame& frame) {
+    const auto keys = std::span{ _tileKeys }.subspan(_tileOffsets[tile], _tileOffsets[tile + 1] - _tileOffsets[tile]);
+    std::ranges::sort(keys);
+
+    // Splats of the tile in blending order, compact enough to stay in cache while every row walks through them
+    thread_local auto blendSplats = std::vector<BlendSplat>{};
+    blendSplats.clear();
+    for (const auto key : keys) {
+        const auto& splat = _splats[static_cast<uint32_t>(key)];
+        blendSplats.push_back({ splat.x, splat.y, splat.conicA, splat.conicB, splat.conicC, splat.opacity, splat.r, splat.g, splat.b });
+    }
+
+    const auto [kernel, kernelWidth, name] = chooseKernel(_simd);
+    const auto [width, height] = frame.extent;
+    const auto x0 = tile % gridX * _settings.blockX;
+    const auto y0 = tile / gridX * _settings.blockY;
+    const auto x1 = std::min(x0 + _settings.blockX, width);
+    const auto y1 = std::min(y0 + _settings.blockY, height);
+
+    auto terminatedCount = 0u;
+    float rgb[SCALAR_WIDTH * 3];
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; x += kernelWidth) {
+            const auto laneCount = std::min(kernelWidth, x1 - x);
+            terminatedCount += kernel(blendSplats.data(), static_cast<uint32_t>(blendSplats.size()), x, y, laneCount, rgb);
+
+            auto pixel = frame.pixels.begin() + (std::size_t{ y } * width + x) * 4;
+            for (uint32_t lane = 0; lane < laneCount; ++lane) {
+                *pixel++ = toUnorm8(rgb[lane * 3 + 0]);
+                *pixel++ = toUnorm8(rgb[lane * 3 + 1]);
+                *pixel++ = toUnorm8(rgb[lane * 3 + 2]);
+                *pixel++ = std::byte{ 0xFF };
+            }
+        }
+    }
+    return terminatedCount;
+}
@@ -2,12 +2,51 @@
 #include "torpedo/volumetric/GaussianGeometry.h"
 
 #include <torpedo/bootstrap/DeviceBuilder.h>
+#include <torpedo/bootstrap/PipelineCacheBuilder.h>
 #include <torpedo/bootstrap/ShaderModuleBuilder.h>
 #include <torpedo/bootstrap/PhysicalDeviceSelector.h>
 
+#include <torpedo/foundation/FrameTracer.h>
+
+#include <torpedo/rendering/HeadlessRenderer.h>
+
 #include <plog/Log.h>
 
-#include <filesystem>
+#include <torpedo_volumetric_spirv.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <numbers>
+#include <numeric>
+#include <utility>
+
+namespace {
+    // Fixed perspective with a vertical FOV of 60 degrees, only used to render the synthetic scene when autotuning
+    class TuningCamera final : public tpd::Camera {
+    public:
+        TuningCamera(const uint32_t imageWidth, const uint32_t imageHeight) {
+            constexpr auto fy = std::numbers::sqrt3_v<float>;
+            const auto fx = fy * static_cast<float>(imageHeight) / static_cast<float>(imageWidth);
+            const auto za = _near / (_near - _far);
+            const auto zb = _near * _far / (_far - _near);
+            _projection = {
+                fx,  0.f, 0.f, 0.f,
+                0.f, fy,  0.f, 0.f,
+                0.f, 0.f, za,  zb,
+                0.f, 0.f, 1.f, 0.f,
+            };
+        }
+
+        [[nodiscard]] const float* getProjectionData() const noexcept override { return _projection.data_ptr(); }
+        [[nodiscard]] uint32_t getProjectionByteSize() const noexcept override { return sizeof(float) * 16; }
+
+    private:
+        tpd::mat4 _projection{};
+    };
+} // namespace
 
 tpd::PhysicalDeviceSelection tpd::GaussianEngine::pickPhysicalDevice(
     const std::vector<const char*>& deviceExtensions,
@@ -43,8 +82,8 @@ vk::Device tpd::GaussianEngine::createDevice(
     // Remember to update the count number at the end of the first message should more features are added
     PLOGD << "Device features requested by " << getName() << " (3):";
     PLOGD << " - Features: shaderInt64";
-    PLOGD << " - Vulkan12Features: shaderBufferInt64Atomics, runtimeDescriptorArray";
-    PLOGD << " - Vulkan13Features: synchronization2, maintenance4";
+    PLOGD << " - Vulkan12Features: shaderBufferInt64Atomics, runtimeDescriptorArray, bufferDeviceAddress, timelineSemaphore";
+    PLOGD << " - Vulkan13Features: synchronization2, maintenance4, computeFullSubgroups";
 
     return DeviceBuilder()
         .deviceFeatures(&deviceFeatures)
@@ -62,6 +101,8 @@ vk::PhysicalDeviceVulkan12Features tpd::GaussianEngine::getVulkan12Features() {
     auto features = vk::PhysicalDeviceVulkan12Features{};
     features.runtimeDescriptorArray = true;
     features.shaderBufferInt64Atomics = true;
+    features.bufferDeviceAddress = true; // sort and range buffers are accessed through pointers, see SortBuffers
+    features.timelineSemaphore = true;   // TransferWorker tracks submissions of each queue with a timeline
     return features;
 }
 
@@ -69,6 +110,7 @@ vk::PhysicalDeviceVulkan13Features tpd::GaussianEngine::getVulkan13Features() {
     auto features = vk::PhysicalDeviceVulkan13Features();
     features.synchronization2 = true;
     features.maintenance4 = true;
+    features.computeFullSubgroups = true; // mandatory in 1.3, required by the subgroup scan and sort kernels
     return features;
 }
 
@@ -78,7 +120,8 @@ void tpd::GaussianEngine::onInitialized() {
 
     // We're going to need a transfer worker for data transfer
     _transferWorker = std::make_unique<TransferWorker>(
-        _transferFamilyIndex, _graphicsFamilyIndex, _computeFamilyIndex, _physicalDevice, _device, _vmaAllocator);
+        _transferFamilyIndex, _graphicsFamilyIndex, _computeFamilyIndex, _physicalDevice, _device, _vmaAllocator,
+        TransferWorker::DEFAULT_STAGING_RING_SIZE, _queueArbiter);
 
 #ifndef NDEBUG
     const auto func = __FUNCTION__;
@@ -108,25 +151,42 @@ void tpd::GaussianEngine::onInitialized() {
     auto properties = vk::PhysicalDeviceProperties2{};
     properties.pNext = &subgroupProperties;
     _physicalDevice.getProperties2(&properties);
-    const auto subgroupSize = subgroupProperties.subgroupSize;
-    PLOGD << "GaussianEngine - Subgroup size: " << subgroupSize;
+    _subgroupSize = subgroupProperties.subgroupSize;
+    PLOGD << "GaussianEngine - Subgroup size: " << _subgroupSize;
+
+    // Launch parameters are baked into the pipelines and decide the tile grid, so they must be known from here on
+    loadKernelTuning();
 
     createGaussianLayout();
-    _projectPipeline = createPipeline("project.slang", _gaussianLayout, subgroupSize);
-    _prefixPipeline  = createPipeline("prefix.slang", _gaussianLayout, subgroupSize);
-    _keygenPipeline  = createPipeline("keygen.slang", _gaussianLayout, subgroupSize);
-    _radixShufflePipeline = createPipeline("radix-shuffle.slang", _gaussianLayout, subgroupSize);
-    _radixPrefixAPipeline = createPipeline("radix-prefixA.slang", _gaussianLayout, subgroupSize);
-    _radixPrefixBPipeline = createPipeline("radix-prefixB.slang", _gaussianLayout, subgroupSize);
-    _radixMappingPipeline = createPipeline("radix-mapping.slang", _gaussianLayout, subgroupSize);
-    _rangePipeline = createPipeline("range.slang", _gaussianLayout, subgroupSize);
-    _blendPipeline = createPipeline("blend.slang", _gaussianLayout, subgroupSize);
+    createPipelineCache();
+
+    // The tile prefix scan and the key sort are generic primitives with pipelines of their own, created ahead of
+    // the others so that they make it into the cache saved by createPipelines
+    const auto subgroupKernels = GpuRadixSort::subgroupSupported(_physicalDevice);
+    PLOGD << "GaussianEngine - Subgroup scan and sort kernels: " << (subgroupKernels ? "enabled" : "disabled");
+    _tileScan = GpuPrefixScan::Builder()
+        .pipelineCache(_pipelineCache)
+        .subgroupKernels(subgroupKernels)
+        .build(_device);
+    _keySort = GpuRadixSort::Builder()
+        .keyType(GpuRadixSort::KeyType::Uint64)
+        .pipelineCache(_pipelineCache)
+        .subgroupKernels(subgroupKernels)
+        .build(_device);
+
+    const auto suffix = std::string{ _halfPrecisionSplats ? "-packed.slang" : ".slang" };
+    createPipelines({
+        { &_projectPipeline, "project" + suffix },
+        { &_keygenPipeline,  "keygen" + suffix },
+        { &_rangePipeline,   "range.slang" },
+        { &_blendPipeline,   "blend" + suffix },
+    });
 
     const auto frameCount = _renderer->getInFlightFrameCount();
     const auto [w, h] = _renderer->getFramebufferSize();
 
-    // The logic for resizing frame and target view vectors should be made once here
-    // since they can be recreated later and should not be resized again
+    // The logic for resizing frame and target view vectors should be made once here since they can be
+    // recreated later and should not be resized again, except for appending views, see createViews
     _frames.reserve(frameCount);
     _frames.resize(frameCount);
     _targetViews.resize(frameCount);
@@ -134,39 +194,22 @@ void tpd::GaussianEngine::onInitialized() {
     createFrames();
     createRenderTargets(w, h);
     createCameraBuffer();
-    createRangeBuffers(w, h);
     updateRadixPassCount(w, h);
 
-    // These buffers are frame-dependent and the vectors should be resized once here
-    // since they can be reallocated later and should not be resized again
-    _splatKeyBuffers.resize(frameCount);
-    _splatIndexBuffers.resize(frameCount);
-    _tempKeyBuffers.resize(frameCount);
-    _tempValBuffers.resize(frameCount);
-    _globalPrefixABuffers.resize(frameCount);
-    _globalPrefixBBuffers.resize(frameCount);
-    _blockCountABuffers.resize(frameCount);
-    _blockCountBBuffers.resize(frameCount);
-    _blockDescriptorABuffers.resize(frameCount);
-    _blockDescriptorBBuffers.resize(frameCount);
-    _globalSumBuffers.resize(frameCount);
- 
-    // These buffers are going to be created with size 1 which is going to be reallocated later during rendering
-    // Though as redundant as it may seem, this avoids crashing when the render is launched with 0 Gaussian points
-    for (auto i = 0; i < frameCount; ++i) {
-        createSplatKeyBuffers(i);
-        createSplatIndexBuffers(i);
-        createGlobalPrefixBuffers(i);
-        createTempKeyBuffers(i);
-        createTempValBuffers(i);
-        createBlockDescriptorBuffers(i);
-    }
+    // These buffers are frame-dependent and the vectors should be resized once here since they can be
+    // reallocated later and should not be resized again, except for appending views, see createViews
+    _statsBuffers.resize(frameCount);
+    _workloadBuffers.resize(frameCount);
+    _sortDispatchBuffers.resize(frameCount);
 
     // These buffers exist independently of the number of Gaussians and tiles rendered
     createTilesRenderedBuffer();
-    createPartitionCountBuffer();
-    createBlockCountBuffers();
-    createGlobalSumBuffers();
+    createStatisticsBuffers();
+    createSortDispatchBuffers();
+
+    // Sort buffers are created with a capacity of 1 which is going to be reallocated later during rendering.
+    // Though as redundant as it may seem, this avoids crashing when the render is launched with 0 Gaussian points
+    createBlendGraph();
 }
 
 void tpd::GaussianEngine::logDebugInfos() const noexcept {
@@ -196,11 +239,6 @@ void tpd::GaussianEngine::logDebugInfos() const noexcept {
     PLOGD << "Uniform buffer limits:";
     PLOGD << " - Max range: " << limits.maxUniformBufferRange / 1024 << "KB";
     PLOGD << " - Min align: " << limits.minUniformBufferOffsetAlignment << "B";
-
-    // Assets directories
-    const auto assetsDir = std::filesystem::path(TORPEDO_VOLUMETRIC_ASSETS_DIR).make_preferred();
-    PLOGD << "Assets directories used by " << getName() << ':';
-    PLOGD << " - " << assetsDir / "gaussian";
 }
 
 void tpd::GaussianEngine::framebufferResizeCallback(void* ptr, const uint32_t width, const uint32_t height) {
@@ -212,11 +250,12 @@ void tpd::GaussianEngine::onFramebufferResize(const uint32_t width, const uint32
     PLOGD << "GaussianEngine - Recreating render targets and range buffers";
     cleanupRenderTargets();
     createRenderTargets(width, height);
-    createRangeBuffers(width, height);
-    PLOGD << "GaussianEngine - Render targets and range buffers reallocated";
+    if (_collectStats) createWorkloadBuffers(width, height);
 
-    // Update the total number of radix sort passes needed
+    // Update the total number of radix sort passes needed, then rebuild the graph with ranges of the new size
     updateRadixPassCount(width, height);
+    createBlendGraph();
+    PLOGD << "GaussianEngine - Render targets and range buffers reallocated";
 }
 
 void tpd::GaussianEngine::createDrawingCommandPool() {
@@ -238,26 +277,12 @@ void tpd::GaussianEngine::createGaussianLayout() {
     using enum vk::ShaderStageFlagBits;
 
     _shaderLayout = ShaderLayout<DESCRIPTOR_SET_COUNT>::Builder()
-        .pushConstantRange(eCompute, 0, sizeof(PointCloud) + sizeof(uint32_t) + sizeof(uint32_t))
+        .pushConstantRange(eCompute, 0, sizeof(PointCloud) + sizeof(SortBuffers)) // see RasterInfo
         .descriptor(0, 0, eStorageImage,  1, eCompute) // output image
         .descriptor(0, 1, eUniformBuffer, 1, eCompute) // camera
         .descriptor(0, 2, eStorageBuffer, 1, eCompute) // gaussians
         .descriptor(0, 3, eStorageBuffer, 1, eCompute) // splats
-        .descriptor(0, 4, eStorageBuffer, 1, eCompute) // tiles rendered
-        .descriptor(0, 5, eStorageBuffer, 1, eCompute) // partition count
-        .descriptor(0, 6, eStorageBuffer, 1, eCompute) // partition descriptors
-        .descriptor(0, 7, eStorageBuffer, 1, eCompute) // splat keys
-        .descriptor(0, 8, eStorageBuffer, 1, eCompute) // splat indices
-        .descriptor(0, 9, eStorageBuffer, 1, eCompute) // global prefix A
-        .descriptor(0,10, eStorageBuffer, 1, eCompute) // global prefix B
-        .descriptor(0,11, eStorageBuffer, 1, eCompute) // temp keys
-        .descriptor(0,12, eStorageBuffer, 1, eCompute) // temp vals
-        .descriptor(0,13, eStorageBuffer, 1, eCompute) // block count A
-        .descriptor(0,14, eStorageBuffer, 1, eCompute) // block descriptor A
-        .descriptor(0,15, eStorageBuffer, 1, eCompute) // block count B
-        .descriptor(0,16, eStorageBuffer, 1, eCompute) // block descriptor B
-        .descriptor(0,17, eStorageBuffer, 1, eCompute) // global sums
-        .descriptor(0,18, eStorageBuffer, 1, eCompute) // ranges
+        .descriptor(0,19, eStorageBuffer, 1, eCompute) // frame statistics
         .descriptor(1, 0, eStorageBuffer, 1, eCompute) // transform handles
         .descriptor(1, 1, eStorageBuffer, 1, eCompute) // transform indices
         .descriptor(2, 0, eUniformBuffer, 1, eCompute) // bindless transforms
@@ -267,17 +292,36 @@ void tpd::GaussianEngine::createGaussianLayout() {
 vk::Pipeline tpd::GaussianEngine::createPipeline(
     const std::string& slangFile,
     const vk::PipelineLayout layout,
-    const uint32_t subgroupSize) const 
+    const KernelTuning& tuning,
+    const bool collectStats,
+    vk::PipelineCreationFeedback* const feedback) const
 {
+    // SPIR-V code is embedded in the library at build time, see torpedo_compile_slang
     const auto shaderModule = ShaderModuleBuilder()
-        .spirvPath(std::filesystem::path(TORPEDO_VOLUMETRIC_ASSETS_DIR) / "gaussian" / (slangFile + ".spv"))
+        .spirvCode(spirv::volumetric(slangFile))
         .build(_device);
 
-    constexpr auto constantEntry = vk::SpecializationMapEntry{ 0, 0, sizeof(uint32_t) };
+    // Shaders not declaring a constant simply ignore its entry
+    struct SpecializationData {
+        uint32_t projectThreads; // constant_id 0
+        vk::Bool32 collectStats; // constant_id 1
+        uint32_t workgroupSize;  // constant_id 2
+        uint32_t blockX;         // constant_id 3
+        uint32_t blockY;         // constant_id 4
+    };
+    const auto data = SpecializationData{
+        tuning.getProjectThreads(), collectStats, tuning.workgroupSize, tuning.blockX, tuning.blockY };
+    constexpr auto constantEntries = std::array{
+        vk::SpecializationMapEntry{ 0, offsetof(SpecializationData, projectThreads), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 1, offsetof(SpecializationData, collectStats), sizeof(vk::Bool32) },
+        vk::SpecializationMapEntry{ 2, offsetof(SpecializationData, workgroupSize), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 3, offsetof(SpecializationData, blockX), sizeof(uint32_t) },
+        vk::SpecializationMapEntry{ 4, offsetof(SpecializationData, blockY), sizeof(uint32_t) },
+    };
     const auto specializationInfo = vk::SpecializationInfo{}
-        .setMapEntries(constantEntry)
-        .setDataSize(sizeof(uint32_t))
-        .setPData(&subgroupSize);
+        .setMapEntries(constantEntries)
+        .setDataSize(sizeof(SpecializationData))
+        .setPData(&data);
 
     const auto shaderStage = vk::PipelineShaderStageCreateInfo{}
         .setModule(shaderModule)
@@ -285,26 +329,331 @@ vk::Pipeline tpd::GaussianEngine::createPipeline(
         .setPSpecializationInfo(&specializationInfo)
         .setPName("main");
 
+    // Creation feedback is core in Vulkan 1.3, it tells whether the driver found the pipeline in the cache
+    const auto feedbackInfo = vk::PipelineCreationFeedbackCreateInfo{}.setPPipelineCreationFeedback(feedback);
     const auto pipelineInfo = vk::ComputePipelineCreateInfo{}
+        .setPNext(feedback ? &feedbackInfo : nullptr)
         .setStage(shaderStage)
         .setLayout(layout);
-    const auto pipeline = _device.createComputePipeline(nullptr, pipelineInfo).value;
 
-    _device.destroyShaderModule(shaderModule);
-    return pipeline;
+    try {
+        const auto pipeline = _device.createComputePipeline(_pipelineCache, pipelineInfo).value;
+        _device.destroyShaderModule(shaderModule);
+        return pipeline;
+    } catch (...) {
+        _device.destroyShaderModule(shaderModule);
+        throw;
+    }
+}
+
+void tpd::GaussianEngine::createPipelines(const std::vector<std::pair<vk::Pipeline*, std::string>>& pipelines) {
+    using Clock = std::chrono::steady_clock;
+    using Millis = std::chrono::duration<float, std::milli>;
+    const auto start = Clock::now();
+
+    // Pipeline creation is free-threaded and the pipeline cache is internally synchronized,
+    // so we let the driver compile all pipelines concurrently, each on its own thread
+    auto durations = std::vector<Millis>(pipelines.size());
+    auto feedbacks = std::vector<vk::PipelineCreationFeedback>(pipelines.size());
+    auto futures = std::vector<std::future<vk::Pipeline>>{};
+    futures.reserve(pipelines.size());
+
+    for (std::size_t i = 0; i < pipelines.size(); ++i) {
+        const auto& slangFile = pipelines[i].second;
+        futures.push_back(std::async(std::launch::async, [this, &slangFile, &duration = durations[i], &feedback = feedbacks[i]] {
+            const auto begin = Clock::now();
+            const auto pipeline = createPipeline(slangFile, _gaussianLayout, _tuning, _collectStats, &feedback);
+            duration = Clock::now() - begin;
+            return pipeline;
+        }));
+    }
+
+    // Every future must be drained before rethrowing, the threads still reference the durations and feedbacks,
+    // and the pipelines created by the other threads would leak
+    auto created = std::vector<vk::Pipeline>(pipelines.size());
+    auto exception = std::exception_ptr{};
+    for (std::size_t i = 0; i < pipelines.size(); ++i) {
+        try {
+            created[i] = futures[i].get();
+        } catch (...) {
+            if (!exception) exception = std::current_exception();
+        }
+    }
+    if (exception) {
+        for (const auto pipeline : created) {
+            _device.destroyPipeline(pipeline);
+        }
+        std::rethrow_exception(exception);
+    }
+    for (std::size_t i = 0; i < pipelines.size(); ++i) {
+        *pipelines[i].first = created[i];
+    }
+
+    // Per-thread durations only tell how much the threads overlapped, a cache hit shortens both figures alike
+    const auto elapsed = Millis{ Clock::now() - start }.count();
+    const auto serial = std::accumulate(durations.begin(), durations.end(), Millis{}).count();
+    PLOGD << "GaussianEngine - Created " << pipelines.size() << " pipelines in " << elapsed << "ms in parallel, "
+          << serial << "ms summed over threads";
+
+    using enum vk::PipelineCreationFeedbackFlagBits;
+    const auto reported = std::ranges::count_if(feedbacks, [](const auto& feedback) { return bool(feedback.flags & eValid); });
+    const auto cacheHits = std::ranges::count_if(feedbacks, [](const auto& feedback) {
+        return bool(feedback.flags & eValid) && bool(feedback.flags & eApplicationPipelineCacheHit);
+    });
+    if (reported > 0) {
+        PLOGD << "GaussianEngine - Pipeline cache hits: " << cacheHits << " of " << reported << " pipelines reported";
+    }
+
+    // Persist what the driver has compiled so that the next launch can skip compilation
+    savePipelineCache();
 }
 
-void tpd::GaussianEngine::createFrames() {
+void tpd::GaussianEngine::createSplatPipelines() {
+    // Passes reading or writing the splat buffer have a variant for each splat layout
+    const auto suffix = std::string{ _halfPrecisionSplats ? "-packed.slang" : ".slang" };
+    createPipelines({
+        { &_projectPipeline, "project" + suffix },
+        { &_keygenPipeline,  "keygen" + suffix },
+        { &_blendPipeline,   "blend" + suffix },
+    });
+}
+
+void tpd::GaussianEngine::destroySplatPipelines() const noexcept {
+    _device.destroyPipeline(_blendPipeline);
+    _device.destroyPipeline(_keygenPipeline);
+    _device.destroyPipeline(_projectPipeline);
+}
+
+void tpd::GaussianEngine::createProfilers() {
+    if (!TimestampProfiler::supported(_physicalDevice, _computeFamilyIndex)) [[unlikely]] {
+        PLOGW << "GaussianEngine - The compute queue does NOT support timestamps, GPU profiling remains disabled";
+        return;
+    }
+
+    const auto frameCount = _renderer->getInFlightFrameCount();
+    _passProfiler = TimestampProfiler::Builder()
+        .stage("project")
+        .stage("prefix")
+        .stage("keygen")
+        .stage("radix-shuffle", MAX_RADIX_PASSES)
+        .stage("radix-prefix", MAX_RADIX_PASSES)
+        .stage("radix-mapping", MAX_RADIX_PASSES)
+        .stage("range")
+        .stage("blend")
+        .frameCount(frameCount)
+        .traceTrack("gpu-compute")
+        .build(_physicalDevice, _device);
+
+    // Place GPU timings on the same timeline as host zones, calibration submits on its own
+    const auto computePool = asyncCompute() ? _computeCommandPool : _drawingCommandPool;
+    calibrateProfiler(_passProfiler, asyncCompute() ? _computeQueue : _graphicsQueue, computePool);
+
+    if (_renderer->supportSurfaceRendering() && TimestampProfiler::supported(_physicalDevice, _graphicsFamilyIndex)) {
+        _copyProfiler = TimestampProfiler::Builder()
+            .stage("target-copy")
+            .frameCount(frameCount)
+            .traceTrack("gpu-graphics")
+            .build(_physicalDevice, _device);
+        calibrateProfiler(_copyProfiler, _graphicsQueue, _drawingCommandPool);
+    }
+}
+
+void tpd::GaussianEngine::calibrateProfiler(TimestampProfiler& profiler, const vk::Queue queue, const vk::CommandPool pool) const {
+    if (_queueArbiter) {
+        _queueArbiter->exclusive([&] { profiler.calibrate(_device, queue, pool); });
+    } else {
+        profiler.calibrate(_device, queue, pool);
+    }
+}
+
+void tpd::GaussianEngine::destroyProfilers() noexcept {
+    _copyProfiler.destroy(_device);
+    _passProfiler.destroy(_device);
+}
+
+bool tpd::GaussianEngine::timingPasses() const noexcept {
+    // Queries only exist for frames in flight, views of rasterFrames go untimed
+    return _passProfiler.valid() && _recordingFrame < _renderer->getInFlightFrameCount();
+}
+
+void tpd::GaussianEngine::recordPassBegin(const vk::CommandBuffer cmd, const Pass pass, const uint32_t instance) const noexcept {
+    if (timingPasses()) [[unlikely]] {
+        _passProfiler.recordBegin(cmd, _recordingFrame, std::to_underlying(pass), instance);
+    }
+}
+
+void tpd::GaussianEngine::recordPassEnd(const vk::CommandBuffer cmd, const Pass pass, const uint32_t instance) const noexcept {
+    if (timingPasses()) [[unlikely]] {
+        _passProfiler.recordEnd(cmd, _recordingFrame, std::to_underlying(pass), instance);
+    }
+}
+
+std::vector<tpd::TimestampProfiler::Stats> tpd::GaussianEngine::getPassTimings() const {
+    auto timings = std::vector<TimestampProfiler::Stats>{};
+    for (uint32_t i = 0; i < _passProfiler.getStageCount(); ++i) timings.push_back(_passProfiler.getStats(i));
+    for (uint32_t i = 0; i < _copyProfiler.getStageCount(); ++i) timings.push_back(_copyProfiler.getStats(i));
+    return timings;
+}
+
+void tpd::GaussianEngine::createPipelineCache() {
+    // Engines sharing a device compile into the same cache, only the first one loads it from disk
+    if (_sharedDevice && _sharedDevice->getPipelineCache()) {
+        _pipelineCache = _sharedDevice->getPipelineCache();
+        PLOGD << "GaussianEngine - Pipeline cache: shared with other engines";
+        return;
+    }
+
+    auto cacheFile = utils::getPipelineCacheFile(getPipelineCacheDirectory(), _physicalDevice);
+    _pipelineCache = PipelineCacheBuilder()
+        .cacheDirectory(getPipelineCacheDirectory())
+        .build(_physicalDevice, _device);
+    if (_sharedDevice) {
+        _sharedDevice->setPipelineCache(_pipelineCache);
+    }
+
+    const auto cacheSize = _device.getPipelineCacheData(_pipelineCache).size();
+    PLOGD << "GaussianEngine - Pipeline cache: " << cacheFile.make_preferred() << " (" << cacheSize / 1024 << "KB)";
+}
+
+void tpd::GaussianEngine::savePipelineCache() const {
+    if (!utils::savePipelineCache(_pipelineCache, getPipelineCacheDirectory(), _physicalDevice, _device)) {
+        PLOGW << "GaussianEngine - Could NOT write the pipeline cache to: " << getPipelineCacheDirectory();
+    }
+}
+
+std::filesystem::path tpd::GaussianEngine::getPipelineCacheDirectory() {
+    return std::filesystem::temp_directory_path() / "torpedo" / "pipeline-cache";
+}
+
+void tpd::GaussianEngine::loadKernelTuning() {
+    const auto limits = _physicalDevice.getProperties().limits;
+    _tuning = KernelTuning::getDefault(_subgroupSize);
+
+    // Tuning files may come from an older build with different kernels, only keep them if they still make sense
+    if (const auto tuning = utils::loadKernelTuning(getKernelTuningDirectory(), _physicalDevice); tuning && tuning->supported(limits)) {
+        _tuning = *tuning;
+        _kernelsTuned = true;
+    }
+
+    PLOGD << "GaussianEngine - Kernel tuning (" << (_kernelsTuned ? "tuned" : "default") << "): workgroup size "
+          << _tuning.workgroupSize << ", " << _tuning.itemsPerThread << " items per thread, "
+          << _tuning.blockX << "x" << _tuning.blockY << " tiles";
+}
+
+void tpd::GaussianEngine::autotune(const Settings& settings) {
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<float>;
+    const auto start = Clock::now();
+
+    // A dense cloud filling most of the image, going through the same compilation path as any other scene
+    const auto points = GaussianPoint::random(TUNING_GAUSSIAN_COUNT, 1.0f, { 0.0f, 0.0f, 0.0f }, 0.005f, 0.05f);
+    auto scene = Scene{};
+    scene.add(ent::group(points));
+
+    auto tuningSettings = settings;
+    tuningSettings.autotune = false;
+    compile(scene, tuningSettings);
+
+    const auto [w, h] = _renderer->getFramebufferSize();
+    auto camera = TuningCamera{ w, h };
+    camera.lookAt({ 0.0f, 0.0f, -2.5f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+    // Search one group of parameters at a time instead of their full product: tile sizes drive the blend pass, which
+    // dominates the frame, while the workgroup size and items per thread drive the passes before sorting
+    constexpr auto tileSizes = std::array{ std::pair{ 8u, 8u }, std::pair{ 16u, 8u }, std::pair{ 16u, 16u }, std::pair{ 32u, 16u } };
+    constexpr auto workgroupSizes = std::array{ 128u, 256u, 512u };
+    constexpr auto itemsPerThread = std::array{ 1u, 2u, 4u, 8u };
+
+    const auto limits = _physicalDevice.getProperties().limits;
+    auto best = _tuning;
+    auto bestTime = measureFrameTime(camera);
+
+    const auto tryCandidate = [&](const KernelTuning& candidate) {
+        if (candidate == best || !candidate.supported(limits)) return;
+        applyKernelTuning(candidate);
+        if (const auto time = measureFrameTime(camera); time < bestTime) {
+            best = candidate;
+            bestTime = time;
+        }
+    };
+
+    for (const auto [blockX, blockY] : tileSizes) {
+        auto candidate = best;
+        candidate.blockX = blockX;
+        candidate.blockY = blockY;
+        tryCandidate(candidate);
+    }
+    for (const auto workgroupSize : workgroupSizes) {
+        for (const auto items : itemsPerThread) {
+            auto candidate = best;
+            candidate.workgroupSize = workgroupSize;
+            candidate.itemsPerThread = items;
+            tryCandidate(candidate);
+        }
+    }
+
+    if (best != _tuning) {
+        applyKernelTuning(best);
+    }
+    _kernelsTuned = true;
+
+    if (!utils::saveKernelTuning(_tuning, getKernelTuningDirectory(), _physicalDevice)) {
+        PLOGW << "GaussianEngine - Could NOT write the kernel tuning to: " << getKernelTuningDirectory();
+    }
+    PLOGD << "GaussianEngine - Autotuned in " << Seconds{ Clock::now() - start }.count() << "s: workgroup size "
+          << _tuning.workgroupSize << ", " << _tuning.itemsPerThread << " items per thread, "
+          << _tuning.blockX << "x" << _tuning.blockY << " tiles (" << bestTime << "ms per frame)";
+}
+
+void tpd::GaussianEngine::applyKernelTuning(const KernelTuning& tuning) {
+    waitIdle();
+    destroySplatPipelines();
+    _tuning = tuning;
+    createSplatPipelines();
+
+    // The tile size decides the range buffer, the workload buffers, and the number of bits to sort
+    const auto [w, h] = _renderer->getFramebufferSize();
+    if (_collectStats) createWorkloadBuffers(w, h);
+    updateRadixPassCount(w, h);
+    createBlendGraph();
+}
+
+float tpd::GaussianEngine::measureFrameTime(const Camera& camera) {
+    using Clock = std::chrono::steady_clock;
+    using Millis = std::chrono::duration<float, std::milli>;
+
+    // Warm-up frames also settle the sort capacity, so that no reallocation happens while measuring
+    for (uint32_t i = 0; i < TUNING_WARMUP_FRAMES; ++i) rasterFrame(camera, false);
+    waitIdle();
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < TUNING_FRAMES; ++i) rasterFrame(camera, false);
+    waitIdle();
+    const auto frameTime = Millis{ Clock::now() - start }.count() / TUNING_FRAMES;
+
+    PLOGD << " - " << _tuning.workgroupSize << "/" << _tuning.itemsPerThread << ", "
+          << _tuning.blockX << "x" << _tuning.blockY << ": " << frameTime << "ms";
+    return frameTime;
+}
+
+std::filesystem::path tpd::GaussianEngine::getKernelTuningDirectory() {
+    return std::filesystem::temp_directory_path() / "torpedo" / "kernel-tuning";
+}
+
+void tpd::GaussianEngine::createFrames(const uint32_t firstFrame) {
     const auto drawingAllocInfo = vk::CommandBufferAllocateInfo{ _drawingCommandPool, vk::CommandBufferLevel::ePrimary, 1 };
     const auto computeAllocInfo = vk::CommandBufferAllocateInfo{ _computeCommandPool, vk::CommandBufferLevel::ePrimary, 1 };
+    const auto blendAllocInfo = vk::CommandBufferAllocateInfo{
+        asyncCompute() ? _computeCommandPool : _drawingCommandPool, vk::CommandBufferLevel::eSecondary, 1 };
 
-    for (auto& [instance, drawing, compute, ownership, preFrameFence, readBackFence, maxTilesRendered, rangeBuffer, target] : _frames) {
+    const auto frames = _frames | std::views::drop(firstFrame);
+    for (auto& [instance, drawing, compute, blend, ownership, preFrameFence, readBackFence, tilesRendered, statsPending, blendRecorded, target] : frames) {
         instance = _shaderLayout.createInstance(_device);
         drawing = _device.allocateCommandBuffers(drawingAllocInfo)[0];
         compute = _device.allocateCommandBuffers(asyncCompute()? computeAllocInfo : drawingAllocInfo)[0];
+        blend = _device.allocateCommandBuffers(blendAllocInfo)[0];
         preFrameFence = _device.createFence(vk::FenceCreateInfo{ vk::FenceCreateFlagBits::eSignaled });
         readBackFence = _device.createFence({});
-        maxTilesRendered = 1; // initialize to 1 so we can render an empty scene
 
         if (asyncCompute()) {
             ownership = _device.createSemaphore({});
@@ -318,13 +667,13 @@ void tpd::GaussianEngine::createRenderTargets(const uint32_t width, const uint32
         .format(vk::Format::eR8G8B8A8Unorm)
         .usage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc);
 
-    // Create a render target image and image view for each in-flight frame
-    for (auto i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
+    // Create a render target image and image view for each in-flight frame and view
+    for (uint32_t i = 0; i < _frames.size(); ++i) {
         _frames[i].outputImage = targetBuilder.build(_vmaAllocator);
         _targetViews[i] = _frames[i].outputImage.createImageView(vk::ImageViewType::e2D, _device);
     }
 
-    for (uint32_t i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
+    for (uint32_t i = 0; i < _frames.size(); ++i) {
         const auto descriptorInfo = vk::DescriptorImageInfo{}
             .setImageView(_targetViews[i])
             .setImageLayout(vk::ImageLayout::eGeneral);
@@ -333,14 +682,103 @@ void tpd::GaussianEngine::createRenderTargets(const uint32_t width, const uint32
 }
 
 void tpd::GaussianEngine::createCameraBuffer() {
-    constexpr auto size = sizeof(mat4) * 2 + sizeof(vec2);
     _cameraBuffer = RingBuffer::Builder()
         .count(1) // thanks to readback fence, a single camera buffer can be used across in-flight frames
         .usage(vk::BufferUsageFlagBits::eUniformBuffer)
-        .alloc(size)
+        .alloc(CAMERA_SIZE)
+        .build(_vmaAllocator);
+
+    setBufferDescriptors(_cameraBuffer, CAMERA_SIZE, vk::DescriptorType::eUniformBuffer, 1, 0);
+}
+
+void tpd::GaussianEngine::createViews(const uint32_t viewCount) {
+    PLOGD << "GaussianEngine - Growing views of a batch: " << _viewCount << " -> " << viewCount;
+
+    // Targets and per-frame buffers are rebuilt for every frame, none of them can be in use
+    waitIdle();
+
+    const auto firstFrame = static_cast<uint32_t>(_frames.size());
+    const auto frameCount = _renderer->getInFlightFrameCount() + viewCount;
+    _frames.resize(frameCount);
+    _targetViews.resize(frameCount);
+    _statsBuffers.resize(frameCount);
+    _workloadBuffers.resize(frameCount);
+    _sortDispatchBuffers.resize(frameCount);
+    _viewCount = viewCount;
+
+    createFrames(firstFrame);
+    createStatisticsBuffers(firstFrame);
+    createSortDispatchBuffers(firstFrame);
+
+    const auto [w, h] = _renderer->getFramebufferSize();
+    cleanupRenderTargets();
+    createRenderTargets(w, h);
+    if (_collectStats) createWorkloadBuffers(w, h);
+
+    // Uniform buffers can only be bound at offsets of a device-dependent alignment
+    const auto alignment = _physicalDevice.getProperties().limits.minUniformBufferOffsetAlignment;
+    const auto cameraSize = (CAMERA_SIZE + alignment - 1) / alignment * alignment;
+    _viewCameraBuffer.destroy(_vmaAllocator);
+    _viewCameraBuffer = RingBuffer::Builder()
+        .count(viewCount)
+        .usage(vk::BufferUsageFlagBits::eUniformBuffer)
+        .alloc(cameraSize)
+        .build(_vmaAllocator);
+
+    _viewTilesRenderedBuffer.destroy(_vmaAllocator);
+    _viewTilesRenderedBuffer = TwoWayBuffer::Builder()
+        .usage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress)
+        .alloc(sizeof(uint32_t) * viewCount)
         .build(_vmaAllocator);
 
-    setBufferDescriptors(_cameraBuffer, size, vk::DescriptorType::eUniformBuffer, 1, 0);
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        const auto& instance = _frames[_renderer->getInFlightFrameCount() + view].instance;
+        const auto info = vk::DescriptorBufferInfo{ _viewCameraBuffer, _viewCameraBuffer.getOffset(view), CAMERA_SIZE };
+        instance.setDescriptor(0, 1, vk::DescriptorType::eUniformBuffer, _device, info);
+    }
+
+    // Scene buffers are bound the same way for every frame, new views take them from the first frame once a scene
+    // has been compiled. Later compilations reach the views through setBufferDescriptors.
+    if (_pc.count > 0) {
+        const auto src = _frames[0].instance.getDescriptorSets();
+        auto copies = std::vector<vk::CopyDescriptorSet>{};
+        for (auto i = firstFrame; i < frameCount; ++i) {
+            const auto dst = _frames[i].instance.getDescriptorSets();
+            copies.push_back(vk::CopyDescriptorSet{ src[0], 2, 0, dst[0], 2, 0, 1 }); // gaussians
+            copies.push_back(vk::CopyDescriptorSet{ src[1], 0, 0, dst[1], 0, 0, 1 }); // transform handles
+            copies.push_back(vk::CopyDescriptorSet{ src[1], 1, 0, dst[1], 1, 0, 1 }); // transform indices
+            copies.push_back(vk::CopyDescriptorSet{ src[2], 0, 0, dst[2], 0, 0, 1 }); // bindless transforms
+        }
+        _device.updateDescriptorSets({}, copies);
+        createViewSplatBuffers(_pc.count);
+    }
+
+    // Host readbacks of a batch must all fit in the staging ring at once
+    if (_readbackWorker) {
+        _readbackWorker->destroy();
+        createReadbackWorker();
+    }
+
+    // Blend commands of the frames in flight bound the target descriptors rewritten above and copied workloads to
+    // buffers that have just been freed, replaying them would be invalid
+    invalidateBlendCommands();
+}
+
+void tpd::GaussianEngine::createViewSplatBuffers(const uint32_t gaussianCount) {
+    const auto size = (_halfPrecisionSplats ? PACKED_SPLAT_SIZE : SPLAT_SIZE) * gaussianCount;
+    const auto builder = StorageBuffer::Builder()
+        .usage(vk::BufferUsageFlagBits::eShaderDeviceAddress)
+        .strategy(vma::AllocationStrategy::Dedicated)
+        .alloc(size);
+
+    std::ranges::for_each(_viewSplatBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
+    _viewSplatBuffers.resize(_viewCount);
+    for (uint32_t view = 0; view < _viewCount; ++view) {
+        _viewSplatBuffers[view] = builder.build(_vmaAllocator);
+        const auto& instance = _frames[_renderer->getInFlightFrameCount() + view].instance;
+        const auto info = vk::DescriptorBufferInfo{ _viewSplatBuffers[view], 0, size };
+        instance.setDescriptor(0, 3, vk::DescriptorType::eStorageBuffer, _device, info);
+    }
 }
 
 void tpd::GaussianEngine::cleanupRenderTargets() noexcept {
@@ -349,10 +787,11 @@ void tpd::GaussianEngine::cleanupRenderTargets() noexcept {
 }
 
 void tpd::GaussianEngine::updateRadixPassCount(const uint32_t width, const uint32_t height) noexcept {
-    const auto tilesX = (width  + BLOCK_X - 1) / BLOCK_X;
-    const auto tilesY = (height + BLOCK_Y - 1) / BLOCK_Y;
-    const auto bits = getHigherMSB(tilesX * tilesY) + 32;
-    _radixPassCount = (bits + 1) / 2;
+    const auto tilesX = (width  + _tuning.blockX - 1) / _tuning.blockX;
+    const auto tilesY = (height + _tuning.blockY - 1) / _tuning.blockY;
+    // Keys hold the view depth in the lower 32 bits and the tile index above, so only the bits in use are sorted
+    _sortKeyBits = getHigherMSB(tilesX * tilesY) + 32;
+    _radixPassCount = GpuRadixSort::getPassCount(0, _sortKeyBits);
     PLOGD << "GaussianEngine - Radix pass count: " << _radixPassCount;
 }
 
@@ -375,12 +814,51 @@ void tpd::GaussianEngine::compile(const Scene& scene, const Settings& settings)
     PLOGD << "GaussianEngine - Compiling scene with:";
     PLOGD << " - Gaussian count: " << gaussianCount;
     PLOGD << " - Entity count: " << entityCount;
+    PLOGD << " - Half-precision splats: " << (settings.halfPrecisionSplats ? "on" : "off");
+    PLOGD << " - GPU profiling: " << (settings.gpuProfiling ? "on" : "off");
+    PLOGD << " - Frame statistics: " << (settings.frameStatistics ? "on" : "off");
+    PLOGD << " - Autotune: " << (settings.autotune ? (_kernelsTuned ? "done" : "on") : "off");
+
+    // Profilers own query pools which may still be in use by frames in flight
+    if (settings.gpuProfiling != _passProfiler.valid()) {
+        waitIdle();
+        if (settings.gpuProfiling) createProfilers();
+        else destroyProfilers();
+    }
+
+    // The splat layout and stats counters are baked into some of the pipelines, swap them out if either changes
+    if (settings.halfPrecisionSplats != _halfPrecisionSplats || settings.frameStatistics != _collectStats) {
+        waitIdle();
+        destroySplatPipelines();
+        _halfPrecisionSplats = settings.halfPrecisionSplats;
+        _collectStats = settings.frameStatistics;
+        createSplatPipelines();
+
+        // Counters written under the old settings are no longer meaningful
+        std::ranges::for_each(_frames, [](Frame& f) { f.statsPending = false; });
+        _frameStatistics = {};
+        _tileWorkload = {};
+
+        const auto [w, h] = _renderer->getFramebufferSize();
+        if (_collectStats) createWorkloadBuffers(w, h);
+        else destroyWorkloadBuffers();
+
+        // The workload copy is a pass of its own
+        createBlendGraph();
+    }
+
+    // Tune against the settings the scene is going to be rendered with, before the scene's own buffers are created
+    if (settings.autotune && !_kernelsTuned) [[unlikely]] {
+        autotune(settings);
+    }
 
     _pc = PointCloud{ gaussianCount, shDegree };
 
+    // Uploads made while creating scene buffers go out in a single submission, see flush below
+    _transferWorker->beginBatch();
     createGaussianBuffer(scene.dataAll<GaussianPoint>());
     createSplatBuffer(gaussianCount);
-    createPartitionDescriptorBuffer(gaussianCount);
+    createScanScratchBuffer(gaussianCount);
 
     // Build indices that map each Gaussian to the transform handle it belongs to
     auto indices = std::vector<uint32_t>{};
@@ -394,14 +872,19 @@ void tpd::GaussianEngine::compile(const Scene& scene, const Settings& settings)
     createTransformHandleBuffer(entityCount);
     createTransformIndexBuffer(indices);
     createBindlessTransformBuffer(entityCount);
+    _transferWorker->flush();
 
     _transformHost->update(std::move(entityMap), &_bindlessTransformBuffer);
+
+    // Pipelines, descriptors, profilers and the point count may all have changed
+    invalidateBlendCommands();
 }
 
 void tpd::GaussianEngine::createGaussianBuffer(const std::vector<std::byte>& bytes) {
     _gaussianBuffer.destroy(_vmaAllocator);
     _gaussianBuffer = StorageBuffer::Builder()
         .usage(vk::BufferUsageFlagBits::eTransferDst)
+        .strategy(vma::AllocationStrategy::Dedicated) // large and living as long as the scene
         .alloc(bytes.size())
         .build(_vmaAllocator);
 
@@ -410,33 +893,36 @@ void tpd::GaussianEngine::createGaussianBuffer(const std::vector<std::byte>& byt
 }
 
 void tpd::GaussianEngine::createSplatBuffer(const uint32_t gaussianCount) {
+    const auto size = (_halfPrecisionSplats ? PACKED_SPLAT_SIZE : SPLAT_SIZE) * gaussianCount;
     _splatBuffer.destroy(_vmaAllocator);
-    _splatBuffer = StorageBuffer::Builder().alloc(SPLAT_SIZE * gaussianCount).build(_vmaAllocator);
-    setBufferDescriptors(_splatBuffer, SPLAT_SIZE * gaussianCount, vk::DescriptorType::eStorageBuffer, 3);
+    _splatBuffer = StorageBuffer::Builder()
+        .usage(vk::BufferUsageFlagBits::eShaderDeviceAddress) // tiles touched are scanned in place, see recordSplat
+        .strategy(vma::AllocationStrategy::Dedicated)
+        .alloc(size)
+        .build(_vmaAllocator);
+    setBufferDescriptors(_splatBuffer, size, vk::DescriptorType::eStorageBuffer, 3);
+
+    // Views have splats of their own, the descriptors above have just pointed them to the shared ones
+    if (_viewCount > 0) createViewSplatBuffers(gaussianCount);
 }
 
 void tpd::GaussianEngine::createTilesRenderedBuffer() {
     _tilesRenderedBuffer = TwoWayBuffer::Builder()
-        .usage(vk::BufferUsageFlagBits::eStorageBuffer)
+        .usage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress)
         .alloc(sizeof(uint32_t))
         .build(_vmaAllocator);
 
-    setBufferDescriptors(_tilesRenderedBuffer, sizeof(uint32_t), vk::DescriptorType::eStorageBuffer, 4);
     _tilesRenderedBuffer.write(uint32_t{ 0 }); // don't assume the buffer is automatically initialized with 0
     vmaFlushAllocation(_vmaAllocator, _tilesRenderedBuffer.getAllocation(), 0, vk::WholeSize);
 }
 
-void tpd::GaussianEngine::createPartitionCountBuffer() {
-    _partitionCountBuffer = StorageBuffer::Builder().alloc(sizeof(uint32_t)).build(_vmaAllocator);
-    setBufferDescriptors(_partitionCountBuffer, sizeof(uint32_t), vk::DescriptorType::eStorageBuffer, 5);
-}
-
-void tpd::GaussianEngine::createPartitionDescriptorBuffer(const uint32_t gaussianCount) {
-    _partitionDescriptorBuffer.destroy(_vmaAllocator);
-    const auto size = sizeof(uint32_t) * (gaussianCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
-
-    _partitionDescriptorBuffer = StorageBuffer::Builder().alloc(size).build(_vmaAllocator);
-    setBufferDescriptors(_partitionDescriptorBuffer, size, vk::DescriptorType::eStorageBuffer, 6);
+void tpd::GaussianEngine::createScanScratchBuffer(const uint32_t gaussianCount) {
+    _scanScratchBuffer.destroy(_vmaAllocator);
+    _scanScratchBuffer = StorageBuffer::Builder()
+        .usage(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress)
+        .strategy(vma::AllocationStrategy::SubAllocated) // a few bytes per 256 Gaussians, recreated on every compile
+        .alloc(GpuPrefixScan::getScratchSize(gaussianCount))
+        .build(_vmaAllocator);
 }
 
 void tpd::GaussianEngine::createTransformHandleBuffer(const uint32_t entityCount) {
@@ -492,7 +978,7 @@ void tpd::GaussianEngine::setBufferDescriptors(
     const uint32_t binding,
     const uint32_t set) const
 {
-    for (uint32_t i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
+    for (uint32_t i = 0; i < _frames.size(); ++i) {
         const auto descriptorInfo = vk::DescriptorBufferInfo{}
             .setBuffer(buffer)
             .setOffset(0)
@@ -501,124 +987,234 @@ void tpd::GaussianEngine::setBufferDescriptors(
     }
 }
 
-void tpd::GaussianEngine::createSplatKeyBuffers(const uint32_t frameIndex) {
-    const auto size = sizeof(uint64_t) * _frames[frameIndex].maxTilesRendered;
-    _splatKeyBuffers[frameIndex].destroy(_vmaAllocator);
-    _splatKeyBuffers[frameIndex] = StorageBuffer::Builder().alloc(size).build(_vmaAllocator);
+void tpd::GaussianEngine::createBlendGraph() {
+    const auto [w, h] = _renderer->getFramebufferSize();
+    const auto tilesX = (w + _tuning.blockX - 1) / _tuning.blockX;
+    const auto tilesY = (h + _tuning.blockY - 1) / _tuning.blockY;
+
+    auto builder = ComputeGraph::Builder();
+
+    // Buffers outliving the graph only take part in hazard tracking
+    const auto splats = builder.import("splats");
+    const auto stats = builder.import("frame-stats");
+    const auto workload = builder.import("workload");
+
+    // Sort and range buffers only live within the graph, those whose lifetimes don't overlap share memory.
+    // Shaders access them through device addresses, see SortBuffers and GpuRadixSort. Also add transfer dst usage to the range
+    // buffer to clear it without an additional compute pass, and transfer src usage to export the tile workload
+    // when collecting frame statistics.
+    using enum vk::BufferUsageFlagBits;
+    constexpr auto usage = eShaderDeviceAddress;
+    const auto keys = builder.transient("splat-keys", sizeof(uint64_t) * _sortCapacity, usage);
+    const auto indices = builder.transient("splat-indices", sizeof(uint32_t) * _sortCapacity, usage);
+    const auto scratch = builder.transient("sort-scratch", _keySort.getScratchSize(_sortCapacity), usage);
+    const auto ranges = builder.transient("ranges", sizeof(uvec2) * tilesX * tilesY, usage | eTransferDst | eTransferSrc);
+
+    // The number of workgroups sorting the keys depends on the tiles rendered, which the frame being recorded
+    // only writes to its dispatch buffer after the commands have been recorded, see updateSortDispatch
+    const auto dispatchBuffer = [this] { return vk::Buffer{ _sortDispatchBuffers[_recordingFrame] }; };
+
+    // Keygen pass: we could put this in recordSplat and ignore the _pc.count check, but that would cause
+    // glitching when new tiles rendered change because keygen pass writes to key and index buffers
+    using enum ComputeGraph::PassType;
+    builder.pass("keygen", Compute, { splats }, { keys, indices }, [this](const vk::CommandBuffer cmd) {
+        recordPassBegin(cmd, Pass::Keygen);
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _keygenPipeline);
+        if (_pc.count > 0) [[likely]] cmd.dispatch((_pc.count + _tuning.workgroupSize - 1) / _tuning.workgroupSize, 1, 1);
+        recordPassEnd(cmd, Pass::Keygen);
+    });
 
-    const auto info = vk::DescriptorBufferInfo{}.setBuffer(_splatKeyBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 7, vk::DescriptorType::eStorageBuffer, _device, info);
-}
+    // Radix sort passes, each made of the shuffle, prefix, and mapping kernels with barriers of their own
+    const auto sortInput = [this, keys, indices, scratch] {
+        return GpuRadixSort::Input{
+            _blendGraph.getBuffer(keys), _blendGraph.getBuffer(indices), _blendGraph.getBuffer(scratch),
+            _sortCapacity, 0, _sortKeyBits };
+    };
+    for (uint32_t radixPass = 0; radixPass < _radixPassCount; ++radixPass) {
+        builder.pass("radix-sort", Compute, { keys, indices, scratch }, { keys, indices, scratch },
+            [this, radixPass, sortInput, dispatchBuffer](const vk::CommandBuffer cmd) {
+                // Each kernel group of the pass is timed on its own, within the sort's barriers
+                const auto profiling = GpuRadixSort::Profiling{
+                    &_passProfiler, _recordingFrame, std::to_underlying(Pass::RadixShuffle),
+                    std::to_underlying(Pass::RadixPrefix), std::to_underlying(Pass::RadixMapping) };
+                _keySort.recordPassIndirect(
+                    cmd, sortInput(), radixPass, dispatchBuffer(), 0, timingPasses() ? &profiling : nullptr);
+            });
+    }
 
-void tpd::GaussianEngine::createSplatIndexBuffers(const uint32_t frameIndex) {
-    const auto size = sizeof(uint32_t) * _frames[frameIndex].maxTilesRendered;
-    _splatIndexBuffers[frameIndex].destroy(_vmaAllocator);
-    _splatIndexBuffers[frameIndex] = StorageBuffer::Builder().alloc(size).build(_vmaAllocator);
+    // Clear the range buffer before populating it
+    builder.pass("range-clear", Transfer, {}, { ranges }, [this, ranges](const vk::CommandBuffer cmd) {
+        cmd.fillBuffer(_blendGraph.getBuffer(ranges), 0, vk::WholeSize, 0);
+    });
 
-    const auto info = vk::DescriptorBufferInfo{}.setBuffer(_splatIndexBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 8, vk::DescriptorType::eStorageBuffer, _device, info);
-}
+    // Range pass
+    builder.pass("range", Compute, { keys }, { ranges }, [this, dispatchBuffer](const vk::CommandBuffer cmd) {
+        // The sort pushed its constants through a layout of its own, leaving ours undefined
+        pushRasterInfo(cmd, _recordingFrame);
+        recordPassBegin(cmd, Pass::Range);
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _rangePipeline);
+        cmd.dispatchIndirect(dispatchBuffer(), offsetof(GpuRadixSort::Dispatch, sort));
+        recordPassEnd(cmd, Pass::Range);
+    });
 
-void tpd::GaussianEngine::createGlobalPrefixBuffers(const uint32_t frameIndex) {
-    const auto size = sizeof(uint64_t) * (_frames[frameIndex].maxTilesRendered + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
-    const auto builder = StorageBuffer::Builder().alloc(size);
+    // Alpha blending pass
+    builder.pass("blend", Compute, { splats, indices, ranges }, { stats }, [this, tilesX, tilesY](const vk::CommandBuffer cmd) {
+        recordPassBegin(cmd, Pass::Blend);
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _blendPipeline);
+        cmd.dispatch(tilesX, tilesY, 1);
+        recordPassEnd(cmd, Pass::Blend);
+    });
 
-    _globalPrefixABuffers[frameIndex].destroy(_vmaAllocator);
-    _globalPrefixBBuffers[frameIndex].destroy(_vmaAllocator);
+    // Export per-tile ranges for the workload heatmap
+    if (_collectStats) {
+        builder.pass("workload-copy", Transfer, { ranges }, { workload }, [this, ranges](const vk::CommandBuffer cmd) {
+            recordWorkloadCopy(cmd, _blendGraph.getBuffer(ranges), _recordingFrame);
+        });
+    }
 
-    _globalPrefixABuffers[frameIndex] = builder.build(_vmaAllocator);
-    _globalPrefixBBuffers[frameIndex] = builder.build(_vmaAllocator);
+    // Callers make sure no frame in flight is still using the old graph
+    _blendGraph.destroy(_device, _vmaAllocator);
+    _blendGraph = builder.build(_device, _vmaAllocator);
 
-    const auto infoA = vk::DescriptorBufferInfo{}.setBuffer(_globalPrefixABuffers[frameIndex]).setOffset(0).setRange(size);
-    const auto infoB = vk::DescriptorBufferInfo{}.setBuffer(_globalPrefixBBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 9, vk::DescriptorType::eStorageBuffer, _device, infoA);
-    _frames[frameIndex].instance.setDescriptor(0,10, vk::DescriptorType::eStorageBuffer, _device, infoB);
-}
+    // Commands recorded against the old graph pick up the new addresses when they are recorded again,
+    // no descriptor has to be rewritten
+    invalidateBlendCommands();
+    _sortBuffers.splatKeys = getBufferAddress(_blendGraph.getBuffer(keys));
+    _sortBuffers.splatIndices = getBufferAddress(_blendGraph.getBuffer(indices));
+    _sortBuffers.ranges = getBufferAddress(_blendGraph.getBuffer(ranges));
 
-void tpd::GaussianEngine::createTempKeyBuffers(const uint32_t frameIndex) {
-    const auto size = sizeof(uint64_t) * _frames[frameIndex].maxTilesRendered;
-    _tempKeyBuffers[frameIndex].destroy(_vmaAllocator);
-    _tempKeyBuffers[frameIndex] = StorageBuffer::Builder().alloc(size).build(_vmaAllocator);
+    const auto& statistics = _blendGraph.getStatistics();
+    PLOGD << "GaussianEngine - Blend graph: " << statistics.passCount << " passes, " << statistics.barrierCount << " barriers, "
+          << statistics.transientBytes / 1024 << "KB of transient memory (" << statistics.unaliasedBytes / 1024 << "KB unaliased)";
+}
 
-    const auto info = vk::DescriptorBufferInfo{}.setBuffer(_tempKeyBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 11, vk::DescriptorType::eStorageBuffer, _device, info);
+vk::DeviceAddress tpd::GaussianEngine::getBufferAddress(const vk::Buffer buffer) const {
+    return _device.getBufferAddress(vk::BufferDeviceAddressInfo{ buffer });
 }
 
-void tpd::GaussianEngine::createTempValBuffers(const uint32_t frameIndex) {
-    const auto size = sizeof(uint32_t) * _frames[frameIndex].maxTilesRendered;
-    _tempValBuffers[frameIndex].destroy(_vmaAllocator);
-    _tempValBuffers[frameIndex] = StorageBuffer::Builder().alloc(size).build(_vmaAllocator);
+void tpd::GaussianEngine::createSortDispatchBuffers(const uint32_t firstFrame) {
+    using enum vk::BufferUsageFlagBits;
+    const auto builder = TwoWayBuffer::Builder().usage(eIndirectBuffer | eShaderDeviceAddress).alloc(sizeof(GpuRadixSort::Dispatch));
+
+    // Each frame has its own, so that writing one never races with the GPU reading the one of another frame
+    for (auto i = firstFrame; i < _frames.size(); ++i) {
+        _sortDispatchBuffers[i] = builder.build(_vmaAllocator);
+        updateSortDispatch(i, 0);
+    }
+}
 
-    const auto info = vk::DescriptorBufferInfo{}.setBuffer(_tempValBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 12, vk::DescriptorType::eStorageBuffer, _device, info);
+void tpd::GaussianEngine::updateSortDispatch(const uint32_t frameIndex, const uint32_t tilesRendered) const {
+    const auto& buffer = _sortDispatchBuffers[frameIndex];
+    buffer.write(GpuRadixSort::getDispatch(tilesRendered));
+    vmaFlushAllocation(_vmaAllocator, buffer.getAllocation(), 0, vk::WholeSize);
 }
 
-void tpd::GaussianEngine::createBlockCountBuffers() {
-    const auto builder = StorageBuffer::Builder().alloc(sizeof(uint32_t));
+void tpd::GaussianEngine::recordBlendCommands(const uint32_t frameIndex) {
+    TPD_TRACE_ZONE("GaussianEngine::recordBlendCommands");
+    PLOGD << "GaussianEngine - Frame " << frameIndex << " recording blend commands";
+    _recordingFrame = frameIndex;
 
-    for (auto i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
-        _blockCountABuffers[i] = builder.build(_vmaAllocator);
-        _blockCountBBuffers[i] = builder.build(_vmaAllocator);
+    const auto cmd = _frames[frameIndex].blend;
+    constexpr auto inheritanceInfo = vk::CommandBufferInheritanceInfo{};
+    cmd.begin(vk::CommandBufferBeginInfo{ {}, &inheritanceInfo });
 
-        const auto infoA = vk::DescriptorBufferInfo{}.setBuffer(_blockCountABuffers[i]).setOffset(0).setRange(sizeof(uint32_t));
-        const auto infoB = vk::DescriptorBufferInfo{}.setBuffer(_blockCountBBuffers[i]).setOffset(0).setRange(sizeof(uint32_t));
-        _frames[i].instance.setDescriptor(0, 13, vk::DescriptorType::eStorageBuffer, _device, infoA);
-        _frames[i].instance.setDescriptor(0, 15, vk::DescriptorType::eStorageBuffer, _device, infoB);
-    }
-}
+    // Secondary command buffers inherit no state from the primary, bind everything the passes need
+    pushRasterInfo(cmd, frameIndex);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, _gaussianLayout, 0, _frames[frameIndex].instance.getDescriptorSets(), {});
 
-void tpd::GaussianEngine::createBlockDescriptorBuffers(const uint32_t frameIndex) {
-    const auto blockCount = (_frames[frameIndex].maxTilesRendered + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
-    const auto size = sizeof(uint64_t) * (blockCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
-    const auto builder = StorageBuffer::Builder().alloc(size);
+    // The remaining passes: keygen, radix, range, blend, see createBlendGraph
+    _blendGraph.record(cmd);
+    cmd.end();
+}
 
-    _blockDescriptorABuffers[frameIndex].destroy(_vmaAllocator);
-    _blockDescriptorBBuffers[frameIndex].destroy(_vmaAllocator);
+void tpd::GaussianEngine::pushRasterInfo(const vk::CommandBuffer cmd, const uint32_t frameIndex) const {
+    auto sortBuffers = _sortBuffers;
+    sortBuffers.tilesRendered = getBufferAddress(_sortDispatchBuffers[frameIndex]) + offsetof(GpuRadixSort::Dispatch, count);
 
-    _blockDescriptorABuffers[frameIndex] = builder.build(_vmaAllocator);
-    _blockDescriptorBBuffers[frameIndex] = builder.build(_vmaAllocator);
+    constexpr auto shaderStage = vk::ShaderStageFlagBits::eCompute;
+    cmd.pushConstants(_gaussianLayout, shaderStage, 0,                  sizeof(PointCloud),  &_pc);
+    cmd.pushConstants(_gaussianLayout, shaderStage, sizeof(PointCloud), sizeof(SortBuffers), &sortBuffers);
+}
 
-    const auto infoA = vk::DescriptorBufferInfo{}.setBuffer(_blockDescriptorABuffers[frameIndex]).setOffset(0).setRange(size);
-    const auto infoB = vk::DescriptorBufferInfo{}.setBuffer(_blockDescriptorBBuffers[frameIndex]).setOffset(0).setRange(size);
-    _frames[frameIndex].instance.setDescriptor(0, 14, vk::DescriptorType::eStorageBuffer, _device, infoA);
-    _frames[frameIndex].instance.setDescriptor(0, 16, vk::DescriptorType::eStorageBuffer, _device, infoB);
+void tpd::GaussianEngine::invalidateBlendCommands() noexcept {
+    // Each frame records again the next time it comes around, after its pre-frame fence has been waited
+    std::ranges::for_each(_frames, [](Frame& f) { f.blendRecorded = false; });
 }
 
-void tpd::GaussianEngine::createGlobalSumBuffers() {
-    constexpr auto size = sizeof(uint32_t) * 3; // see radix.slang
-    const auto builder = StorageBuffer::Builder().alloc(size);
+void tpd::GaussianEngine::createStatisticsBuffers(const uint32_t firstFrame) {
+    constexpr auto size = sizeof(uint32_t) * 4; // see FrameStats in splat.slang
+    const auto builder = TwoWayBuffer::Builder().usage(vk::BufferUsageFlagBits::eStorageBuffer).alloc(size);
 
-    for (auto i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
-        _globalSumBuffers[i] = builder.build(_vmaAllocator);
-        const auto info = vk::DescriptorBufferInfo{}.setBuffer(_globalSumBuffers[i]).setOffset(0).setRange(size);
-        _frames[i].instance.setDescriptor(0, 17, vk::DescriptorType::eStorageBuffer, _device, info);
+    // Bound regardless of the settings, shaders only touch them when the COLLECT_STATS constant is set
+    for (auto i = firstFrame; i < _frames.size(); ++i) {
+        _statsBuffers[i] = builder.build(_vmaAllocator);
+        const auto info = vk::DescriptorBufferInfo{}.setBuffer(_statsBuffers[i]).setOffset(0).setRange(size);
+        _frames[i].instance.setDescriptor(0, 19, vk::DescriptorType::eStorageBuffer, _device, info);
     }
 }
 
-void tpd::GaussianEngine::createRangeBuffers(const uint32_t width, const uint32_t height) {
-    const auto tilesX = (width  + BLOCK_X - 1) / BLOCK_X;
-    const auto tilesY = (height + BLOCK_Y - 1) / BLOCK_Y;
+void tpd::GaussianEngine::createWorkloadBuffers(const uint32_t width, const uint32_t height) {
+    const auto tilesX = (width  + _tuning.blockX - 1) / _tuning.blockX;
+    const auto tilesY = (height + _tuning.blockY - 1) / _tuning.blockY;
     const auto size = sizeof(uvec2) * tilesX * tilesY;
+    const auto builder = TwoWayBuffer::Builder().usage(vk::BufferUsageFlagBits::eTransferDst).alloc(size);
 
-    // Also add transfer dst usage to clear the buffer without an additional compute pass
-    const auto builder = StorageBuffer::Builder().usage(vk::BufferUsageFlagBits::eTransferDst).alloc(size);
+    destroyWorkloadBuffers();
+    for (uint32_t i = 0; i < _frames.size(); ++i) {
+        _workloadBuffers[i] = builder.build(_vmaAllocator);
+        _frames[i].statsPending = false; // ranges of the old image size are no longer meaningful
+    }
+}
 
-    // Create a range buffer for each in-flight frame
-    for (auto i = 0; i < _renderer->getInFlightFrameCount(); ++i) {
-        // It's possible we're reallocating a new buffer due to image
-        // dimension change, in which case the old one must be destroyed
-        _frames[i].rangeBuffer.destroy(_vmaAllocator);
-        _frames[i].rangeBuffer = builder.build(_vmaAllocator);
+void tpd::GaussianEngine::destroyWorkloadBuffers() noexcept {
+    std::ranges::for_each(_workloadBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
+}
 
-        const auto descriptorInfo = vk::DescriptorBufferInfo{}
-            .setBuffer(_frames[i].rangeBuffer)
-            .setOffset(0)
-            .setRange(size);
-        _frames[i].instance.setDescriptor(0, 18, vk::DescriptorType::eStorageBuffer, _device, descriptorInfo);
+void tpd::GaussianEngine::collectFrameStatistics(const uint32_t frameIndex) {
+    const auto& frame = _frames[frameIndex];
+    const auto& statsBuffer = _statsBuffers[frameIndex];
+
+    // The pre-frame fence has been waited, so whatever the last submission of this frame wrote is available
+    if (frame.statsPending) {
+        vmaInvalidateAllocation(_vmaAllocator, statsBuffer.getAllocation(), 0, vk::WholeSize);
+        const auto counters = statsBuffer.read<uint32_t>(4); // see FrameStats in splat.slang
+
+        _frameStatistics.visibleGaussians = counters[0];
+        _frameStatistics.tilesRendered = frame.tilesRendered;
+        _frameStatistics.activeTiles = counters[1];
+        _frameStatistics.maxSplatsPerTile = counters[2];
+        _frameStatistics.meanSplatsPerTile = counters[1] > 0 ? static_cast<float>(frame.tilesRendered) / counters[1] : 0.0f;
+        _frameStatistics.earlyTerminatedPixels = counters[3];
+
+        const auto& workloadBuffer = _workloadBuffers[frameIndex];
+        vmaInvalidateAllocation(_vmaAllocator, workloadBuffer.getAllocation(), 0, vk::WholeSize);
+
+        const auto [w, h] = _renderer->getFramebufferSize();
+        _tileWorkload.tilesX = (w + _tuning.blockX - 1) / _tuning.blockX;
+        _tileWorkload.tilesY = (h + _tuning.blockY - 1) / _tuning.blockY;
+        const auto tileCount = _tileWorkload.tilesX * _tileWorkload.tilesY;
+
+        // Each range is a pair of [start, end) indices into the sorted splat list
+        const auto ranges = workloadBuffer.read<uvec2>(tileCount);
+        _tileWorkload.splatCounts.resize(tileCount);
+        std::ranges::transform(ranges, _tileWorkload.splatCounts.begin(), [](const uvec2& r) { return r.y - r.x; });
+    }
+
+    // Reset the counters for the frame we're about to record
+    if (_collectStats) {
+        static constexpr auto zeros = std::array<uint32_t, 4>{};
+        statsBuffer.write(zeros);
+        vmaFlushAllocation(_vmaAllocator, statsBuffer.getAllocation(), 0, vk::WholeSize);
     }
 }
 
 void tpd::GaussianEngine::rasterFrame(const Camera& camera) {
+    rasterFrame(camera, true);
+}
+
+void tpd::GaussianEngine::rasterFrame(const Camera& camera, const bool releaseTarget) {
+    TPD_TRACE_ZONE("GaussianEngine::rasterFrame");
+
     // Choose the right queue to submit pre-frame work
     const auto preFrameQueue = asyncCompute() ? _computeQueue : _graphicsQueue;
 
@@ -626,18 +1222,38 @@ void tpd::GaussianEngine::rasterFrame(const Camera& camera) {
     vmaSetCurrentFrameIndex(_vmaAllocator, frameIndex);
 
     // Set camera data
-    updateCameraBuffer(camera);
+    updateCameraBuffer(camera, _cameraBuffer);
 
     // Wait until the GPU has done with the pre-frame compute buffer for this frame
     using limits = std::numeric_limits<uint64_t>;
     const auto preFrameFence = _frames[frameIndex].preFrameFence;
-    [[maybe_unused]] const auto result = _device.waitForFences(preFrameFence, vk::True, limits::max());
+    {
+        TPD_TRACE_ZONE("GaussianEngine::waitPreFrameFence");
+        [[maybe_unused]] const auto result = _device.waitForFences(preFrameFence, vk::True, limits::max());
+    }
     _device.resetFences(preFrameFence);
 
+    // Clean up after scene transfers that have completed by now, never blocks
+    _transferWorker->reclaim();
+    applyPendingSortCapacity(frameIndex);
+
+    // Counters of the last frame run by this frame index, the fence above means they're ready
+    collectFrameStatistics(frameIndex);
+
+    // Timings of the last frame run by this frame index, reading them never waits
+    if (_passProfiler.valid()) [[unlikely]] {
+        _passProfiler.collect(_device, frameIndex);
+        if (_copyProfiler.valid()) _copyProfiler.collect(_device, frameIndex);
+    }
+
     const auto preFrameCompute = _frames[frameIndex].compute;
     preFrameCompute.reset();
     preFrameCompute.begin(vk::CommandBufferBeginInfo{});
 
+    if (_passProfiler.valid()) [[unlikely]] {
+        _passProfiler.recordReset(preFrameCompute, frameIndex);
+    }
+
     // Bind once before preprocess passes
     constexpr auto shaderStage = vk::ShaderStageFlagBits::eCompute;
     using enum vk::PipelineBindPoint;
@@ -653,39 +1269,50 @@ void tpd::GaussianEngine::rasterFrame(const Camera& camera) {
     _frames[frameIndex].outputImage.recordLayoutTransition(preFrameCompute, eUndefined, eGeneral);
 
     // Splat dispatches these passes: project, prefix
-    if (_pc.count > 0) [[likely]] recordSplat(preFrameCompute);
+    _recordingFrame = frameIndex;
+    if (_pc.count > 0) [[likely]] recordSplat(preFrameCompute, _splatBuffer, _tilesRenderedBuffer, 0);
     preFrameCompute.end();
 
     const auto preprocessInfo = vk::CommandBufferSubmitInfo{ preFrameCompute, 0b1 };
     const auto preprocessSubmitInfo = vk::SubmitInfo2{}.setCommandBufferInfos(preprocessInfo);
     const auto readBackFence = _frames[frameIndex].readBackFence;
-    preFrameQueue.submit2(preprocessSubmitInfo, readBackFence);
+    submit(preFrameQueue, preprocessSubmitInfo, readBackFence);
 
     // Wait until prefix has written _tilesRendered to the host visible buffer
-    [[maybe_unused]] const auto _ = _device.waitForFences(readBackFence, vk::True, limits::max());
+    {
+        TPD_TRACE_ZONE("GaussianEngine::waitReadBackFence");
+        [[maybe_unused]] const auto result = _device.waitForFences(readBackFence, vk::True, limits::max());
+    }
     _device.resetFences(readBackFence);
 
-    // Inspect the number of tiles rendered and reallocate relevant buffers if necessary
+    // Inspect the number of tiles rendered and reallocate relevant buffers if they're too small for this frame,
+    // otherwise decide whether they should grow or shrink the next time this frame index comes around
     vmaInvalidateAllocation(_vmaAllocator, _tilesRenderedBuffer.getAllocation(), 0, vk::WholeSize);
     const auto tilesRendered = _tilesRenderedBuffer.read<uint32_t>();
-    if (tilesRendered > _frames[frameIndex].maxTilesRendered) [[unlikely]] {
-        _frames[frameIndex].maxTilesRendered = tilesRendered;
-        reallocateBuffers(frameIndex);
+    if (tilesRendered > _sortCapacity) [[unlikely]] {
+        _sortBufferStatistics.growCount++;
+        reallocateBuffers(frameIndex, getGrownCapacity(tilesRendered));
     }
+    updateSortCapacity(tilesRendered);
 
-    preFrameCompute.reset();
-    preFrameCompute.begin(vk::CommandBufferBeginInfo{});
+    _frames[frameIndex].tilesRendered = tilesRendered;
+    _frames[frameIndex].statsPending = _collectStats;
 
-    // Re-bind the layout and push the number of tiles rendered
-    preFrameCompute.pushConstants(_gaussianLayout, shaderStage, 0,                  sizeof(PointCloud), &_pc);
-    preFrameCompute.pushConstants(_gaussianLayout, shaderStage, sizeof(PointCloud), sizeof(uint32_t),   &tilesRendered);
-    preFrameCompute.bindDescriptorSets(eCompute, _gaussianLayout, 0, _frames[frameIndex].instance.getDescriptorSets(), {});
+    // The blend commands only get recorded again after something baked into them has changed,
+    // the number of tiles rendered reaches them through the dispatch buffer of this frame
+    updateSortDispatch(frameIndex, tilesRendered);
+    if (!_frames[frameIndex].blendRecorded) [[unlikely]] {
+        recordBlendCommands(frameIndex);
+        _frames[frameIndex].blendRecorded = true;
+    }
 
-    // The remaining passes: keygen, radix, range, blend
-    recordBlend(preFrameCompute, tilesRendered, frameIndex);
+    preFrameCompute.reset();
+    preFrameCompute.begin(vk::CommandBufferBeginInfo{});
+    preFrameCompute.executeCommands(_frames[frameIndex].blend);
 
-    // Transfer ownership to graphics before submitting if working with async compute
-    if (asyncCompute()) {
+    // Transfer ownership to graphics before submitting if working with async compute, unless no draw is going to follow
+    const auto release = asyncCompute() && releaseTarget;
+    if (release) {
         constexpr auto releaseSrcSync = SyncPoint{ vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite };
         _frames[frameIndex].outputImage.recordOwnershipRelease(
             preFrameCompute, _computeFamilyIndex, _graphicsFamilyIndex, releaseSrcSync,
@@ -704,14 +1331,116 @@ void tpd::GaussianEngine::rasterFrame(const Camera& camera) {
         .setSemaphore(_frames[frameIndex].ownership)
         .setStageMask(vk::PipelineStageFlagBits2::eAllCommands)
         .setValue(1).setDeviceIndex(0);
-    // ... only add it if under async compute
-    computeDrawSubmitInfo.signalSemaphoreInfoCount = asyncCompute() ? 1 : 0;
+    // ... only add it if the image is released to graphics
+    computeDrawSubmitInfo.signalSemaphoreInfoCount = release ? 1 : 0;
     computeDrawSubmitInfo.pSignalSemaphoreInfos = &ownershipInfo;
 
-    preFrameQueue.submit2(computeDrawSubmitInfo, preFrameFence);
+    submit(preFrameQueue, computeDrawSubmitInfo, preFrameFence);
 }
 
-void tpd::GaussianEngine::draw(const SwapImage image) const {
+void tpd::GaussianEngine::rasterFrames(const std::span<const Camera* const> cameras) {
+    TPD_TRACE_ZONE("GaussianEngine::rasterFrames");
+    if (cameras.empty()) [[unlikely]] {
+        return;
+    }
+
+    if (cameras.size() > _viewCount) [[unlikely]] {
+        createViews(static_cast<uint32_t>(cameras.size()));
+    }
+
+    // Same queue as the frames in flight, whose blend chains share the sort buffers with those of the views
+    const auto preFrameQueue = asyncCompute() ? _computeQueue : _graphicsQueue;
+
+    // The whole batch is tracked by the command buffer and fences of the first view
+    const auto firstView = _renderer->getInFlightFrameCount();
+    const auto viewCount = static_cast<uint32_t>(cameras.size());
+    const auto& batch = _frames[firstView];
+
+    using limits = std::numeric_limits<uint64_t>;
+    {
+        TPD_TRACE_ZONE("GaussianEngine::waitPreFrameFence");
+        [[maybe_unused]] const auto result = _device.waitForFences(batch.preFrameFence, vk::True, limits::max());
+    }
+    _device.resetFences(batch.preFrameFence);
+
+    _transferWorker->reclaim();
+    applyPendingSortCapacity(firstView);
+
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        updateCameraBuffer(*cameras[view], _viewCameraBuffer, view);
+    }
+
+    const auto cmd = batch.compute;
+    cmd.reset();
+    cmd.begin(vk::CommandBufferBeginInfo{});
+
+    constexpr auto shaderStage = vk::ShaderStageFlagBits::eCompute;
+    cmd.pushConstants(_gaussianLayout, shaderStage, 0, sizeof(PointCloud), &_pc);
+
+    // Projecting a view only waits for the scan of the previous one to clear its counter, so the project pass of
+    // each view overlaps with the prefix pass of the one before it
+    using enum vk::ImageLayout;
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        const auto frameIndex = firstView + view;
+        const auto descriptorSets = _frames[frameIndex].instance.getDescriptorSets();
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, _gaussianLayout, 0, descriptorSets, {});
+        _frames[frameIndex].outputImage.recordLayoutTransition(cmd, eUndefined, eGeneral);
+
+        _recordingFrame = frameIndex;
+        if (_pc.count > 0) [[likely]] {
+            recordSplat(cmd, _viewSplatBuffers[view], _viewTilesRenderedBuffer, sizeof(uint32_t) * view);
+        }
+    }
+    cmd.end();
+
+    const auto preprocessInfo = vk::CommandBufferSubmitInfo{ cmd, 0b1 };
+    submit(preFrameQueue, vk::SubmitInfo2{}.setCommandBufferInfos(preprocessInfo), batch.readBackFence);
+
+    // A single round trip to the host for the tiles rendered of every view
+    {
+        TPD_TRACE_ZONE("GaussianEngine::waitReadBackFence");
+        [[maybe_unused]] const auto result = _device.waitForFences(batch.readBackFence, vk::True, limits::max());
+    }
+    _device.resetFences(batch.readBackFence);
+
+    vmaInvalidateAllocation(_vmaAllocator, _viewTilesRenderedBuffer.getAllocation(), 0, vk::WholeSize);
+    const auto tilesRendered = _viewTilesRenderedBuffer.read<uint32_t>(viewCount);
+
+    // Views are sorted one after another through the same buffers, which only have to fit the largest of them
+    const auto maxTilesRendered = std::ranges::max(tilesRendered);
+    if (maxTilesRendered > _sortCapacity) [[unlikely]] {
+        _sortBufferStatistics.growCount++;
+        reallocateBuffers(firstView, getGrownCapacity(maxTilesRendered));
+    }
+    updateSortCapacity(maxTilesRendered);
+
+    auto blends = std::vector<vk::CommandBuffer>{};
+    blends.reserve(viewCount);
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        const auto frameIndex = firstView + view;
+        _frames[frameIndex].tilesRendered = tilesRendered[view];
+
+        updateSortDispatch(frameIndex, tilesRendered[view]);
+        if (!_frames[frameIndex].blendRecorded) [[unlikely]] {
+            recordBlendCommands(frameIndex);
+            _frames[frameIndex].blendRecorded = true;
+        }
+        blends.push_back(_frames[frameIndex].blend);
+    }
+
+    // The barrier each blend chain starts with orders it after the chain of the previous view
+    cmd.reset();
+    cmd.begin(vk::CommandBufferBeginInfo{});
+    cmd.executeCommands(blends);
+    cmd.end();
+
+    const auto blendInfo = vk::CommandBufferSubmitInfo{ cmd, 0b1 };
+    submit(preFrameQueue, vk::SubmitInfo2{}.setCommandBufferInfos(blendInfo), batch.preFrameFence);
+}
+
+void tpd::GaussianEngine::draw(const SwapImage image) {
+    TPD_TRACE_ZONE("GaussianEngine::draw");
+
     const auto frameIndex = _renderer->getCurrentFrameIndex();
     const auto [imageReady, renderDone, frameDrawFence] = _renderer->getCurrentFrameSync();
 
@@ -755,111 +1484,228 @@ void tpd::GaussianEngine::draw(const SwapImage image) const {
         _frames[frameIndex].outputImage.recordLayoutTransition(graphicsDraw, eGeneral, eTransferSrcOptimal);
     }
 
-    recordTargetCopy(graphicsDraw, image, frameIndex);
+    if (_copyProfiler.valid()) [[unlikely]] {
+        _copyProfiler.recordReset(graphicsDraw, frameIndex);
+        _copyProfiler.recordBegin(graphicsDraw, frameIndex, 0);
+        recordTargetCopy(graphicsDraw, image, frameIndex);
+        _copyProfiler.recordEnd(graphicsDraw, frameIndex, 0);
+    } else {
+        recordTargetCopy(graphicsDraw, image, frameIndex);
+    }
     graphicsDraw.end();
 
-    _graphicsQueue.submit2(submitInfo, frameDrawFence);
+    submit(_graphicsQueue, submitInfo, frameDrawFence);
+}
+
+void tpd::GaussianEngine::renderToHost(const Camera& camera, HostFrameCallback&& callback) {
+    TPD_TRACE_ZONE("GaussianEngine::renderToHost");
+
+    if (_renderer->supportSurfaceRendering()) [[unlikely]] {
+        throw std::runtime_error("GaussianEngine - Rendering to host requires a HeadlessRenderer, draw to a SwapImage instead");
+    }
+    const auto renderer = static_cast<HeadlessRenderer*>(_renderer);
+
+    if (!_readbackWorker) [[unlikely]] {
+        createReadbackWorker();
+    }
+
+    // Wait for the readback of the last frame rendered to this target, delivering it along with any other completed
+    renderer->launchFrame();
+    _readbackWorker->poll();
+
+    // The target stays with the queue it was rendered on, which is where the readback worker copies it from
+    rasterFrame(camera, false);
+
+    const auto frameIndex = renderer->getCurrentFrameIndex();
+    const auto extent = renderer->getFramebufferSize();
+
+    auto region = ReadbackWorker::ImageRegion{};
+    region.image = _frames[frameIndex].outputImage;
+    region.layout = vk::ImageLayout::eGeneral; // as left by the blend pass
+    region.extent = vk::Extent3D{ extent.width, extent.height, 1 };
+    region.texelSize = TARGET_TEXEL_SIZE;
+
+    constexpr auto blendSync = SyncPoint{ PipelineStage::eComputeShader, AccessMask::eShaderStorageWrite };
+    _readbackWorker->enqueue(region, blendSync,
+        [callback = std::move(callback), number = _hostFrameCount++, extent](const std::span<const std::byte> pixels) mutable {
+            callback(HostFrame{ number, extent, pixels });
+        });
+    _readbackWorker->submit({}, renderer->getCurrentFrameSync().frameDrawFence);
+
+    renderer->submitFrame();
+}
+
+void tpd::GaussianEngine::renderToHost(const std::span<const Camera* const> cameras, HostFrameCallback&& callback) {
+    TPD_TRACE_ZONE("GaussianEngine::renderToHost");
+
+    if (_renderer->supportSurfaceRendering()) [[unlikely]] {
+        throw std::runtime_error("GaussianEngine - Rendering to host requires a HeadlessRenderer, draw to a SwapImage instead");
+    }
+    if (cameras.empty()) [[unlikely]] {
+        return;
+    }
+
+    // Views may grow here, which sizes the staging ring of the readback worker for them
+    if (cameras.size() > _viewCount) [[unlikely]] {
+        createViews(static_cast<uint32_t>(cameras.size()));
+    }
+    if (!_readbackWorker) [[unlikely]] {
+        createReadbackWorker();
+    }
+
+    // View targets get overwritten by the next batch, so its readback must have completed by then
+    _readbackWorker->wait(_viewReadbackValue);
+    rasterFrames(cameras);
+
+    const auto extent = _renderer->getFramebufferSize();
+    auto region = ReadbackWorker::ImageRegion{};
+    region.layout = vk::ImageLayout::eGeneral; // as left by the blend pass
+    region.extent = vk::Extent3D{ extent.width, extent.height, 1 };
+    region.texelSize = TARGET_TEXEL_SIZE;
+
+    // Views of the batch are delivered one after another through the same callback
+    auto shared = std::make_shared<HostFrameCallback>(std::move(callback));
+    constexpr auto blendSync = SyncPoint{ PipelineStage::eComputeShader, AccessMask::eShaderStorageWrite };
+    for (uint32_t view = 0; view < cameras.size(); ++view) {
+        region.image = _frames[_renderer->getInFlightFrameCount() + view].outputImage;
+        _readbackWorker->enqueue(region, blendSync,
+            [shared, number = _hostFrameCount++, extent](const std::span<const std::byte> pixels) {
+                (*shared)(HostFrame{ number, extent, pixels });
+            });
+    }
+    _viewReadbackValue = _readbackWorker->submit();
+}
+
+void tpd::GaussianEngine::waitHostFrames() {
+    if (_readbackWorker) {
+        _readbackWorker->waitIdle();
+    }
 }
 
-void tpd::GaussianEngine::updateCameraBuffer(const Camera& camera) const {
+void tpd::GaussianEngine::createReadbackWorker() {
+    // Room for every frame in flight or every view of a batch, whichever is more, plus some slack for alignment. Copies
+    // run on the queue rasterFrame submits to: the compute queue under async compute, the graphics one otherwise,
+    // which then belongs to the same family.
+    const auto [w, h] = _renderer->getFramebufferSize();
+    const auto frameSize = vk::DeviceSize{ w } * h * TARGET_TEXEL_SIZE + 64;
+    const auto frameCount = std::max(_renderer->getInFlightFrameCount(), _viewCount);
+    _readbackWorker = std::make_unique<ReadbackWorker>(
+        _computeFamilyIndex, _device, _vmaAllocator, frameSize * frameCount, _queueArbiter);
+    _viewReadbackValue = 0;
+    PLOGD << "GaussianEngine - Created a readback worker for " << frameCount << " offscreen frames in flight";
+}
+
+void tpd::GaussianEngine::updateCameraBuffer(const Camera& camera, const RingBuffer& buffer, const uint32_t bufferIndex) const {
     auto projection = mat4{ camera.getProjectionData() };
     const auto fx = projection[0, 0];
     const auto fy = projection[1, 1];
     projection = math::mul(projection, camera.getViewMatrix());
     const auto focalNDC = std::array{ fx, fy };
 
-    _cameraBuffer.update(0, camera.getViewMatrixData(), sizeof(mat4));
-    _cameraBuffer.update(0, projection.data_ptr(), sizeof(mat4), sizeof(mat4));
-    _cameraBuffer.update(0, focalNDC.data(), sizeof(focalNDC), sizeof(mat4) * 2);
-    vmaFlushAllocation(_vmaAllocator, _cameraBuffer.getAllocation(), 0, vk::WholeSize);
+    buffer.update(bufferIndex, camera.getViewMatrixData(), sizeof(mat4));
+    buffer.update(bufferIndex, projection.data_ptr(), sizeof(mat4), sizeof(mat4));
+    buffer.update(bufferIndex, focalNDC.data(), sizeof(focalNDC), sizeof(mat4) * 2);
+    vmaFlushAllocation(_vmaAllocator, buffer.getAllocation(), buffer.getOffset(bufferIndex), CAMERA_SIZE);
 }
 
-void tpd::GaussianEngine::recordSplat(const vk::CommandBuffer cmd) const noexcept {
+void tpd::GaussianEngine::recordSplat(
+    const vk::CommandBuffer cmd,
+    const vk::Buffer splats,
+    const vk::Buffer tilesRendered,
+    const vk::DeviceSize tilesRenderedOffset) const noexcept
+{
     // Project pass
+    recordPassBegin(cmd, Pass::Project);
     cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _projectPipeline);
-    cmd.dispatch((_pc.count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
-
-    // Make sure splat contents written by project pass are visible (read),
-    // and we're going to modify the tiles members in this buffer (write).
-    // Global memory barrier covers all resources, generally considered 
-    // more efficient to do a global memory barrier than per-resource barriers
-    cmd.pipelineBarrier2(WAW_DEPENDENCY);
-
-    // Prefix pass
-    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _prefixPipeline);
-    cmd.dispatch((_pc.count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    cmd.dispatch((_pc.count + _tuning.workgroupSize - 1) / _tuning.workgroupSize, 1, 1);
+    recordPassEnd(cmd, Pass::Project);
+
+    // Prefix pass: scan the tiles touched by each splat in place and write their total for CPU readback. The global
+    // barriers the scan clears its counter behind also make splat contents written by the project pass visible.
+    const auto splatSize = _halfPrecisionSplats ? PACKED_SPLAT_SIZE : SPLAT_SIZE;
+    const auto scanInput = GpuPrefixScan::Input{
+        splats, SPLAT_TILES_OFFSET, _pc.count, static_cast<uint32_t>(splatSize / sizeof(uint32_t)),
+        _scanScratchBuffer, tilesRendered, tilesRenderedOffset };
+
+    recordPassBegin(cmd, Pass::Prefix);
+    _tileScan.record(cmd, scanInput);
+    recordPassEnd(cmd, Pass::Prefix);
 }
 
-void tpd::GaussianEngine::reallocateBuffers(const uint32_t frameIndex) {
-    const auto newTilesRendered = _frames[frameIndex].maxTilesRendered;
-    PLOGD << "GaussianEngine - Frame " << frameIndex << " reallocating with new tiles rendered: " << newTilesRendered;
-
-    createSplatKeyBuffers(frameIndex);
-    createSplatIndexBuffers(frameIndex);
-    createGlobalPrefixBuffers(frameIndex);
-    createTempKeyBuffers(frameIndex);
-    createTempValBuffers(frameIndex);
-    createBlockDescriptorBuffers(frameIndex);
-    PLOGD << "GaussianEngine - Frame " << frameIndex << " done reallocation";
+void tpd::GaussianEngine::applyPendingSortCapacity(const uint32_t frameIndex) {
+    // Apply capacity changes decided by previous frames before this frame reaches its critical path
+    if (_pendingSortCapacity != _sortCapacity) [[unlikely]] {
+        if (_pendingSortCapacity > _sortCapacity) _sortBufferStatistics.deferredGrowCount++;
+        else _sortBufferStatistics.shrinkCount++;
+        reallocateBuffers(frameIndex, _pendingSortCapacity);
+    }
 }
 
-void tpd::GaussianEngine::recordBlend(
-    const vk::CommandBuffer cmd,
-    const uint32_t tilesRendered,
-    const uint32_t frameIndex) const noexcept 
-{
-    // Make sure prefix sums computed by prefix pass are visible
-    cmd.pipelineBarrier2(RAW_DEPENDENCY);
-
-    // Keygen pass: we could put this in recordSplat and ignore the _pc.count check, but that would cause
-    // glitching when new tiles rendered change because keygen pass writes to key and index buffers
-    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _keygenPipeline);
-    if (_pc.count > 0) [[likely]] cmd.dispatch((_pc.count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+void tpd::GaussianEngine::reallocateBuffers(const uint32_t frameIndex, const uint32_t capacity) {
+    PLOGD << "GaussianEngine - Frame " << frameIndex << " reallocating sort buffers: " << _sortCapacity << " -> " << capacity;
 
-    // Radix sort passes
-    const auto blockCount = (tilesRendered + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
-    using enum vk::ShaderStageFlagBits;
-    for (auto radixPass = 0; radixPass < _radixPassCount; ++radixPass) {
-        cmd.pushConstants(_gaussianLayout, eCompute, sizeof(PointCloud) + sizeof(uint32_t), sizeof(uint32_t), &radixPass);
+    // Sort buffers are shared, so other in-flight frames must be done with them before they can be destroyed and
+    // their descriptors rewritten. The fence of this frame has been reset and must not be waited on.
+    auto otherFences = std::vector<vk::Fence>{};
+    for (uint32_t i = 0; i < _frames.size(); ++i) {
+        if (i != frameIndex) otherFences.push_back(_frames[i].preFrameFence);
+    }
+    if (!otherFences.empty()) {
+        using limits = std::numeric_limits<uint64_t>;
+        [[maybe_unused]] const auto result = _device.waitForFences(otherFences, vk::True, limits::max());
+    }
 
-        // Local shuffling
-        cmd.pipelineBarrier2(RAW_DEPENDENCY);
-        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _radixShufflePipeline);
-        cmd.dispatch(blockCount, 1, 1);
+    _sortCapacity = capacity;
+    _pendingSortCapacity = capacity;
+    _lowUsageFrames = 0;
 
-        // These two radix passes are going to read and write to the same buffer set
-        cmd.pipelineBarrier2(WAW_DEPENDENCY);
-        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _radixPrefixAPipeline);
-        cmd.dispatch((blockCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
-        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _radixPrefixBPipeline);
-        cmd.dispatch((blockCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    createBlendGraph();
+    PLOGD << "GaussianEngine - Frame " << frameIndex << " done reallocation ("
+          << _blendGraph.getStatistics().transientBytes / 1048576 << "MB)";
+}
 
-        // Coalesced mapping
-        cmd.pipelineBarrier2(RAW_DEPENDENCY);
-        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _radixMappingPipeline);
-        cmd.dispatch(blockCount, 1, 1);
+void tpd::GaussianEngine::updateSortCapacity(const uint32_t tilesRendered) {
+    // Close to running out: grow ahead of time rather than stalling a later frame between readback and submission
+    if (tilesRendered > _sortCapacity / 8 * 7) {
+        _pendingSortCapacity = std::max(_sortCapacity, getGrownCapacity(tilesRendered));
+        _lowUsageFrames = 0;
+        return;
     }
 
-    // Clear the range buffer before populating it
-    cmd.fillBuffer(_frames[frameIndex].rangeBuffer, 0, vk::WholeSize, 0);
-
-    // Make sure sorted keys written by radix pass are visible and
-    // transfer has finished clearing the range buffer
-    cmd.pipelineBarrier2(WAT_DEPENDENCY);
-
-    // Range pass
-    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _rangePipeline);
-    cmd.dispatch(blockCount, 1, 1);
+    // Only give memory back after a sustained period of low usage, so that a camera going
+    // back and forth around a close-up does not keep reallocating
+    if (tilesRendered < _sortCapacity / 4) {
+        if (++_lowUsageFrames >= SORT_SHRINK_DELAY_FRAMES) {
+            _pendingSortCapacity = getGrownCapacity(tilesRendered);
+        }
+    } else {
+        _lowUsageFrames = 0;
+    }
+}
 
-    // Make sure range values written by range pass are visible to blend pass
-    cmd.pipelineBarrier2(RAW_DEPENDENCY);
+tpd::GaussianEngine::SortBufferStatistics tpd::GaussianEngine::getSortBufferStatistics() const noexcept {
+    auto stats = _sortBufferStatistics;
+    stats.capacity = _sortCapacity;
+    stats.bytes = _blendGraph.getStatistics().transientBytes;
+    return stats;
+}
 
-    // Alpha blending pass
+void tpd::GaussianEngine::recordWorkloadCopy(
+    const vk::CommandBuffer cmd,
+    const vk::Buffer rangeBuffer,
+    const uint32_t frameIndex) const noexcept
+{
+    // Both buffers are sized after the current image dimensions, see createBlendGraph and createWorkloadBuffers
     const auto [w, h] = _renderer->getFramebufferSize();
-    const auto tilesX = (w + BLOCK_X - 1) / BLOCK_X;
-    const auto tilesY = (h + BLOCK_Y - 1) / BLOCK_Y;
-    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, _blendPipeline);
-    cmd.dispatch(tilesX, tilesY, 1);
+    const auto size = sizeof(uvec2) * ((w + _tuning.blockX - 1) / _tuning.blockX) * ((h + _tuning.blockY - 1) / _tuning.blockY);
+    cmd.copyBuffer(rangeBuffer, _workloadBuffers[frameIndex], vk::BufferCopy{ 0, 0, size });
+
+    // Counters and ranges are read on the host once the pre-frame fence signals
+    constexpr auto hostBarrier = vk::MemoryBarrier2{
+        PipelineStage::eComputeShader | PipelineStage::eTransfer, AccessMask::eShaderStorageWrite | AccessMask::eTransferWrite,
+        PipelineStage::eHost,                                     AccessMask::eHostRead,
+    };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ {}, 1, &hostBarrier });
 }
 
 void tpd::GaussianEngine::recordTargetCopy(
@@ -876,38 +1722,32 @@ void tpd::GaussianEngine::recordTargetCopy(
 
 void tpd::GaussianEngine::destroy() noexcept {
     if (_initialized) {
-        std::ranges::for_each(_globalSumBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_blockDescriptorBBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_blockDescriptorABuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_blockCountBBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_blockCountABuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_globalPrefixBBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_globalPrefixABuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_tempValBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_tempKeyBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_splatIndexBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_splatKeyBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
-        std::ranges::for_each(_frames, [this](Frame& f) { f.rangeBuffer.destroy(_vmaAllocator); });
-
-        _globalSumBuffers.clear();
-        _blockDescriptorBBuffers.clear();
-        _blockDescriptorABuffers.clear();
-        _blockCountBBuffers.clear();
-        _blockCountABuffers.clear();
-        _globalPrefixBBuffers.clear();
-        _globalPrefixABuffers.clear();
-        _tempValBuffers.clear();
-        _tempKeyBuffers.clear();
-        _splatIndexBuffers.clear();
-        _splatKeyBuffers.clear();
+        // Frames still in flight are delivered before their targets go away
+        if (_readbackWorker) {
+            _readbackWorker->destroy();
+            _readbackWorker.reset();
+        }
+
+        _blendGraph.destroy(_device, _vmaAllocator);
+        std::ranges::for_each(_sortDispatchBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
+        std::ranges::for_each(_statsBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
+        destroyWorkloadBuffers();
+
+        _sortDispatchBuffers.clear();
+        _workloadBuffers.clear();
+        _statsBuffers.clear();
 
         _bindlessTransformBuffer.destroy(_vmaAllocator);
         _transformIndexBuffer.destroy(_vmaAllocator);
         _transformHandleBuffer.destroy(_vmaAllocator);
 
-        _partitionDescriptorBuffer.destroy(_vmaAllocator);
-        _partitionCountBuffer.destroy(_vmaAllocator);
+        _scanScratchBuffer.destroy(_vmaAllocator);
         _tilesRenderedBuffer.destroy(_vmaAllocator);
+        std::ranges::for_each(_viewSplatBuffers, [this](auto& b) { b.destroy(_vmaAllocator); });
+        _viewSplatBuffers.clear();
+        _viewTilesRenderedBuffer.destroy(_vmaAllocator);
+        _viewCameraBuffer.destroy(_vmaAllocator);
+        _viewCount = 0;
         _splatBuffer.destroy(_vmaAllocator);
         _gaussianBuffer.destroy(_vmaAllocator);
         _cameraBuffer.destroy(_vmaAllocator);
@@ -924,15 +1764,14 @@ void tpd::GaussianEngine::destroy() noexcept {
         _targetViews.clear();
         _frames.clear();
 
-        _device.destroyPipeline(_blendPipeline);
         _device.destroyPipeline(_rangePipeline);
-        _device.destroyPipeline(_radixMappingPipeline);
-        _device.destroyPipeline(_radixPrefixBPipeline);
-        _device.destroyPipeline(_radixPrefixAPipeline);
-        _device.destroyPipeline(_radixShufflePipeline);
-        _device.destroyPipeline(_keygenPipeline);
-        _device.destroyPipeline(_prefixPipeline);
-        _device.destroyPipeline(_projectPipeline);
+        _keySort.destroy();
+        _tileScan.destroy();
+        destroySplatPipelines();
+        if (!_sharedDevice) {
+            _device.destroyPipelineCache(_pipelineCache); // otherwise owned by the shared device
+        }
+        destroyProfilers();
 
         _shaderLayout.destroy(_device);
         _device.destroyPipelineLayout(_gaussianLayout);
@@ -0,0 +1,57 @@
+#include "torpedo/volumetric/KernelTuning.h"
+
+#include <format>
+#include <fstream>
+
+bool tpd::KernelTuning::supported(const vk::PhysicalDeviceLimits& limits) const noexcept {
+    const auto blockSize = blockX * blockY;
+    return workgroupSize > 0 && itemsPerThread > 0 && workgroupSize % itemsPerThread == 0
+        && workgroupSize <= limits.maxComputeWorkGroupSize[0]
+        && workgroupSize <= limits.maxComputeWorkGroupInvocations
+        && blockSize > 0 && blockSize <= MAX_BLOCK_SIZE
+        && blockX <= limits.maxComputeWorkGroupSize[0]
+        && blockY <= limits.maxComputeWorkGroupSize[1]
+        && blockSize <= limits.maxComputeWorkGroupInvocations;
+}
+
+std::filesystem::path tpd::utils::getKernelTuningFile(const std::filesystem::path& directory, const vk::PhysicalDevice physicalDevice) {
+    auto idProperties = vk::PhysicalDeviceIDProperties{};
+    auto properties = vk::PhysicalDeviceProperties2{};
+    properties.pNext = &idProperties;
+    physicalDevice.getProperties2(&properties);
+
+    auto uuid = std::string{};
+    for (const auto byte : idProperties.deviceUUID) {
+        uuid += std::format("{:02x}", byte);
+    }
+    return directory / std::format("{}.txt", uuid);
+}
+
+std::optional<tpd::KernelTuning> tpd::utils::loadKernelTuning(const std::filesystem::path& directory, const vk::PhysicalDevice physicalDevice) {
+    auto stream = std::ifstream{ getKernelTuningFile(directory, physicalDevice) };
+    if (!stream.is_open()) {
+        return std::nullopt;
+    }
+
+    // A single line of values in the order they are declared, see saveKernelTuning
+    auto tuning = KernelTuning{};
+    if (!(stream >> tuning.workgroupSize >> tuning.itemsPerThread >> tuning.blockX >> tuning.blockY)) {
+        return std::nullopt;
+    }
+    return tuning;
+}
+
+bool tpd::utils::saveKernelTuning(const KernelTuning& tuning, const std::filesystem::path& directory, const vk::PhysicalDevice physicalDevice) {
+    auto error = std::error_code{};
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return false;
+    }
+
+    auto stream = std::ofstream{ getKernelTuningFile(directory, physicalDevice), std::ios::trunc };
+    if (!stream.is_open()) {
+        return false;
+    }
+    stream << tuning.workgroupSize << ' ' << tuning.itemsPerThread << ' ' << tuning.blockX << ' ' << tuning.blockY << '\n';
+    return static_cast<bool>(stream);
+}
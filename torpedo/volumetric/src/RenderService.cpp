@@ -0,0 +1,189 @@
+#include "torpedo/volumetric/RenderService.h"
+
+#include <torpedo/foundation/FrameTracer.h>
+
+#include <plog/Log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+tpd::RenderService::CameraSnapshot::CameraSnapshot(const Camera& camera)
+    : Camera{ camera.getViewMatrix() }
+    , _projectionByteSize{ camera.getProjectionByteSize() }
+{
+    if (_projectionByteSize > sizeof(_projection)) [[unlikely]] {
+        throw std::invalid_argument("RenderService - Camera projection is larger than a 4x4 matrix");
+    }
+    std::memcpy(_projection.data(), camera.getProjectionData(), _projectionByteSize);
+}
+
+tpd::RenderService::RenderService(GaussianEngine* engine, const Settings& settings)
+    : _engine{ engine }
+    , _settings{ settings }
+{
+    if (_settings.maxBatchSize == 0) [[unlikely]] {
+        throw std::invalid_argument("RenderService - Batches must hold at least one request");
+    }
+    _renderThread = std::thread{ &RenderService::run, this };
+}
+
+void tpd::RenderService::render(const Camera& camera, Callback&& callback) {
+    // Counted before the push, so that the render thread knows a request is on its way when the queue looks empty.
+    // Counting before checking for a stop pairs with popRequest, which checks for a stop before reading the count:
+    // either the request is turned down here, or the render thread sees it coming and waits for it before exiting.
+    _queueDepth.fetch_add(1, std::memory_order_seq_cst);
+    if (_stopping.load(std::memory_order_seq_cst)) [[unlikely]] {
+        _queueDepth.fetch_sub(1, std::memory_order_relaxed);
+        throw std::runtime_error("RenderService - Cannot accept a request after the service has stopped");
+    }
+
+    _requestCount.fetch_add(1, std::memory_order_relaxed);
+    _requests.push({ CameraSnapshot{ camera }, std::move(callback), Clock::now() });
+    _pending.release();
+}
+
+void tpd::RenderService::run() {
+    auto batch = std::vector<Request>{};
+    batch.reserve(_settings.maxBatchSize);
+
+    auto stopped = false;
+    while (!stopped) {
+        // The first request opens the batch and starts its window
+        _pending.acquire();
+        auto request = popRequest();
+        if (!request) {
+            break;
+        }
+        const auto deadline = request->time + _settings.batchWindow;
+        batch.push_back(std::move(*request));
+
+        // Requests that arrived while the previous batch was rendering join right away, without waiting
+        while (batch.size() < _settings.maxBatchSize && _pending.try_acquire_until(deadline)) {
+            request = popRequest();
+            if (!request) {
+                stopped = true;
+                break;
+            }
+            batch.push_back(std::move(*request));
+        }
+
+        // Exceptions must not escape the render thread. Whatever the engine throws fails this batch, whose callbacks
+        // are dropped along with the engine's copy of them, and the next batch is served as usual.
+        try {
+            renderBatch(batch);
+
+            // Frames are otherwise delivered by the next renderToHost, an idle service must not hold on to them
+            if (_queueDepth.load(std::memory_order_relaxed) == 0) {
+                _engine->waitHostFrames();
+            }
+        } catch (const std::exception& e) {
+            _failedCount.fetch_add(batch.size(), std::memory_order_relaxed);
+            PLOGE << "RenderService - Failed to render a batch of " << batch.size() << " requests: " << e.what();
+        }
+        batch.clear();
+    }
+
+    try {
+        _engine->waitHostFrames();
+    } catch (const std::exception& e) {
+        PLOGE << "RenderService - Failed to deliver the last frames: " << e.what();
+    }
+}
+
+std::optional<tpd::RenderService::Request> tpd::RenderService::popRequest() {
+    // A request whose push is still in progress is not visible yet, though its count already is
+    auto request = _requests.pop();
+    while (!request) {
+        if (_stopping.load(std::memory_order_seq_cst) && _queueDepth.load(std::memory_order_seq_cst) == 0) {
+            return std::nullopt;
+        }
+        std::this_thread::yield();
+        request = _requests.pop();
+    }
+    _queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    return request;
+}
+
+void tpd::RenderService::renderBatch(std::vector<Request>& batch) {
+    TPD_TRACE_ZONE("RenderService::renderBatch");
+
+    auto cameras = std::vector<const Camera*>{};
+    auto callbacks = std::vector<Callback>{};
+    auto times = std::vector<Clock::time_point>{};
+    for (auto& [camera, callback, time] : batch) {
+        cameras.push_back(&camera);
+        callbacks.push_back(std::move(callback));
+        times.push_back(time);
+    }
+
+    _batchCount.fetch_add(1, std::memory_order_relaxed);
+    _batchedRequestCount.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    // Frames of a batch are delivered in the order of its cameras
+    _engine->renderToHost(cameras, [this, callbacks = std::move(callbacks), times = std::move(times), view = 0uz](
+        const GaussianEngine::HostFrame& frame) mutable
+    {
+        recordLatency(Clock::now() - times[view]);
+        callbacks[view++](frame);
+        _deliveredCount.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+void tpd::RenderService::recordLatency(const Clock::duration latency) {
+    using Millis = std::chrono::duration<float, std::milli>;
+    const auto guard = std::lock_guard{ _latencyMutex };
+    _latencyHistory[_latencyCursor] = Millis{ latency }.count();
+    _latencyCursor = (_latencyCursor + 1) % LATENCY_HISTORY_SIZE;
+    _latencySampleCount = std::min(_latencySampleCount + 1, LATENCY_HISTORY_SIZE);
+}
+
+tpd::RenderService::Metrics tpd::RenderService::getMetrics() const {
+    auto metrics = Metrics{};
+    metrics.queueDepth = _queueDepth.load(std::memory_order_relaxed);
+    metrics.requestCount = _requestCount.load(std::memory_order_relaxed);
+    metrics.deliveredCount = _deliveredCount.load(std::memory_order_relaxed);
+    metrics.failedCount = _failedCount.load(std::memory_order_relaxed);
+    metrics.batchCount = _batchCount.load(std::memory_order_relaxed);
+    if (metrics.batchCount > 0) {
+        const auto batchedRequestCount = _batchedRequestCount.load(std::memory_order_relaxed);
+        metrics.meanBatchSize = static_cast<float>(batchedRequestCount) / static_cast<float>(metrics.batchCount);
+    }
+
+    auto samples = std::vector<float>{};
+    {
+        const auto guard = std::lock_guard{ _latencyMutex };
+        samples.assign(_latencyHistory.begin(), _latencyHistory.begin() + _latencySampleCount);
+    }
+    if (samples.empty()) {
+        return metrics;
+    }
+
+    // The history is not yet full until the sample count reaches its size, in which case valid samples start at 0
+    std::ranges::sort(samples);
+    const auto percentile = [&samples](const float p) {
+        return samples[static_cast<std::size_t>(p * static_cast<float>(samples.size() - 1) + 0.5f)];
+    };
+
+    metrics.latencyAverage = std::accumulate(samples.begin(), samples.end(), 0.0f) / static_cast<float>(samples.size());
+    metrics.latencyP50 = percentile(0.50f);
+    metrics.latencyP95 = percentile(0.95f);
+    metrics.latencyP99 = percentile(0.99f);
+    return metrics;
+}
+
+void tpd::RenderService::stop() {
+    if (_stopping.exchange(true, std::memory_order_seq_cst)) {
+        return;
+    }
+
+    // Wakes the render thread up, with nothing to pop once every request has been taken
+    _pending.release();
+    _renderThread.join();
+    PLOGD << "RenderService - Stopped after " << _deliveredCount.load() << " requests in " << _batchCount.load() << " batches, "
+          << _failedCount.load() << " requests failed";
+}
+
+tpd::RenderService::~RenderService() noexcept {
+    stop();
+}
@@ -0,0 +1,99 @@
+#include <torpedo/volumetric/CpuRasterizer.h>
+
+#include <torpedo/extension/PerspectiveCamera.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Renders a seeded random scene with the SIMD blending kernel and with the scalar one, which serves as its reference.
+// Both evaluate the same math in a different order, so no channel of any pixel may differ by more than one unorm step.
+
+namespace {
+    constexpr uint32_t WIDTH = 640;
+    constexpr uint32_t HEIGHT = 480;
+    constexpr uint32_t POINT_COUNT = 200'000;
+
+    std::vector<tpd::GaussianPoint> generateScene(const uint32_t count, const uint64_t seed) {
+        auto rng = std::mt19937_64{ seed };
+        auto uniform = [&rng](const float min, const float max) { return std::uniform_real_distribution{ min, max }(rng); };
+
+        auto points = std::vector<tpd::GaussianPoint>(count);
+        for (auto& [position, opacity, quaternion, scale, sh] : points) {
+            position = tpd::vec3{ uniform(-2.0f, 2.0f), uniform(-2.0f, 2.0f), uniform(-2.0f, 2.0f) };
+            opacity = uniform(0.05f, 1.0f);
+
+            const auto q = tpd::vec4{ uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f) };
+            const auto length = std::max(std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w), 1e-3f);
+            quaternion = tpd::vec4{ q.x / length, q.y / length, q.z / length, q.w / length };
+            scale = tpd::vec4{ uniform(0.002f, 0.03f), uniform(0.002f, 0.03f), uniform(0.002f, 0.03f), 1.0f };
+
+            // View-dependent colors up to the third degree
+            sh = tpd::utils::rgb2sh(uniform(0.0f, 1.0f), uniform(0.0f, 1.0f), uniform(0.0f, 1.0f));
+            std::ranges::generate(sh | std::views::drop(3), [&uniform] { return uniform(-0.2f, 0.2f); });
+        }
+        return points;
+    }
+
+    bool checkFrames(const tpd::CpuRasterizer::Frame& simd, const tpd::CpuRasterizer::Frame& scalar) {
+        if (simd.statistics.visibleGaussians != scalar.statistics.visibleGaussians
+            || simd.statistics.tilesRendered != scalar.statistics.tilesRendered) {
+            std::cerr << "  projection and binning differ, they do not depend on the blending kernel\n";
+            return false;
+        }
+
+        auto maxDifference = 0;
+        auto differentCount = 0u;
+        for (std::size_t i = 0; i < simd.pixels.size(); ++i) {
+            const auto difference = std::abs(std::to_integer<int>(simd.pixels[i]) - std::to_integer<int>(scalar.pixels[i]));
+            maxDifference = std::max(maxDifference, difference);
+            differentCount += difference > 0 ? 1 : 0;
+        }
+
+        std::cout << "  " << differentCount << " of " << simd.pixels.size() << " channels differ, by "
+            << maxDifference << " unorm step(s) at most\n";
+        return maxDifference <= 1;
+    }
+} // namespace
+
+int main() {
+    const auto points = generateScene(POINT_COUNT, 2024);
+
+    auto simdSettings = tpd::CpuRasterizer::Settings::getDefault();
+    auto scalarSettings = simdSettings;
+    scalarSettings.simdKernels = false;
+
+    auto simd = tpd::CpuRasterizer{ simdSettings };
+    auto scalar = tpd::CpuRasterizer{ scalarSettings };
+    if (std::string{ simd.getKernelName() } == "scalar") {
+        std::cout << "No SIMD kernel on this platform, comparing the scalar kernel with itself\n";
+    }
+
+    // Close enough for splats to cover several tiles, and from the side so that higher SH bands change the colors
+    const auto poses = std::vector<std::pair<tpd::vec3, std::string>>{
+        { tpd::vec3{ 0.0f, 0.0f, 4.0f }, "front" },
+        { tpd::vec3{ 3.0f, 1.5f, 2.0f }, "side" },
+    };
+
+    auto failedCount = 0u;
+    for (const auto& [eye, name] : poses) {
+        auto camera = tpd::PerspectiveCamera{ WIDTH, HEIGHT };
+        camera.lookAt(eye, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+        const auto simdFrame = simd.render(points, camera, WIDTH, HEIGHT);
+        const auto scalarFrame = scalar.render(points, camera, WIDTH, HEIGHT);
+
+        const auto passed = checkFrames(simdFrame, scalarFrame);
+        std::cout << (passed ? "[PASS] " : "[FAIL] ") << simd.getKernelName() << " against scalar, " << name << " view\n";
+        failedCount += passed ? 0 : 1;
+    }
+
+    std::cout << (failedCount == 0 ? "All checks passed" : std::to_string(failedCount) + " check(s) failed") << '\n';
+    return failedCount == 0 ? 0 : 1;
+}
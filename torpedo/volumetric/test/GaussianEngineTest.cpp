@@ -0,0 +1,115 @@
+#include <torpedo/rendering/Context.h>
+#include <torpedo/rendering/HeadlessRenderer.h>
+#include <torpedo/rendering/Scene.h>
+
+#include <torpedo/volumetric/GaussianEngine.h>
+#include <torpedo/volumetric/GaussianGeometry.h>
+
+#include <torpedo/extension/PerspectiveCamera.h>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Renders single frames, then a batch of views which grows the frames of the engine, then single frames again on every
+// frame in flight. Frames whose blend commands were recorded before the batch must not replay them, and every view of
+// the same camera must come out identical to the first frame.
+
+namespace {
+    constexpr int SKIP_CODE = 77; // must match SKIP_RETURN_CODE in CMakeLists.txt
+
+    constexpr uint32_t WIDTH = 256;
+    constexpr uint32_t HEIGHT = 192;
+
+    using Pixels = std::vector<std::byte>;
+
+    bool checkFrame(const std::string& name, const Pixels& pixels, const Pixels& reference) {
+        if (pixels == reference) {
+            std::cout << "[PASS] " << name << '\n';
+            return true;
+        }
+        std::cout << "[FAIL] " << name << ": pixels differ from the first frame\n";
+        return false;
+    }
+} // namespace
+
+int main() {
+    auto context = std::unique_ptr<tpd::Context<tpd::HeadlessRenderer>>{};
+    auto engine = std::unique_ptr<tpd::GaussianEngine, tpd::Deleter<tpd::GaussianEngine>>{};
+    try {
+        context = tpd::Context<tpd::HeadlessRenderer>::create();
+        static_cast<void>(context->initRenderer(WIDTH, HEIGHT));
+        engine = context->bindEngine<tpd::GaussianEngine>();
+    } catch (const std::exception& e) {
+        std::cout << "No suitable device to render on, skipping: " << e.what() << '\n';
+        return SKIP_CODE;
+    }
+
+    auto failedCount = 0u;
+    try {
+        const auto camera = context->createCamera<tpd::PerspectiveCamera>();
+        camera->lookAt({ 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+        const auto side = context->createCamera<tpd::PerspectiveCamera>();
+        side->lookAt({ 5.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+        auto scene = tpd::Scene{};
+        scene.add(tpd::ent::group(tpd::GaussianPoint::random(4000, 1.5f, { 0.0f, 0.0f, 0.0f }, 0.01f, 0.08f)));
+
+        // Statistics make the blend commands copy tile workloads, whose buffers the batch recreates
+        auto settings = tpd::GaussianEngine::Settings::getDefault();
+        settings.frameStatistics = true;
+        engine->compile(scene, settings);
+
+        // Every frame in flight records and caches its blend commands against the targets of a single view
+        constexpr auto inFlight = tpd::HeadlessRenderer::IN_FLIGHT_FRAME_COUNT;
+        auto reference = Pixels{};
+        auto before = std::vector<Pixels>{};
+        for (uint32_t i = 0; i < inFlight; ++i) {
+            engine->renderToHost(*camera, [&](const tpd::GaussianEngine::HostFrame& frame) {
+                (frame.number == 0 ? reference : before.emplace_back()).assign(frame.pixels.begin(), frame.pixels.end());
+            });
+        }
+        engine->waitHostFrames();
+        if (reference.size() != WIDTH * HEIGHT * 4) {
+            std::cout << "[FAIL] first frame: " << reference.size() << " bytes read back\n";
+            return 1;
+        }
+        for (uint32_t i = 0; i < before.size(); ++i) {
+            failedCount += checkFrame("frame " + std::to_string(i + 1) + " before the batch", before[i], reference) ? 0 : 1;
+        }
+
+        // The first batch grows the views, rebuilding the targets and workload buffers of every frame
+        const auto views = std::array<const tpd::Camera*, 3>{ camera.get(), side.get(), camera.get() };
+        auto batch = std::vector<Pixels>{};
+        engine->renderToHost(views, [&batch](const tpd::GaussianEngine::HostFrame& frame) {
+            batch.emplace_back(frame.pixels.begin(), frame.pixels.end());
+        });
+        engine->waitHostFrames();
+        if (batch.size() != views.size()) {
+            std::cout << "[FAIL] batch: " << batch.size() << " of " << views.size() << " views delivered\n";
+            return 1;
+        }
+        failedCount += checkFrame("batch view 0", batch[0], reference) ? 0 : 1;
+        failedCount += checkFrame("batch view 2", batch[2], reference) ? 0 : 1;
+
+        // Going around every frame in flight twice, the first time around replays nothing recorded before the batch
+        auto after = std::vector<Pixels>{};
+        for (uint32_t i = 0; i < 2 * inFlight; ++i) {
+            engine->renderToHost(*camera, [&after](const tpd::GaussianEngine::HostFrame& frame) {
+                after.emplace_back(frame.pixels.begin(), frame.pixels.end());
+            });
+        }
+        engine->waitHostFrames();
+        for (uint32_t i = 0; i < after.size(); ++i) {
+            failedCount += checkFrame("frame " + std::to_string(i) + " after the batch", after[i], reference) ? 0 : 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Aborted: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::cout << (failedCount == 0 ? "All checks passed" : std::to_string(failedCount) + " check(s) failed") << '\n';
+    return failedCount == 0 ? 0 : 1;
+}